@@ -0,0 +1,44 @@
+// arcadefb.cpp
+#include "arcadefb.h"
+
+#include <xtl.h>
+
+#include "batch.h"
+#include "rtarget.h"
+
+static const int SCREEN_W = 640;
+static const int SCREEN_H = 480;
+
+static RenderTarget s_target = { NULL, NULL, 0, 0 };
+static bool s_active = false;
+
+bool ArcadeFB_Init()
+{
+    ArcadeFB_Shutdown();
+    return RT_Create(s_target, ARCADEFB_W, ARCADEFB_H, D3DFMT_LIN_X8R8G8B8);
+}
+
+void ArcadeFB_Shutdown()
+{
+    RT_Release(s_target);
+}
+
+bool ArcadeFB_Begin()
+{
+    s_active = RT_Begin(s_target, D3DCOLOR_XRGB(0, 0, 0), (float)ARCADEFB_W / (float)SCREEN_W);
+    return s_active;
+}
+
+void ArcadeFB_End()
+{
+    if (!s_active) return;
+    s_active = false;
+
+    RT_End();
+
+    // One 2x quad; X8 texels read back with alpha 1, so the blend is a copy
+    Batch_PushQuadUV(s_target.tex,
+                     0.0f, 0.0f, (float)SCREEN_W, (float)SCREEN_H,
+                     0.0f, 0.0f, (float)ARCADEFB_W, (float)ARCADEFB_H,
+                     D3DCOLOR_ARGB(255, 255, 255, 255));
+}
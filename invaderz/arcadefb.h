@@ -0,0 +1,34 @@
+#pragma once
+#include <xtl.h>
+
+// -----------------------------------------------------------------------------
+// Arcade-resolution framebuffer.
+//
+// A 320x240 render target the game is drawn into at 1x, then put on the
+// 640x480 back buffer with a single point-sampled 2x quad. Game code keeps its
+// 640x480 coordinates: between Begin and End the batch runs at view scale 0.5
+// (see Batch_SetViewScale), so a SPR_SCALE 2 sprite pixel or a scale 2 glyph
+// pixel lands on exactly one target pixel. HUD and text go through the same
+// batch and end up in the target too; other text scales are rounded to whole
+// target pixels (Font_SnapScale).
+//
+// Usage (inside BeginScene/EndScene):
+//   if (ArcadeFB_Begin()) { Game_Render(); ArcadeFB_End(); }
+//   else Game_Render();
+// -----------------------------------------------------------------------------
+
+static const int ARCADEFB_W = 320;
+static const int ARCADEFB_H = 240;
+
+// Creates the target. Returns false (and Begin stays a no-op) if the device
+// can't make one.
+bool ArcadeFB_Init();
+void ArcadeFB_Shutdown();
+
+// Redirects rendering into the target and clears it. Returns false when there
+// is no target; nothing changes in that case.
+bool ArcadeFB_Begin();
+
+// Restores the back buffer and queues the upscale quad (flushed with the rest
+// of the batch before EndScene).
+void ArcadeFB_End();
@@ -0,0 +1,199 @@
+// atlas.cpp
+#include "atlas.h"
+
+#include <xtl.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include "sprites_classic.h"
+#include "sprites_secret.h"
+#include "batch.h"
+#include "swizzle.h"
+
+// Device provided by main.cpp
+extern LPDIRECT3DDEVICE8 g_pDevice;
+
+// Every sprite in both packs fits in two 9-texel shelves of this width.
+static const int ATLAS_W = 128;
+static const int ATLAS_GUTTER = 1;
+
+struct AtlasRect
+{
+    float u0, v0, u1, v1;
+    int w, h;
+};
+
+struct SpriteAtlas
+{
+    LPDIRECT3DTEXTURE8 tex;
+    bool failed;                 // don't retry every Init once creation failed
+    AtlasRect rects[SPR_COUNT];
+};
+
+static SpriteAtlas s_atlas[2];   // 0 = classic, 1 = secret
+static SpriteAtlas* s_cur = NULL;
+
+static __forceinline bool IsPow2(int v) { return v > 0 && (v & (v - 1)) == 0; }
+
+// ------------------------------
+// Build
+// ------------------------------
+
+// Shelf-packs the pack's sprites left to right, rows of the tallest sprite.
+// Fills texel positions into outX/outY and returns the pow2 height needed.
+static int LayoutPack(const SpritePack4& pack, int* outX, int* outY)
+{
+    int x = ATLAS_GUTTER;
+    int y = ATLAS_GUTTER;
+    int shelfH = 0;
+
+    for (uint32_t i = 0; i < pack.spriteCount && i < (uint32_t)SPR_COUNT; ++i)
+    {
+        const Sprite4& spr = pack.sprites[i];
+        const int w = (int)spr.w;
+        const int h = (int)spr.h;
+
+        if (x + w + ATLAS_GUTTER > ATLAS_W)
+        {
+            x = ATLAS_GUTTER;
+            y += shelfH + ATLAS_GUTTER;
+            shelfH = 0;
+        }
+
+        outX[i] = x;
+        outY[i] = y;
+
+        x += w + ATLAS_GUTTER;
+        if (h > shelfH) shelfH = h;
+    }
+
+    int used = y + shelfH + ATLAS_GUTTER;
+    int texH = 1;
+    while (texH < used) texH <<= 1;
+    return texH;
+}
+
+static bool BuildAtlas(SpriteAtlas& atlas, const SpritePack4& pack)
+{
+    memset(atlas.rects, 0, sizeof(atlas.rects));
+
+    if (!g_pDevice || !pack.sprites || !pack.paletteARGB)
+        return false;
+
+    int cellX[SPR_COUNT];
+    int cellY[SPR_COUNT];
+    memset(cellX, 0, sizeof(cellX));
+    memset(cellY, 0, sizeof(cellY));
+
+    const int texW = ATLAS_W;
+    const int texH = LayoutPack(pack, cellX, cellY);
+    if (!IsPow2(texH) || texH > 256)
+        return false;
+
+    LPDIRECT3DTEXTURE8 tex = NULL;
+    if (FAILED(g_pDevice->CreateTexture((UINT)texW, (UINT)texH, 1, 0, D3DFMT_A8R8G8B8, 0, &tex)))
+        return false;
+
+    D3DLOCKED_RECT lr;
+    if (FAILED(tex->LockRect(0, &lr, NULL, 0)))
+    {
+        tex->Release();
+        return false;
+    }
+
+    // Expand to linear ARGB in the texture itself, swizzled in place at the
+    // end (index 0 and gutters stay 0 = transparent)
+    DWORD* pixels = (DWORD*)lr.pBits;
+    memset(pixels, 0, (size_t)(texW * texH) * sizeof(DWORD));
+
+    for (uint32_t i = 0; i < pack.spriteCount && i < (uint32_t)SPR_COUNT; ++i)
+    {
+        const Sprite4& spr = pack.sprites[i];
+        if (!spr.data || spr.w == 0 || spr.h == 0) continue;
+
+        // Paint the sprite's precomputed rects (sprites.h) into its cell
+        for (uint16_t k = 0; k < spr.rectCount; ++k)
+        {
+            const SpriteRect& sr = spr.rects[k];
+            const DWORD col = (DWORD)pack.paletteARGB[sr.color];
+
+            for (int yy = 0; yy < (int)sr.h; ++yy)
+            {
+                DWORD* row = pixels + (cellY[i] + sr.y + yy) * texW + cellX[i] + sr.x;
+                for (int xx = 0; xx < (int)sr.w; ++xx)
+                    row[xx] = col;
+            }
+        }
+
+        AtlasRect& r = atlas.rects[i];
+        r.w = (int)spr.w;
+        r.h = (int)spr.h;
+        r.u0 = (float)cellX[i] / (float)texW;
+        r.v0 = (float)cellY[i] / (float)texH;
+        r.u1 = (float)(cellX[i] + r.w) / (float)texW;
+        r.v1 = (float)(cellY[i] + r.h) / (float)texH;
+    }
+
+    const bool swizzled = Swizzle_InPlace32(pixels, texW, texH);
+    tex->UnlockRect(0);
+
+    if (!swizzled)
+    {
+        tex->Release();
+        return false;
+    }
+
+    atlas.tex = tex;
+    return true;
+}
+
+// ------------------------------
+// Public API
+// ------------------------------
+bool Atlas_Select(bool secret)
+{
+    SpriteAtlas& atlas = s_atlas[secret ? 1 : 0];
+
+    if (!atlas.tex && !atlas.failed)
+    {
+        if (!BuildAtlas(atlas, secret ? g_packSecret : g_packClassic))
+            atlas.failed = true;
+    }
+
+    s_cur = atlas.tex ? &atlas : NULL;
+    return s_cur != NULL;
+}
+
+bool Atlas_DrawSprite(SpriteId id, int x, int y, int scale)
+{
+    if (!s_cur) return false;
+    if ((uint32_t)id >= (uint32_t)SPR_COUNT) return true;
+
+    const AtlasRect& r = s_cur->rects[(uint32_t)id];
+    if (r.w == 0 || r.h == 0) return true;
+
+    Batch_PushQuadUV(s_cur->tex,
+        (float)x, (float)y, (float)(r.w * scale), (float)(r.h * scale),
+        r.u0, r.v0, r.u1, r.v1,
+        0xFFFFFFFF);
+
+    return true;
+}
+
+void Atlas_Shutdown()
+{
+    // Nothing queued may still point at these textures
+    Batch_Flush();
+
+    for (int i = 0; i < 2; ++i)
+    {
+        if (s_atlas[i].tex)
+        {
+            s_atlas[i].tex->Release();
+            s_atlas[i].tex = NULL;
+        }
+        s_atlas[i].failed = false;
+    }
+
+    s_cur = NULL;
+}
@@ -0,0 +1,27 @@
+#pragma once
+#include <xtl.h>
+#include "sprites.h"
+
+// -----------------------------------------------------------------------------
+// Sprite atlas.
+//
+// Each built-in sprite pack (classic / secret) is expanded once into a single
+// swizzled A8R8G8B8 texture, with every Sprite4 placed in its own cell and a
+// 1 texel transparent gutter around it. After that a sprite is one textured
+// quad queued through the 2D batch (batch.h).
+//
+// Atlases are built on first selection and kept until Atlas_Shutdown(), so
+// switching themes only swaps which texture is current.
+// -----------------------------------------------------------------------------
+
+// Makes the classic or secret atlas current, building it if needed.
+// Returns false if the texture could not be created (callers fall back to
+// drawing the pack pixel by pixel).
+bool Atlas_Select(bool secret);
+
+// Queues sprite `id` of the current atlas at (x,y), each texel `scale` pixels.
+// Returns false if no atlas is available.
+bool Atlas_DrawSprite(SpriteId id, int x, int y, int scale);
+
+// Releases both atlases.
+void Atlas_Shutdown();
@@ -12,7 +12,16 @@
 #include "sprites_classic.h"
 #include "sprites_secret.h"
 #include "SpriteAnimator.h"
+#include "atlas.h"
+#include "batch.h"
+#include "perf.h"
+#include "rstate.h"
 #include "score.h"
+#include "starfield.h"
+#include "clouds.h"
+#include "simclock.h"
+#include "texload.h"
+#include "quality.h"
 
 // Device provided by main.cpp
 extern LPDIRECT3DDEVICE8 g_pDevice;
@@ -23,162 +32,7 @@ static const int SCREEN_H = 480;
 // ----------------------------------------------------------------------------
 // 2D helpers
 // ----------------------------------------------------------------------------
-struct V2D
-{
-    float x, y, z, rhw;
-    DWORD color;
-};
-
-struct V2DTex
-{
-    float x, y, z, rhw;
-    DWORD color;
-    float u, v;
-};
-
 #define FVF_2D    (D3DFVF_XYZRHW | D3DFVF_DIFFUSE)
-#define FVF_2DTEX (D3DFVF_XYZRHW | D3DFVF_DIFFUSE | D3DFVF_TEX1)
-
-// ----------------------------------------------------------------------------
-// DDS loader (A8R8G8B8, pow2, swizzled) for clouds overlay
-// ----------------------------------------------------------------------------
-#pragma pack(push, 1)
-struct DDS_PIXELFORMAT
-{
-    DWORD size;
-    DWORD flags;
-    DWORD fourCC;
-    DWORD rgbBitCount;
-    DWORD rMask;
-    DWORD gMask;
-    DWORD bMask;
-    DWORD aMask;
-};
-
-struct DDS_HEADER
-{
-    DWORD           size;
-    DWORD           flags;
-    DWORD           height;
-    DWORD           width;
-    DWORD           pitchOrLinearSize;
-    DWORD           depth;
-    DWORD           mipMapCount;
-    DWORD           reserved1[11];
-    DDS_PIXELFORMAT ddspf;
-    DWORD           caps;
-    DWORD           caps2;
-    DWORD           caps3;
-    DWORD           caps4;
-    DWORD           reserved2;
-};
-#pragma pack(pop)
-
-static __forceinline int IsPow2(int v) { return (v > 0) && ((v & (v - 1)) == 0); }
-
-static LPDIRECT3DTEXTURE8 LoadTextureFromDDS_Rect(const char* path, int& outW, int& outH)
-{
-    outW = 0; outH = 0;
-    if (!g_pDevice || !path || !path[0]) return NULL;
-
-    HANDLE hFile = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
-    if (hFile == INVALID_HANDLE_VALUE) return NULL;
-
-    DWORD bytesRead = 0;
-
-    DWORD magic = 0;
-    if (!ReadFile(hFile, &magic, sizeof(DWORD), &bytesRead, NULL) ||
-        bytesRead != sizeof(DWORD) ||
-        magic != 0x20534444) // "DDS "
-    {
-        CloseHandle(hFile);
-        return NULL;
-    }
-
-    DDS_HEADER hdr;
-    if (!ReadFile(hFile, &hdr, sizeof(DDS_HEADER), &bytesRead, NULL) || bytesRead != sizeof(DDS_HEADER))
-    {
-        CloseHandle(hFile);
-        return NULL;
-    }
-
-    if (hdr.size != 124 || hdr.ddspf.size != 32)
-    {
-        CloseHandle(hFile);
-        return NULL;
-    }
-
-    const DWORD DDPF_FOURCC = 0x4;
-    const DWORD DDPF_RGB = 0x40;
-    const DWORD DDPF_ALPHAPIXELS = 0x1;
-
-    if (hdr.ddspf.flags & DDPF_FOURCC)
-    {
-        CloseHandle(hFile);
-        return NULL;
-    }
-
-    if (hdr.ddspf.rgbBitCount != 32 ||
-        (hdr.ddspf.flags & (DDPF_RGB | DDPF_ALPHAPIXELS)) != (DDPF_RGB | DDPF_ALPHAPIXELS) ||
-        hdr.ddspf.rMask != 0x00FF0000 ||
-        hdr.ddspf.gMask != 0x0000FF00 ||
-        hdr.ddspf.bMask != 0x000000FF ||
-        hdr.ddspf.aMask != 0xFF000000)
-    {
-        CloseHandle(hFile);
-        return NULL;
-    }
-
-    int w = (int)hdr.width;
-    int h = (int)hdr.height;
-
-    if (!IsPow2(w) || !IsPow2(h))
-    {
-        CloseHandle(hFile);
-        return NULL;
-    }
-
-    DWORD pixelBytes = (DWORD)(w * h * 4);
-    BYTE* pixels = (BYTE*)malloc(pixelBytes);
-    if (!pixels)
-    {
-        CloseHandle(hFile);
-        return NULL;
-    }
-
-    if (!ReadFile(hFile, pixels, pixelBytes, &bytesRead, NULL) || bytesRead != pixelBytes)
-    {
-        free(pixels);
-        CloseHandle(hFile);
-        return NULL;
-    }
-
-    CloseHandle(hFile);
-
-    LPDIRECT3DTEXTURE8 tex = NULL;
-    if (FAILED(g_pDevice->CreateTexture((UINT)w, (UINT)h, 1, 0, D3DFMT_A8R8G8B8, 0, &tex)))
-    {
-        free(pixels);
-        return NULL;
-    }
-
-    D3DLOCKED_RECT lr;
-    if (FAILED(tex->LockRect(0, &lr, NULL, 0)))
-    {
-        tex->Release();
-        free(pixels);
-        return NULL;
-    }
-
-    XGSwizzleRect(pixels, w * 4, NULL, lr.pBits, w, h, NULL, 4);
-    tex->UnlockRect(0);
-
-    free(pixels);
-
-    outW = w;
-    outH = h;
-    return tex;
-}
 
 // ----------------------------------------------------------------------------
 // Local state
@@ -191,7 +45,7 @@ static int  s_frame = 0;
 
 static int  s_demoFramesLeft = 0; // counts down; when 0 -> exit
 static const int kDemoSeconds = 45;
-static const int kFPS = 60;
+static const int kFPS = SIM_TICK_HZ;  // Attract_Update runs once per tick
 
 // Starfield
 static DWORD s_rng = 0x13579BDFu;
@@ -209,9 +63,7 @@ static __forceinline int RngRange(int lo, int hi)
 }
 
 static const int STAR_COUNT = 96;
-static int s_starX[STAR_COUNT];
-static int s_starY[STAR_COUNT];
-static int s_starSpd[STAR_COUNT];
+static StarfieldState s_stars;
 
 // Sprite rendering (matching game.cpp)
 static const SpritePack4* s_pack = &g_packClassic;
@@ -222,6 +74,7 @@ static const int SPR_SCALE = 2;
 static SpriteAnimator s_animInvaderA;
 static SpriteAnimator s_animInvaderB;
 static SpriteAnimator s_animInvaderC;
+static DWORD s_animMsCarry = 0;     // SimClock_TickMs remainder
 
 // Dual-layer clouds overlay (matching game.cpp)
 static const char* kCloudsDDS = "D:\\tex\\cloud_256.dds";
@@ -282,69 +135,25 @@ static void Prepare2D_NoTex()
 {
     if (!g_pDevice) return;
 
-    g_pDevice->SetTexture(0, NULL);
+    RS_SetTexture(0, NULL);
 
-    g_pDevice->SetRenderState(D3DRS_ZENABLE, D3DZB_FALSE);
-    g_pDevice->SetRenderState(D3DRS_CULLMODE, D3DCULL_NONE);
-    g_pDevice->SetRenderState(D3DRS_LIGHTING, FALSE);
+    RS_SetRenderState(D3DRS_ZENABLE, D3DZB_FALSE);
+    RS_SetRenderState(D3DRS_CULLMODE, D3DCULL_NONE);
+    RS_SetRenderState(D3DRS_LIGHTING, FALSE);
 
-    g_pDevice->SetRenderState(D3DRS_ALPHABLENDENABLE, FALSE);
-    g_pDevice->SetRenderState(D3DRS_ALPHATESTENABLE, FALSE);
+    RS_SetRenderState(D3DRS_ALPHABLENDENABLE, FALSE);
+    RS_SetRenderState(D3DRS_ALPHATESTENABLE, FALSE);
 
-    g_pDevice->SetTextureStageState(0, D3DTSS_COLOROP, D3DTOP_DISABLE);
-    g_pDevice->SetTextureStageState(0, D3DTSS_ALPHAOP, D3DTOP_DISABLE);
+    RS_SetTextureStageState(0, D3DTSS_COLOROP, D3DTOP_DISABLE);
+    RS_SetTextureStageState(0, D3DTSS_ALPHAOP, D3DTOP_DISABLE);
 
-    g_pDevice->SetVertexShader(FVF_2D);
-}
-
-static void Prepare2D_Tex()
-{
-    if (!g_pDevice) return;
-
-    g_pDevice->SetRenderState(D3DRS_ZENABLE, D3DZB_FALSE);
-    g_pDevice->SetRenderState(D3DRS_CULLMODE, D3DCULL_NONE);
-    g_pDevice->SetRenderState(D3DRS_LIGHTING, FALSE);
-
-    g_pDevice->SetRenderState(D3DRS_ALPHABLENDENABLE, TRUE);
-    g_pDevice->SetRenderState(D3DRS_ALPHATESTENABLE, FALSE);
-    g_pDevice->SetRenderState(D3DRS_SRCBLEND, D3DBLEND_SRCALPHA);
-    g_pDevice->SetRenderState(D3DRS_DESTBLEND, D3DBLEND_INVSRCALPHA);
-
-    g_pDevice->SetTextureStageState(0, D3DTSS_COLOROP, D3DTOP_MODULATE);
-    g_pDevice->SetTextureStageState(0, D3DTSS_COLORARG1, D3DTA_TEXTURE);
-    g_pDevice->SetTextureStageState(0, D3DTSS_COLORARG2, D3DTA_DIFFUSE);
-
-    g_pDevice->SetTextureStageState(0, D3DTSS_ALPHAOP, D3DTOP_MODULATE);
-    g_pDevice->SetTextureStageState(0, D3DTSS_ALPHAARG1, D3DTA_TEXTURE);
-    g_pDevice->SetTextureStageState(0, D3DTSS_ALPHAARG2, D3DTA_DIFFUSE);
-
-    g_pDevice->SetTextureStageState(0, D3DTSS_MAGFILTER, D3DTEXF_LINEAR);
-    g_pDevice->SetTextureStageState(0, D3DTSS_MINFILTER, D3DTEXF_LINEAR);
-    g_pDevice->SetTextureStageState(0, D3DTSS_MIPFILTER, D3DTEXF_NONE);
-
-    g_pDevice->SetTextureStageState(0, D3DTSS_ADDRESSU, D3DTADDRESS_WRAP);
-    g_pDevice->SetTextureStageState(0, D3DTSS_ADDRESSV, D3DTADDRESS_WRAP);
-
-    g_pDevice->SetVertexShader(FVF_2DTEX);
+    RS_SetVertexShader(FVF_2D);
 }
 
 static void DrawRect(int x, int y, int w, int h, DWORD color)
 {
-    if (!g_pDevice) return;
-    if (w <= 0 || h <= 0) return;
-
-    const float x0 = (float)x;
-    const float y0 = (float)y;
-    const float x1 = (float)(x + w);
-    const float y1 = (float)(y + h);
-
-    V2D v[4];
-    v[0].x = x0; v[0].y = y0; v[0].z = 0.0f; v[0].rhw = 1.0f; v[0].color = color;
-    v[1].x = x1; v[1].y = y0; v[1].z = 0.0f; v[1].rhw = 1.0f; v[1].color = color;
-    v[2].x = x0; v[2].y = y1; v[2].z = 0.0f; v[2].rhw = 1.0f; v[2].color = color;
-    v[3].x = x1; v[3].y = y1; v[3].z = 0.0f; v[3].rhw = 1.0f; v[3].color = color;
-
-    g_pDevice->DrawPrimitiveUP(D3DPT_TRIANGLESTRIP, 2, v, sizeof(V2D));
+    // Queued; submitted with neighbouring rects in one draw (see batch.h).
+    Batch_PushRect(x, y, w, h, color);
 }
 
 static void DrawCenteredText(const char* s, int y, float scale, DWORD color)
@@ -406,70 +215,22 @@ static void AppendStr(char* dst, int bufsz, const char* s)
 // ----------------------------------------------------------------------------
 // Dual-layer cloud rendering (matching game.cpp's dust/nebula effect)
 // ----------------------------------------------------------------------------
-static void DrawCloudLayer(LPDIRECT3DTEXTURE8 tex, int texW, int texH,
-    float uOff, float vOff, int alpha, bool additive)
+static void RenderClouds()
 {
-    if (!tex || texW <= 0 || texH <= 0) return;
-
-    // Tile the 256x256 texture so it seamlessly covers 640x480 screen
-    const int tilesX = ((SCREEN_W + texW - 1) / texW) + 1;
-    const int tilesY = ((SCREEN_H + texH - 1) / texH) + 1;
+    if (!s_clouds) return;
 
-    const float invW = 1.0f / (float)texW;
-    const float invH = 1.0f / (float)texH;
-
-    DWORD color;
-    if (additive)
-    {
-        // Brighter, additive layer
-        color = D3DCOLOR_ARGB(alpha, 255, 255, 255);
-        g_pDevice->SetRenderState(D3DRS_DESTBLEND, D3DBLEND_ONE);
-    }
-    else
-    {
-        // Base layer, normal blend
-        color = D3DCOLOR_ARGB(alpha, 255, 255, 255);
-        g_pDevice->SetRenderState(D3DRS_DESTBLEND, D3DBLEND_INVSRCALPHA);
-    }
+    // First layer - slower, dimmer; second layer - faster, additive
+    CloudLayer haze  = { s_cloudU0, s_cloudV0, D3DCOLOR_ARGB(30, 255, 255, 255) };
+    CloudLayer wisps = { s_cloudU1, s_cloudV1, D3DCOLOR_ARGB(18, 255, 255, 255) };
+    if (!Quality_CloudWisps()) wisps.tint = 0;
 
-    for (int ty = 0; ty < tilesY; ++ty)
-    {
-        for (int tx = 0; tx < tilesX; ++tx)
-        {
-            float sx = (float)(tx * texW);
-            float sy = (float)(ty * texH);
-            float ex = sx + (float)texW;
-            float ey = sy + (float)texH;
-
-            float u0 = (sx * invW) + uOff;
-            float v0 = (sy * invH) + vOff;
-            float u1 = (ex * invW) + uOff;
-            float v1 = (ey * invH) + vOff;
-
-            V2DTex v[4];
-            v[0].x = sx; v[0].y = sy; v[0].z = 0.0f; v[0].rhw = 1.0f; v[0].color = color; v[0].u = u0; v[0].v = v0;
-            v[1].x = ex; v[1].y = sy; v[1].z = 0.0f; v[1].rhw = 1.0f; v[1].color = color; v[1].u = u1; v[1].v = v0;
-            v[2].x = sx; v[2].y = ey; v[2].z = 0.0f; v[2].rhw = 1.0f; v[2].color = color; v[2].u = u0; v[2].v = v1;
-            v[3].x = ex; v[3].y = ey; v[3].z = 0.0f; v[3].rhw = 1.0f; v[3].color = color; v[3].u = u1; v[3].v = v1;
-
-            g_pDevice->DrawPrimitiveUP(D3DPT_TRIANGLESTRIP, 2, v, sizeof(V2DTex));
-        }
-    }
+    // Both layers in one pass (clouds.h)
+    Clouds_Render(s_clouds, s_cloudsW, s_cloudsH, haze, wisps);
 }
 
 // ------------------------------
 // Sprite renderer (4bpp packed, paletted) - matching game.cpp
 // ------------------------------
-static __forceinline uint8_t GetSpriteIndexAt(const Sprite4& spr, int x, int y)
-{
-    int w = (int)spr.w;
-    int idx = y * w + x;
-    int byteIndex = idx >> 1;
-    uint8_t b = spr.data[byteIndex];
-    if ((idx & 1) == 0) return (uint8_t)(b >> 4);
-    return (uint8_t)(b & 0x0F);
-}
-
 static void DrawSprite4(const SpritePack4* pack, SpriteId id, int x, int y, int scale)
 {
     if (!pack) return;
@@ -478,16 +239,16 @@ static void DrawSprite4(const SpritePack4* pack, SpriteId id, int x, int y, int
     const Sprite4& spr = pack->sprites[(uint32_t)id];
     if (!spr.data || spr.w == 0 || spr.h == 0) return;
 
-    for (int yy = 0; yy < (int)spr.h; ++yy)
-    {
-        for (int xx = 0; xx < (int)spr.w; ++xx)
-        {
-            uint8_t pi = GetSpriteIndexAt(spr, xx, yy);
-            if (pi == 0) continue;
+    // One textured quad from the theme atlas (selected in Attract_Init)
+    if (Atlas_DrawSprite(id, x, y, scale)) return;
 
-            DWORD col = (DWORD)pack->paletteARGB[pi];
-            DrawRect(x + xx * scale, y + yy * scale, scale, scale, col);
-        }
+    // Fallback if the atlas texture couldn't be created: walk the sprite's
+    // precomputed same-colour rects (sprites.h) instead of testing every pixel.
+    for (uint16_t i = 0; i < spr.rectCount; ++i)
+    {
+        const SpriteRect& r = spr.rects[i];
+        DrawRect(x + r.x * scale, y + r.y * scale, r.w * scale, r.h * scale,
+            (DWORD)pack->paletteARGB[r.color]);
     }
 }
 
@@ -496,12 +257,7 @@ static void DrawSprite4(const SpritePack4* pack, SpriteId id, int x, int y, int
 // ----------------------------------------------------------------------------
 static void ResetStars()
 {
-    for (int i = 0; i < STAR_COUNT; ++i)
-    {
-        s_starX[i] = RngRange(0, SCREEN_W - 1);
-        s_starY[i] = RngRange(0, SCREEN_H - 1);
-        s_starSpd[i] = 1 + (int)(RngNext() % 3);
-    }
+    Starfield_Init(s_stars, STAR_COUNT, STARFIELD_ATTRACT, SCREEN_W, SCREEN_H, RngNext());
 }
 
 // ----------------------------------------------------------------------------
@@ -829,20 +585,6 @@ static void UpdateEnemyBullets()
     }
 }
 
-static void UpdateStars()
-{
-    for (int i = 0; i < STAR_COUNT; ++i)
-    {
-        s_starY[i] += s_starSpd[i];
-        if (s_starY[i] >= SCREEN_H)
-        {
-            s_starY[i] = 0;
-            s_starX[i] = RngRange(0, SCREEN_W - 1);
-            s_starSpd[i] = 1 + (int)(RngNext() % 3);
-        }
-    }
-}
-
 // ----------------------------------------------------------------------------
 // Public API
 // ----------------------------------------------------------------------------
@@ -852,10 +594,14 @@ void Attract_Init(bool secretMode)
     s_secretMode = Title_IsSecret() ? true : false;
     s_pack = s_secretMode ? &g_packSecret : &g_packClassic;
 
+    // Expanded once per theme; later selections just swap textures
+    Atlas_Select(s_secretMode);
+
     s_running = true;
 
     s_prevButtons = 0;
     s_frame = 0;
+    s_animMsCarry = 0;
 
     s_demoFramesLeft = kDemoSeconds * kFPS;
 
@@ -898,12 +644,20 @@ void Attract_Init(bool secretMode)
     s_cloudU1 = 0.5f;
     s_cloudV1 = 0.25f;
 
-    if (g_pDevice)
-        s_clouds = LoadTextureFromDDS_Rect(kCloudsDDS, s_cloudsW, s_cloudsH);
+    TexLoad_Info info;
+    s_clouds = TexLoad_FromDDS(kCloudsDDS, info, TEXLOAD_NO_KEY);
+    s_cloudsW = info.w;
+    s_cloudsH = info.h;
+
+    // A DXT4 asset was premultiplied when it was cooked
+    if (info.fmt != TEXFMT_DXT4)
+        Clouds_PrepareTexture(s_clouds, s_cloudsW, s_cloudsH);
 }
 
 void Attract_Shutdown()
 {
+    Starfield_Shutdown(s_stars);
+
     if (s_clouds) { s_clouds->Release(); s_clouds = NULL; }
     s_cloudsW = s_cloudsH = 0;
 
@@ -931,14 +685,14 @@ bool Attract_Update()
     if (s_demoFramesLeft <= 0)
         return false;
 
-    UpdateStars();
+    Starfield_Update(s_stars);
     UpdateEnemies();
     UpdatePlayer();
     UpdateBullet();
     UpdateEnemyBullets();
 
-    // Update sprite animations (assuming 60 FPS, each frame is ~16.67ms)
-    const uint32_t deltaMs = 17; // approximately 1000ms / 60fps
+    // Update sprite animations by exactly one tick (16 or 17 ms)
+    const uint32_t deltaMs = (uint32_t)SimClock_TickMs(s_animMsCarry);
     s_animInvaderA.Update(deltaMs);
     s_animInvaderB.Update(deltaMs);
     s_animInvaderC.Update(deltaMs);
@@ -968,6 +722,8 @@ void Attract_Render()
 {
     if (!g_pDevice) return;
 
+    Starfield_SetDensity(s_stars, Quality_StarPercent());
+
     // ------------------------------------------------------------
     // Last 5 seconds: keep background (stars + clouds), but replace
     // playfield with HIGH SCORES overlay.
@@ -978,32 +734,21 @@ void Attract_Render()
         Prepare2D_NoTex();
 
         // Stars (same as normal render)
-        for (int i = 0; i < STAR_COUNT; ++i)
-        {
-            DWORD colStar = s_secret ? D3DCOLOR_XRGB(120, 120, 160) : D3DCOLOR_XRGB(120, 120, 120);
-            if (s_starSpd[i] == 3) colStar = s_secret ? D3DCOLOR_XRGB(180, 180, 220) : D3DCOLOR_XRGB(200, 200, 200);
-            DrawRect(s_starX[i], s_starY[i], 1, 1, colStar);
-        }
+        Starfield_Render(s_stars, s_secret);
 
         // Clouds overlay (same as normal render)
-        if (s_clouds)
-        {
-            Prepare2D_Tex();
-            g_pDevice->SetTexture(0, s_clouds);
-            DrawCloudLayer(s_clouds, s_cloudsW, s_cloudsH, s_cloudU0, s_cloudV0, 30, false);
-            DrawCloudLayer(s_clouds, s_cloudsW, s_cloudsH, s_cloudU1, s_cloudV1, 18, true);
-        }
+        RenderClouds();
 
         // Font state (same as your HUD section)
-        g_pDevice->SetTexture(0, NULL);
-        g_pDevice->SetRenderState(D3DRS_ALPHABLENDENABLE, FALSE);
-        g_pDevice->SetRenderState(D3DRS_ALPHATESTENABLE, FALSE);
-        g_pDevice->SetRenderState(D3DRS_ZENABLE, D3DZB_FALSE);
-        g_pDevice->SetRenderState(D3DRS_CULLMODE, D3DCULL_NONE);
-        g_pDevice->SetRenderState(D3DRS_LIGHTING, FALSE);
-        g_pDevice->SetTextureStageState(0, D3DTSS_COLOROP, D3DTOP_DISABLE);
-        g_pDevice->SetTextureStageState(0, D3DTSS_ALPHAOP, D3DTOP_DISABLE);
-        g_pDevice->SetVertexShader(FVF_2D);
+        RS_SetTexture(0, NULL);
+        RS_SetRenderState(D3DRS_ALPHABLENDENABLE, FALSE);
+        RS_SetRenderState(D3DRS_ALPHATESTENABLE, FALSE);
+        RS_SetRenderState(D3DRS_ZENABLE, D3DZB_FALSE);
+        RS_SetRenderState(D3DRS_CULLMODE, D3DCULL_NONE);
+        RS_SetRenderState(D3DRS_LIGHTING, FALSE);
+        RS_SetTextureStageState(0, D3DTSS_COLOROP, D3DTOP_DISABLE);
+        RS_SetTextureStageState(0, D3DTSS_ALPHAOP, D3DTOP_DISABLE);
+        RS_SetVertexShader(FVF_2D);
 
         // Fun neon-ish color cycle
         DWORD col = D3DCOLOR_XRGB(255, 0, 255); // magenta
@@ -1030,25 +775,10 @@ void Attract_Render()
     Prepare2D_NoTex();
 
     // Stars
-    for (int i = 0; i < STAR_COUNT; ++i)
-    {
-        DWORD col = s_secret ? D3DCOLOR_XRGB(120, 120, 160) : D3DCOLOR_XRGB(120, 120, 120);
-        if (s_starSpd[i] == 3) col = s_secret ? D3DCOLOR_XRGB(180, 180, 220) : D3DCOLOR_XRGB(200, 200, 200);
-        DrawRect(s_starX[i], s_starY[i], 1, 1, col);
-    }
+    Starfield_Render(s_stars, s_secret);
 
     // Dual-layer dust/nebula overlay (matching game.cpp)
-    if (s_clouds)
-    {
-        Prepare2D_Tex();
-        g_pDevice->SetTexture(0, s_clouds);
-
-        // First layer - slower, dimmer
-        DrawCloudLayer(s_clouds, s_cloudsW, s_cloudsH, s_cloudU0, s_cloudV0, 30, false);
-
-        // Second layer - faster, additive
-        DrawCloudLayer(s_clouds, s_cloudsW, s_cloudsH, s_cloudU1, s_cloudV1, 18, true);
-    }
+    RenderClouds();
 
     // Back to non-textured for gameplay elements
     Prepare2D_NoTex();
@@ -1103,15 +833,15 @@ void Attract_Render()
     }
 
     // HUD text (font requires caller state)
-    g_pDevice->SetTexture(0, NULL);
-    g_pDevice->SetRenderState(D3DRS_ALPHABLENDENABLE, FALSE);
-    g_pDevice->SetRenderState(D3DRS_ALPHATESTENABLE, FALSE);
-    g_pDevice->SetRenderState(D3DRS_ZENABLE, D3DZB_FALSE);
-    g_pDevice->SetRenderState(D3DRS_CULLMODE, D3DCULL_NONE);
-    g_pDevice->SetRenderState(D3DRS_LIGHTING, FALSE);
-    g_pDevice->SetTextureStageState(0, D3DTSS_COLOROP, D3DTOP_DISABLE);
-    g_pDevice->SetTextureStageState(0, D3DTSS_ALPHAOP, D3DTOP_DISABLE);
-    g_pDevice->SetVertexShader(FVF_2D);
+    RS_SetTexture(0, NULL);
+    RS_SetRenderState(D3DRS_ALPHABLENDENABLE, FALSE);
+    RS_SetRenderState(D3DRS_ALPHATESTENABLE, FALSE);
+    RS_SetRenderState(D3DRS_ZENABLE, D3DZB_FALSE);
+    RS_SetRenderState(D3DRS_CULLMODE, D3DCULL_NONE);
+    RS_SetRenderState(D3DRS_LIGHTING, FALSE);
+    RS_SetTextureStageState(0, D3DTSS_COLOROP, D3DTOP_DISABLE);
+    RS_SetTextureStageState(0, D3DTSS_ALPHAOP, D3DTOP_DISABLE);
+    RS_SetVertexShader(FVF_2D);
 
     // "DEMO" label
     DrawCenteredText("DEMO PLAY", 24, 2.5f, s_secret ? D3DCOLOR_XRGB(255, 210, 0) : D3DCOLOR_XRGB(255, 255, 255));
@@ -0,0 +1,177 @@
+// barrier.cpp
+#include "barrier.h"
+
+#include <xtl.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include "batch.h"
+#include "drawrec.h"
+
+// Device provided by main.cpp
+extern LPDIRECT3DDEVICE8 g_pDevice;
+
+static void MarkDirty(BarrierState& b, int x0, int y0, int x1, int y1)
+{
+    if (b.dirtyX0 >= b.dirtyX1)
+    {
+        b.dirtyX0 = x0; b.dirtyY0 = y0;
+        b.dirtyX1 = x1; b.dirtyY1 = y1;
+        return;
+    }
+
+    if (x0 < b.dirtyX0) b.dirtyX0 = x0;
+    if (y0 < b.dirtyY0) b.dirtyY0 = y0;
+    if (x1 > b.dirtyX1) b.dirtyX1 = x1;
+    if (y1 > b.dirtyY1) b.dirtyY1 = y1;
+}
+
+// Copies the dirty rect from the CPU copy into the texture.
+static void Upload(BarrierState& b)
+{
+    if (b.dirtyX0 >= b.dirtyX1) return;
+
+    RECT rc;
+    rc.left = b.dirtyX0;
+    rc.top = b.dirtyY0;
+    rc.right = b.dirtyX1;
+    rc.bottom = b.dirtyY1;
+
+    D3DLOCKED_RECT lr;
+    if (FAILED(b.tex->LockRect(0, &lr, &rc, 0)))
+        return;  // stays dirty, retried next frame
+
+    const int w = rc.right - rc.left;
+    const DWORD* src = b.pixels + rc.top * b.w + rc.left;
+    BYTE* dst = (BYTE*)lr.pBits;
+
+    for (int y = rc.top; y < rc.bottom; ++y)
+    {
+        memcpy(dst, src, (size_t)w * sizeof(DWORD));
+        src += b.w;
+        dst += lr.Pitch;
+    }
+
+    b.tex->UnlockRect(0);
+    DrawRec_InvalidateTexture(b.tex);
+
+    b.dirtyX0 = b.dirtyX1 = 0;
+    b.dirtyY0 = b.dirtyY1 = 0;
+}
+
+bool Barrier_Init(BarrierState& b, int w, int h)
+{
+    memset(&b, 0, sizeof(b));
+
+    if (!g_pDevice || w <= 0 || h <= 0) return false;
+
+    b.pixels = (DWORD*)malloc((size_t)(w * h) * sizeof(DWORD));
+    if (!b.pixels) return false;
+
+    if (FAILED(g_pDevice->CreateTexture((UINT)w, (UINT)h, 1, 0, D3DFMT_LIN_A8R8G8B8, 0, &b.tex)))
+    {
+        b.tex = NULL;
+        Barrier_Shutdown(b);
+        return false;
+    }
+
+    b.w = w;
+    b.h = h;
+    Barrier_Clear(b);
+    return true;
+}
+
+void Barrier_Shutdown(BarrierState& b)
+{
+    if (b.tex)
+    {
+        b.tex->Release();
+        b.tex = NULL;
+    }
+    if (b.pixels)
+    {
+        free(b.pixels);
+        b.pixels = NULL;
+    }
+    b.w = b.h = 0;
+    b.dirtyX0 = b.dirtyX1 = 0;
+    b.dirtyY0 = b.dirtyY1 = 0;
+}
+
+void Barrier_Clear(BarrierState& b)
+{
+    if (!b.pixels) return;
+
+    memset(b.pixels, 0, (size_t)(b.w * b.h) * sizeof(DWORD));
+    MarkDirty(b, 0, 0, b.w, b.h);
+}
+
+void Barrier_Stamp(BarrierState& b, const SpritePack4& pack, SpriteId id, int x, int y)
+{
+    if (!b.pixels || !pack.paletteARGB) return;
+    if ((uint32_t)id >= pack.spriteCount) return;
+
+    const Sprite4& spr = pack.sprites[(uint32_t)id];
+
+    for (uint16_t k = 0; k < spr.rectCount; ++k)
+    {
+        const SpriteRect& r = spr.rects[k];
+        const DWORD col = (DWORD)pack.paletteARGB[r.color];
+
+        int x0 = x + r.x, y0 = y + r.y;
+        int x1 = x0 + r.w, y1 = y0 + r.h;
+        if (x0 < 0) x0 = 0;
+        if (y0 < 0) y0 = 0;
+        if (x1 > b.w) x1 = b.w;
+        if (y1 > b.h) y1 = b.h;
+        if (x0 >= x1 || y0 >= y1) continue;
+
+        for (int yy = y0; yy < y1; ++yy)
+        {
+            DWORD* row = b.pixels + yy * b.w;
+            for (int xx = x0; xx < x1; ++xx)
+                row[xx] = col;
+        }
+
+        MarkDirty(b, x0, y0, x1, y1);
+    }
+}
+
+void Barrier_Erase(BarrierState& b, int x, int y, int w, int h)
+{
+    if (!b.pixels) return;
+
+    int x0 = x, y0 = y;
+    int x1 = x + w, y1 = y + h;
+    if (x0 < 0) x0 = 0;
+    if (y0 < 0) y0 = 0;
+    if (x1 > b.w) x1 = b.w;
+    if (y1 > b.h) y1 = b.h;
+    if (x0 >= x1 || y0 >= y1) return;
+
+    for (int yy = y0; yy < y1; ++yy)
+        memset(b.pixels + yy * b.w + x0, 0, (size_t)(x1 - x0) * sizeof(DWORD));
+
+    MarkDirty(b, x0, y0, x1, y1);
+}
+
+bool Barrier_Solid(const BarrierState& b, int x, int y)
+{
+    if (!b.pixels) return false;
+    if ((unsigned)x >= (unsigned)b.w || (unsigned)y >= (unsigned)b.h) return false;
+
+    return b.pixels[y * b.w + x] != 0;
+}
+
+bool Barrier_Draw(BarrierState& b, int x, int y, int scale)
+{
+    if (!b.tex) return false;
+
+    Upload(b);
+
+    Batch_PushQuadUV(b.tex,
+        (float)x, (float)y, (float)(b.w * scale), (float)(b.h * scale),
+        0.0f, 0.0f, (float)b.w, (float)b.h,
+        D3DCOLOR_ARGB(255, 255, 255, 255));
+    return true;
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include <xtl.h>
+
+#include "sprites.h"
+
+// -----------------------------------------------------------------------------
+// Destructible barrier (shield) surface.
+//
+// Each shield keeps a CPU copy of its pixels (1 texel per sprite pixel) and a
+// texture of the same size. Stamping or erasing only touches the CPU copy and
+// grows a dirty rect; Barrier_Draw uploads just that rect (nothing on a normal
+// frame) and queues the whole shield as one quad.
+//
+// Erase works on any rect down to single texels, so finer erosion than whole
+// tiles costs the same per frame: one quad, plus a small upload when hit.
+//
+// Usage:
+//   Barrier_Init(b, w, h);
+//   Barrier_Stamp(b, pack, SPR_BARRIER_TILE, tx, ty);   // build the shape
+//   Barrier_Erase(b, x, y, w, h);                       // on hits
+//   Barrier_Draw(b, screenX, screenY, scale);           // every frame
+// -----------------------------------------------------------------------------
+
+struct BarrierState
+{
+    DWORD* pixels;              // w * h ARGB, 0 = empty
+    int w, h;
+
+    LPDIRECT3DTEXTURE8 tex;     // linear, sampled with texel UVs
+
+    // Region not yet uploaded; empty when x0 >= x1
+    int dirtyX0, dirtyY0, dirtyX1, dirtyY1;
+};
+
+// Allocates the CPU copy and texture (both cleared). False if either fails;
+// Barrier_Draw then returns false so callers can draw tiles directly.
+bool Barrier_Init(BarrierState& b, int w, int h);
+void Barrier_Shutdown(BarrierState& b);
+
+// Empties the whole surface.
+void Barrier_Clear(BarrierState& b);
+
+// Paints a sprite at texel (x, y); transparent pixels leave what's there.
+void Barrier_Stamp(BarrierState& b, const SpritePack4& pack, SpriteId id, int x, int y);
+
+// Clears a texel rect (clipped).
+void Barrier_Erase(BarrierState& b, int x, int y, int w, int h);
+
+// True if the texel is set (out of range = empty).
+bool Barrier_Solid(const BarrierState& b, int x, int y);
+
+// Uploads pending changes and queues one quad of w*scale x h*scale.
+bool Barrier_Draw(BarrierState& b, int x, int y, int scale);
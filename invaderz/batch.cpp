@@ -0,0 +1,276 @@
+// batch.cpp
+#include "batch.h"
+
+#include <xtl.h>
+#include <string.h>
+#include <math.h>
+
+#include "perf.h"
+#include "rstate.h"
+#include "drawrec.h"
+#include "rqueue.h"
+
+// Device provided by main.cpp
+extern LPDIRECT3DDEVICE8 g_pDevice;
+
+#define FVF_BATCH (D3DFVF_XYZRHW | D3DFVF_DIFFUSE | D3DFVF_TEX1)
+
+// 1024 quads = 112KB of inline vertices per draw; a full formation plus
+// shields still fits in a handful of flushes.
+static const int BATCH_MAX_QUADS = 1024;
+
+// Point-sampled quads are nudged up/left by a quarter pixel so every pixel
+// centre lands inside its texel whichever rasterizer convention is in effect
+// (integer or half-integer centres). Without it, integer-aligned sprites can
+// pick up a neighbouring texel row/column at exact boundaries.
+static const float TEXEL_BIAS = 0.25f;
+
+static BatchVertex s_verts[BATCH_MAX_QUADS * 4];
+static int s_quads = 0;
+
+// Texture the queued quads are drawn with (NULL = flat colour)
+static LPDIRECT3DTEXTURE8 s_tex = NULL;
+
+// View scale applied at flush (1 = draw as queued)
+static float s_viewScale = 1.0f;
+
+static void ApplyState()
+{
+    RS_SetTexture(0, s_tex);
+
+    RS_SetRenderState(D3DRS_ALPHATESTENABLE, FALSE);
+
+    if (s_tex)
+    {
+        // texture * diffuse, texel alpha decides coverage
+        RS_SetRenderState(D3DRS_ALPHABLENDENABLE, TRUE);
+        RS_SetRenderState(D3DRS_SRCBLEND, D3DBLEND_SRCALPHA);
+        RS_SetRenderState(D3DRS_DESTBLEND, D3DBLEND_INVSRCALPHA);
+
+        RS_SetTextureStageState(0, D3DTSS_COLOROP, D3DTOP_MODULATE);
+        RS_SetTextureStageState(0, D3DTSS_COLORARG1, D3DTA_TEXTURE);
+        RS_SetTextureStageState(0, D3DTSS_COLORARG2, D3DTA_DIFFUSE);
+        RS_SetTextureStageState(0, D3DTSS_ALPHAOP, D3DTOP_MODULATE);
+        RS_SetTextureStageState(0, D3DTSS_ALPHAARG1, D3DTA_TEXTURE);
+        RS_SetTextureStageState(0, D3DTSS_ALPHAARG2, D3DTA_DIFFUSE);
+
+        RS_SetTextureStageState(0, D3DTSS_MAGFILTER, D3DTEXF_POINT);
+        RS_SetTextureStageState(0, D3DTSS_MINFILTER, D3DTEXF_POINT);
+        RS_SetTextureStageState(0, D3DTSS_MIPFILTER, D3DTEXF_NONE);
+
+        RS_SetTextureStageState(0, D3DTSS_ADDRESSU, D3DTADDRESS_CLAMP);
+        RS_SetTextureStageState(0, D3DTSS_ADDRESSV, D3DTADDRESS_CLAMP);
+
+        RS_SetTextureStageState(1, D3DTSS_COLOROP, D3DTOP_DISABLE);
+        RS_SetTextureStageState(1, D3DTSS_ALPHAOP, D3DTOP_DISABLE);
+    }
+    else
+    {
+        RS_SetRenderState(D3DRS_ALPHABLENDENABLE, FALSE);
+
+        RS_SetTextureStageState(0, D3DTSS_COLOROP, D3DTOP_DISABLE);
+        RS_SetTextureStageState(0, D3DTSS_ALPHAOP, D3DTOP_DISABLE);
+    }
+
+    RS_SetVertexShader(FVF_BATCH);
+}
+
+static __forceinline float SnapEdge(float v, float scale)
+{
+    return floorf(v * scale + 0.5f);
+}
+
+// Maps every queued quad through the view scale. Edges are snapped rather than
+// sizes, so rects that touched before still touch afterwards; the texel bias
+// is taken off before snapping and put back after.
+static void ApplyViewScale()
+{
+    const float s = s_viewScale;
+    const float bias = s_tex ? TEXEL_BIAS : 0.0f;
+
+    BatchVertex* v = s_verts;
+    for (int q = 0; q < s_quads; ++q, v += 4)
+    {
+        // Quad list order: TL, TR, BR, BL
+        const float x0 = SnapEdge(v[0].x + bias, s);
+        const float y0 = SnapEdge(v[0].y + bias, s);
+        float x1 = SnapEdge(v[2].x + bias, s);
+        float y1 = SnapEdge(v[2].y + bias, s);
+
+        if (x1 <= x0) x1 = x0 + 1.0f;
+        if (y1 <= y0) y1 = y0 + 1.0f;
+
+        v[0].x = v[3].x = x0 - bias;
+        v[1].x = v[2].x = x1 - bias;
+        v[0].y = v[1].y = y0 - bias;
+        v[2].y = v[3].y = y1 - bias;
+    }
+}
+
+void Batch_Flush()
+{
+    if (s_quads == 0) return;
+
+    if (g_pDevice)
+    {
+        if (s_viewScale != 1.0f)
+            ApplyViewScale();
+
+        ApplyState();
+        DrawRec_DrawPrimitiveUP(D3DPT_QUADLIST, (UINT)s_quads, s_verts, sizeof(BatchVertex));
+
+        Perf_Add(PERF_DRAW_CALLS, 1);
+        Perf_Add(PERF_BATCH_FLUSHES, 1);
+        Perf_Add(PERF_BATCH_QUADS, (DWORD)s_quads);
+    }
+
+    s_quads = 0;
+}
+
+void Batch_SetViewScale(float scale)
+{
+    if (scale == s_viewScale) return;
+
+    Batch_Flush();
+    s_viewScale = scale;
+}
+
+float Batch_ViewScale()
+{
+    return s_viewScale;
+}
+
+// Switches the batch texture, flushing whatever was queued under the old one.
+static __forceinline void UseTexture(LPDIRECT3DTEXTURE8 tex)
+{
+    if (tex == s_tex) return;
+
+    Batch_Flush();
+    s_tex = tex;
+}
+
+// One quad drawn with `tex`: queued here, or recorded while a render queue
+// is open (rqueue.h).
+static __forceinline BatchVertex* AllocQuad(LPDIRECT3DTEXTURE8 tex)
+{
+    if (RQ_Recording())
+    {
+        int got;
+        return RQ_AllocQuads(tex, 1, got);
+    }
+
+    UseTexture(tex);
+
+    if (s_quads >= BATCH_MAX_QUADS)
+        Batch_Flush();
+
+    return &s_verts[(s_quads++) * 4];
+}
+
+void Batch_MakeRect(BatchVertex* v, float x, float y, float w, float h, DWORD color)
+{
+    const float x1 = x + w;
+    const float y1 = y + h;
+
+    // Quad list order: TL, TR, BR, BL
+    v[0].x = x;  v[0].y = y;  v[0].z = 0.0f; v[0].rhw = 1.0f; v[0].color = color; v[0].u = 0.0f; v[0].v = 0.0f;
+    v[1].x = x1; v[1].y = y;  v[1].z = 0.0f; v[1].rhw = 1.0f; v[1].color = color; v[1].u = 0.0f; v[1].v = 0.0f;
+    v[2].x = x1; v[2].y = y1; v[2].z = 0.0f; v[2].rhw = 1.0f; v[2].color = color; v[2].u = 0.0f; v[2].v = 0.0f;
+    v[3].x = x;  v[3].y = y1; v[3].z = 0.0f; v[3].rhw = 1.0f; v[3].color = color; v[3].u = 0.0f; v[3].v = 0.0f;
+}
+
+void Batch_PushRectF(float x, float y, float w, float h, DWORD color)
+{
+    if (w <= 0.0f || h <= 0.0f) return;
+
+    Batch_MakeRect(AllocQuad(NULL), x, y, w, h, color);
+}
+
+void Batch_PushRect(int x, int y, int w, int h, DWORD color)
+{
+    if (w <= 0 || h <= 0) return;
+    Batch_PushRectF((float)x, (float)y, (float)w, (float)h, color);
+}
+
+void Batch_MakeQuadUV(BatchVertex* v,
+                      float x, float y, float w, float h,
+                      float u0, float v0, float u1, float v1,
+                      DWORD color)
+{
+    x -= TEXEL_BIAS;
+    y -= TEXEL_BIAS;
+
+    const float x1 = x + w;
+    const float y1 = y + h;
+
+    // Quad list order: TL, TR, BR, BL
+    v[0].x = x;  v[0].y = y;  v[0].z = 0.0f; v[0].rhw = 1.0f; v[0].color = color; v[0].u = u0; v[0].v = v0;
+    v[1].x = x1; v[1].y = y;  v[1].z = 0.0f; v[1].rhw = 1.0f; v[1].color = color; v[1].u = u1; v[1].v = v0;
+    v[2].x = x1; v[2].y = y1; v[2].z = 0.0f; v[2].rhw = 1.0f; v[2].color = color; v[2].u = u1; v[2].v = v1;
+    v[3].x = x;  v[3].y = y1; v[3].z = 0.0f; v[3].rhw = 1.0f; v[3].color = color; v[3].u = u0; v[3].v = v1;
+}
+
+void Batch_PushQuadUV(LPDIRECT3DTEXTURE8 tex,
+                      float x, float y, float w, float h,
+                      float u0, float v0, float u1, float v1,
+                      DWORD color)
+{
+    if (!tex) return;
+    if (w <= 0.0f || h <= 0.0f) return;
+
+    Batch_MakeQuadUV(AllocQuad(tex), x, y, w, h, u0, v0, u1, v1, color);
+}
+
+void Batch_PushQuads(LPDIRECT3DTEXTURE8 tex, const BatchVertex* verts, int quads)
+{
+    if (!tex || !verts) return;
+
+    if (RQ_Recording())
+    {
+        while (quads > 0)
+        {
+            int got;
+            BatchVertex* v = RQ_AllocQuads(tex, quads, got);
+            memcpy(v, verts, (size_t)got * 4 * sizeof(BatchVertex));
+            verts += got * 4;
+            quads -= got;
+        }
+        return;
+    }
+
+    UseTexture(tex);
+
+    while (quads > 0)
+    {
+        if (s_quads >= BATCH_MAX_QUADS)
+            Batch_Flush();
+
+        int n = BATCH_MAX_QUADS - s_quads;
+        if (n > quads) n = quads;
+
+        memcpy(&s_verts[s_quads * 4], verts, (size_t)n * 4 * sizeof(BatchVertex));
+        s_quads += n;
+        verts += n * 4;
+        quads -= n;
+    }
+}
+
+BatchVertex* Batch_AllocQuads(LPDIRECT3DTEXTURE8 tex, int want, int& got)
+{
+    if (RQ_Recording())
+        return RQ_AllocQuads(tex, want, got);
+
+    UseTexture(tex);
+
+    if (s_quads >= BATCH_MAX_QUADS)
+        Batch_Flush();
+
+    int n = BATCH_MAX_QUADS - s_quads;
+    if (n > want) n = want;
+    if (n < 0) n = 0;
+
+    BatchVertex* v = &s_verts[s_quads * 4];
+    s_quads += n;
+    got = n;
+    return v;
+}
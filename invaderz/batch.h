@@ -0,0 +1,69 @@
+#pragma once
+#include <xtl.h>
+
+// -----------------------------------------------------------------------------
+// 2D quad batcher.
+//
+// Collects screen-space rects into one vertex stream and submits them with a
+// single DrawPrimitiveUP (quad list) per flush, instead of one call per rect.
+// The batch sets its own render state when it flushes, so quads queued under
+// one state can never be drawn with whatever the caller set afterwards.
+//
+// Flat rects and textured quads can be mixed freely; the batch flushes by
+// itself whenever the texture changes, so keep same-texture work together.
+//
+// Usage:
+//   Batch_PushRect(x, y, w, h, color);  // any number of times
+//   Batch_PushQuadUV(tex, ...);          // point-sampled, alpha-blended
+//   Batch_Flush();                       // before talking to g_pDevice directly
+//
+// main.cpp flushes once more before EndScene(). While a render queue is open
+// (rqueue.h) pushes are recorded there and reach the batch sorted at RQ_End.
+// -----------------------------------------------------------------------------
+
+struct BatchVertex
+{
+    float x, y, z, rhw;
+    DWORD color;
+    float u, v;
+};
+
+void Batch_PushRect(int x, int y, int w, int h, DWORD color);
+void Batch_PushRectF(float x, float y, float w, float h, DWORD color);
+
+// Submits everything queued so far (no-op when empty).
+void Batch_Flush();
+
+// Scales queued quads by `scale` at flush time, snapping their edges to whole
+// pixels (never thinner than one). Callers keep drawing in 640x480 space; the
+// arcade framebuffer (arcadefb.h) sets 0.5 while rendering into its target.
+// Flushes first, so quads already queued keep the old scale.
+void Batch_SetViewScale(float scale);
+float Batch_ViewScale();
+
+// Textured quad (texture * color, blended by alpha). UVs follow the texture's
+// layout: 0..1 for swizzled (and DXT) textures, texels (0..width, 0..height)
+// for linear D3DFMT_LIN_* ones such as render targets (rtarget.h). Sampling
+// is point-filtered with clamp addressing.
+void Batch_PushQuadUV(LPDIRECT3DTEXTURE8 tex,
+                      float x, float y, float w, float h,
+                      float u0, float v0, float u1, float v1,
+                      DWORD color);
+
+// Fills one quad's 4 vertices exactly as Batch_PushQuadUV would queue them,
+// so callers can keep prebuilt quads around (see textcache.h).
+void Batch_MakeQuadUV(BatchVertex* v,
+                      float x, float y, float w, float h,
+                      float u0, float v0, float u1, float v1,
+                      DWORD color);
+
+// Queues prebuilt quads (4 vertices each) drawn with `tex`.
+void Batch_PushQuads(LPDIRECT3DTEXTURE8 tex, const BatchVertex* verts, int quads);
+
+// Fills one flat-colour quad (what Batch_PushRectF queues).
+void Batch_MakeRect(BatchVertex* v, float x, float y, float w, float h, DWORD color);
+
+// Reserves up to `want` quads drawn with `tex` (NULL = flat colour) and
+// returns their vertices; `got` says how many (at least 1 when want > 0).
+// All of them must be filled before the next batch call.
+BatchVertex* Batch_AllocQuads(LPDIRECT3DTEXTURE8 tex, int want, int& got);
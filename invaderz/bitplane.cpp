@@ -0,0 +1,177 @@
+// bitplane.cpp
+#include "bitplane.h"
+
+#include <string.h>
+
+// Byte of the plane (8 pixels, lowest bit leftmost) -> 8 texel bytes
+static uint8_t s_expand[256][8];
+static bool s_expandReady = false;
+
+static void BuildExpandTable()
+{
+    for (int b = 0; b < 256; ++b)
+        for (int j = 0; j < 8; ++j)
+            s_expand[b][j] = (b & (1 << j)) ? 0xFF : 0x00;
+
+    s_expandReady = true;
+}
+
+// ------------------------------
+// Sprites
+// ------------------------------
+bool BitSprite_FromSprite4(BitSprite& out, const Sprite4& spr)
+{
+    memset(&out, 0, sizeof(out));
+
+    if (spr.w > BITSPRITE_MAX_W || spr.h > BITSPRITE_MAX_H) return false;
+
+    out.w = spr.w;
+    out.h = spr.h;
+
+    // The rects cover exactly the lit pixels (sprites.h)
+    for (uint16_t i = 0; i < spr.rectCount; ++i)
+    {
+        const SpriteRect& r = spr.rects[i];
+        const uint32_t run = (r.w >= 32) ? 0xFFFFFFFFu : (((1u << r.w) - 1u) << r.x);
+
+        for (int y = r.y; y < r.y + r.h; ++y)
+            out.rows[y] |= run;
+    }
+
+    return true;
+}
+
+// ------------------------------
+// Drawing
+// ------------------------------
+void Bitplane_Clear(Bitplane& bp)
+{
+    memset(bp.rows, 0, sizeof(bp.rows));
+}
+
+// The row mask shifted to x, split over the (up to) two words it covers
+static inline bool PlaceRow(uint32_t mask, int x, int& word, uint32_t& lo, uint32_t& hi)
+{
+    if (x >= BITPLANE_W || x <= -BITSPRITE_MAX_W) return false;
+
+    if (x < 0)
+    {
+        mask >>= -x;
+        x = 0;
+    }
+
+    const uint64_t m = (uint64_t)mask << (x & 31);
+    word = x >> 5;
+    lo = (uint32_t)m;
+    hi = (word + 1 < BITPLANE_WORDS) ? (uint32_t)(m >> 32) : 0;
+    return true;
+}
+
+void Bitplane_Blit(Bitplane& bp, const BitSprite& s, int x, int y)
+{
+    for (int r = 0; r < s.h; ++r)
+    {
+        const int py = y + r;
+        if ((unsigned)py >= (unsigned)BITPLANE_H || !s.rows[r]) continue;
+
+        int word;
+        uint32_t lo, hi;
+        if (!PlaceRow(s.rows[r], x, word, lo, hi)) return;
+
+        uint32_t* row = bp.rows[py];
+        row[word] |= lo;
+        if (hi) row[word + 1] |= hi;
+    }
+}
+
+void Bitplane_Erase(Bitplane& bp, const BitSprite& s, int x, int y)
+{
+    for (int r = 0; r < s.h; ++r)
+    {
+        const int py = y + r;
+        if ((unsigned)py >= (unsigned)BITPLANE_H || !s.rows[r]) continue;
+
+        int word;
+        uint32_t lo, hi;
+        if (!PlaceRow(s.rows[r], x, word, lo, hi)) return;
+
+        uint32_t* row = bp.rows[py];
+        row[word] &= ~lo;
+        if (hi) row[word + 1] &= ~hi;
+    }
+}
+
+void Bitplane_Fill(Bitplane& bp, int x, int y, int w, int h)
+{
+    int x1 = x + w, y1 = y + h;
+    if (x < 0) x = 0;
+    if (y < 0) y = 0;
+    if (x1 > BITPLANE_W) x1 = BITPLANE_W;
+    if (y1 > BITPLANE_H) y1 = BITPLANE_H;
+    if (x >= x1 || y >= y1) return;
+
+    const int w0 = x >> 5;
+    const int w1 = (x1 - 1) >> 5;
+
+    // Bits from x up in the first word, up to x1 in the last
+    const uint32_t first = 0xFFFFFFFFu << (x & 31);
+    const uint32_t last = 0xFFFFFFFFu >> (31 - ((x1 - 1) & 31));
+
+    for (int py = y; py < y1; ++py)
+    {
+        uint32_t* row = bp.rows[py];
+
+        if (w0 == w1)
+        {
+            row[w0] |= first & last;
+            continue;
+        }
+
+        row[w0] |= first;
+        for (int i = w0 + 1; i < w1; ++i)
+            row[i] = 0xFFFFFFFFu;
+        row[w1] |= last;
+    }
+}
+
+bool Bitplane_Get(const Bitplane& bp, int x, int y)
+{
+    if ((unsigned)x >= (unsigned)BITPLANE_W || (unsigned)y >= (unsigned)BITPLANE_H) return false;
+    return (bp.rows[y][x >> 5] >> (x & 31)) & 1;
+}
+
+// ------------------------------
+// Upload
+// ------------------------------
+void Bitplane_Expand8(const Bitplane& bp, int y0, int rows, void* dst, int dstPitch)
+{
+    if (!s_expandReady) BuildExpandTable();
+
+    uint8_t* d = (uint8_t*)dst;
+
+    for (int r = 0; r < rows; ++r, d += dstPitch)
+    {
+        const int py = y0 + r;
+        if ((unsigned)py >= (unsigned)BITPLANE_H) continue;
+
+        const uint32_t* src = bp.rows[py];
+        uint8_t* p = d;
+
+        for (int i = 0; i < BITPLANE_WORDS; ++i, p += 32)
+        {
+            const uint32_t w = src[i];
+
+            // Most of the playfield is empty
+            if (w == 0)
+            {
+                memset(p, 0, 32);
+                continue;
+            }
+
+            memcpy(p +  0, s_expand[w & 0xFF], 8);
+            memcpy(p +  8, s_expand[(w >> 8) & 0xFF], 8);
+            memcpy(p + 16, s_expand[(w >> 16) & 0xFF], 8);
+            memcpy(p + 24, s_expand[w >> 24], 8);
+        }
+    }
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include <stdint.h>
+
+#include "sprites.h"
+
+// -----------------------------------------------------------------------------
+// 1bpp playfield bitplane, like the arcade's video RAM.
+//
+// One bit per sprite pixel over the arcade resolution (320x240, the game's
+// 640x480 at SPR_SCALE 2): 10 32-bit words per row, 9600 bytes in all. Bit b
+// of word w in a row is pixel w * 32 + b, so the lowest bit is leftmost.
+//
+// Sprites are pre-converted to one mask word per row (BitSprite, any lit
+// palette index is a set bit). Drawing or erasing a sprite row is one 64-bit
+// shift of its mask and an OR (or AND NOT) into the two words it straddles,
+// so a whole invader costs 8 shifts and 16 word operations.
+//
+// Portable (no D3D); game.cpp (GAME_BITPLANE) uploads the plane once a frame
+// and colours it by row, tools/hostbench.cpp checks and times it.
+// -----------------------------------------------------------------------------
+
+#define BITPLANE_W      320
+#define BITPLANE_H      240
+#define BITPLANE_WORDS  (BITPLANE_W / 32)
+
+#define BITSPRITE_MAX_W 32
+#define BITSPRITE_MAX_H 16
+
+struct Bitplane
+{
+    uint32_t rows[BITPLANE_H][BITPLANE_WORDS];
+};
+
+struct BitSprite
+{
+    int      w, h;
+    uint32_t rows[BITSPRITE_MAX_H];     // bit x = pixel x
+};
+
+// False (and an empty mask) if the sprite is bigger than 32x16.
+bool BitSprite_FromSprite4(BitSprite& out, const Sprite4& spr);
+
+void Bitplane_Clear(Bitplane& bp);
+
+// Sets / clears the sprite's pixels with its top-left at (x, y) in plane
+// pixels; anything off the plane is clipped.
+void Bitplane_Blit(Bitplane& bp, const BitSprite& s, int x, int y);
+void Bitplane_Erase(Bitplane& bp, const BitSprite& s, int x, int y);
+
+// Sets every pixel of a rect (clipped).
+void Bitplane_Fill(Bitplane& bp, int x, int y, int w, int h);
+
+bool Bitplane_Get(const Bitplane& bp, int x, int y);
+
+// Writes rows y0..y0+rows-1 as one byte per pixel (0x00 / 0xFF), `dstPitch`
+// bytes apart: the upload into an 8-bit texture. Expands a byte of the plane
+// at a time through a 256-entry table.
+void Bitplane_Expand8(const Bitplane& bp, int y0, int rows, void* dst, int dstPitch);
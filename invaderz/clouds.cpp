@@ -0,0 +1,157 @@
+// clouds.cpp
+#include "clouds.h"
+
+#include <xtl.h>
+
+#include "batch.h"
+#include "perf.h"
+#include "rstate.h"
+#include "drawrec.h"
+
+// Device provided by main.cpp
+extern LPDIRECT3DDEVICE8 g_pDevice;
+
+static const int SCREEN_W = 640;
+static const int SCREEN_H = 480;
+
+struct CloudVertex
+{
+    float x, y, z, rhw;
+    DWORD color;
+    float u0, v0;
+    float u1, v1;
+};
+
+#define FVF_CLOUDS (D3DFVF_XYZRHW | D3DFVF_DIFFUSE | D3DFVF_TEX2)
+
+// tint.rgb * tint.a / 255, alpha kept: the colour a premultiplied texel gets
+static DWORD PremultiplyTint(DWORD tint)
+{
+    const DWORD a = (tint >> 24) & 0xFF;
+    const DWORD r = (((tint >> 16) & 0xFF) * a + 127) / 255;
+    const DWORD g = (((tint >> 8) & 0xFF) * a + 127) / 255;
+    const DWORD b = ((tint & 0xFF) * a + 127) / 255;
+    return (a << 24) | (r << 16) | (g << 8) | b;
+}
+
+bool Clouds_PrepareTexture(LPDIRECT3DTEXTURE8 tex, int w, int h)
+{
+    if (!tex || w <= 0 || h <= 0) return false;
+
+    // Only raw texels can be edited in place (cooked DXT4 comes premultiplied)
+    D3DSURFACE_DESC desc;
+    if (FAILED(tex->GetLevelDesc(0, &desc)) || desc.Format != D3DFMT_A8R8G8B8)
+        return false;
+
+    D3DLOCKED_RECT lr;
+    if (FAILED(tex->LockRect(0, &lr, NULL, 0)))
+        return false;
+
+    // Per-texel operation, so the swizzled order doesn't matter
+    DWORD* p = (DWORD*)lr.pBits;
+    const int n = w * h;
+
+    for (int i = 0; i < n; ++i)
+    {
+        const DWORD c = p[i];
+        const DWORD a = c >> 24;
+
+        if (a == 255) continue;
+
+        const DWORD r = (((c >> 16) & 0xFF) * a + 127) / 255;
+        const DWORD g = (((c >> 8) & 0xFF) * a + 127) / 255;
+        const DWORD b = ((c & 0xFF) * a + 127) / 255;
+        p[i] = (a << 24) | (r << 16) | (g << 8) | b;
+    }
+
+    tex->UnlockRect(0);
+    return true;
+}
+
+void Clouds_Render(LPDIRECT3DTEXTURE8 tex, int texW, int texH, const CloudLayer& haze, const CloudLayer& wisps)
+{
+    if (!g_pDevice || !tex || texW <= 0 || texH <= 0) return;
+
+    // Queued rects were issued before this draw; keep painter's order.
+    Batch_Flush();
+
+    const float uSpan = (float)SCREEN_W / (float)texW;
+    const float vSpan = (float)SCREEN_H / (float)texH;
+
+    // Same texture coverage at any view scale (see Batch_SetViewScale)
+    const float view = Batch_ViewScale();
+
+    const DWORD col = PremultiplyTint(haze.tint);
+
+    CloudVertex v[4];
+    for (int i = 0; i < 4; ++i)
+    {
+        const float fx = (i == 1 || i == 3) ? 1.0f : 0.0f;
+        const float fy = (i >= 2) ? 1.0f : 0.0f;
+
+        v[i].x = fx * (float)SCREEN_W * view;
+        v[i].y = fy * (float)SCREEN_H * view;
+        v[i].z = 0.0f;
+        v[i].rhw = 1.0f;
+        v[i].color = col;
+        v[i].u0 = haze.u + fx * uSpan;
+        v[i].v0 = haze.v + fy * vSpan;
+        v[i].u1 = wisps.u + fx * uSpan;
+        v[i].v1 = wisps.v + fy * vSpan;
+    }
+
+    RS_SetRenderState(D3DRS_ZENABLE, D3DZB_FALSE);
+    RS_SetRenderState(D3DRS_CULLMODE, D3DCULL_NONE);
+    RS_SetRenderState(D3DRS_LIGHTING, FALSE);
+    RS_SetRenderState(D3DRS_ALPHATESTENABLE, FALSE);
+
+    RS_SetRenderState(D3DRS_ALPHABLENDENABLE, TRUE);
+    RS_SetRenderState(D3DRS_SRCBLEND, D3DBLEND_ONE);
+    RS_SetRenderState(D3DRS_DESTBLEND, D3DBLEND_INVSRCALPHA);
+
+    // No wisps (shed by the quality governor): the haze stage alone
+    const bool wispsOn = (wisps.tint >> 24) != 0;
+    const DWORD stages = wispsOn ? 2 : 1;
+
+    RS_SetRenderState(D3DRS_TEXTUREFACTOR, PremultiplyTint(wisps.tint));
+
+    for (DWORD stage = 0; stage < stages; ++stage)
+    {
+        RS_SetTexture(stage, tex);
+        RS_SetTextureStageState(stage, D3DTSS_TEXCOORDINDEX, stage);
+        RS_SetTextureStageState(stage, D3DTSS_MAGFILTER, D3DTEXF_LINEAR);
+        RS_SetTextureStageState(stage, D3DTSS_MINFILTER, D3DTEXF_LINEAR);
+        RS_SetTextureStageState(stage, D3DTSS_MIPFILTER, D3DTEXF_NONE);
+        RS_SetTextureStageState(stage, D3DTSS_ADDRESSU, D3DTADDRESS_WRAP);
+        RS_SetTextureStageState(stage, D3DTSS_ADDRESSV, D3DTADDRESS_WRAP);
+    }
+
+    // Stage 0: haze = texture * premultiplied haze tint, alpha = coverage
+    RS_SetTextureStageState(0, D3DTSS_COLOROP, D3DTOP_MODULATE);
+    RS_SetTextureStageState(0, D3DTSS_COLORARG1, D3DTA_TEXTURE);
+    RS_SetTextureStageState(0, D3DTSS_COLORARG2, D3DTA_DIFFUSE);
+    RS_SetTextureStageState(0, D3DTSS_ALPHAOP, D3DTOP_MODULATE);
+    RS_SetTextureStageState(0, D3DTSS_ALPHAARG1, D3DTA_TEXTURE);
+    RS_SetTextureStageState(0, D3DTSS_ALPHAARG2, D3DTA_DIFFUSE);
+
+    // Stage 1: current + texture * wisp tint (additive, doesn't touch alpha)
+    if (wispsOn)
+    {
+        RS_SetTextureStageState(1, D3DTSS_COLOROP, D3DTOP_MULTIPLYADD);
+        RS_SetTextureStageState(1, D3DTSS_COLORARG0, D3DTA_CURRENT);
+        RS_SetTextureStageState(1, D3DTSS_COLORARG1, D3DTA_TEXTURE);
+        RS_SetTextureStageState(1, D3DTSS_COLORARG2, D3DTA_TFACTOR);
+        RS_SetTextureStageState(1, D3DTSS_ALPHAOP, D3DTOP_SELECTARG1);
+        RS_SetTextureStageState(1, D3DTSS_ALPHAARG1, D3DTA_CURRENT);
+    }
+
+    RS_SetVertexShader(FVF_CLOUDS);
+
+    DrawRec_DrawPrimitiveUP(D3DPT_TRIANGLESTRIP, 2, v, sizeof(CloudVertex));
+    Perf_Add(PERF_DRAW_CALLS, 1);
+
+    // Nobody else expects a second stage
+    RS_SetTextureStageState(1, D3DTSS_COLOROP, D3DTOP_DISABLE);
+    RS_SetTextureStageState(1, D3DTSS_ALPHAOP, D3DTOP_DISABLE);
+    RS_SetTexture(1, NULL);
+}
@@ -0,0 +1,31 @@
+#pragma once
+#include <xtl.h>
+
+// -----------------------------------------------------------------------------
+// Cloud / nebula overlay (game + attract).
+//
+// Both scrolling layers are composited in ONE full-screen pass using two
+// texture stages over the same (premultiplied) cloud texture:
+//
+//   stage 0:  haze  = tex(uv0) * hazeTint            (vertex colour)
+//   stage 1:  out   = haze + tex(uv1) * wispTint     (texture factor)
+//   blend:    dst   = out + dst * (1 - hazeAlpha)    (ONE, INVSRCALPHA)
+//
+// which is exactly "haze alpha-blended, then wisps added" done as two passes,
+// at half the blended fill.
+// -----------------------------------------------------------------------------
+
+struct CloudLayer
+{
+    float u, v;     // scroll offset in texture widths/heights (wraps)
+    DWORD tint;     // ARGB; alpha is the layer opacity
+};
+
+// Premultiplies a freshly loaded A8R8G8B8 cloud texture in place (rgb *= a).
+// Must be done once per load before Clouds_Render, unless the asset was
+// cooked premultiplied (DXT4, tools/texcook.cpp). False for other formats.
+bool Clouds_PrepareTexture(LPDIRECT3DTEXTURE8 tex, int w, int h);
+
+// Draws haze (normal blend) and wisps (additive) in a single pass. Wisps with
+// a tint alpha of 0 are skipped, stage 1 and its texture fetch included.
+void Clouds_Render(LPDIRECT3DTEXTURE8 tex, int texW, int texH, const CloudLayer& haze, const CloudLayer& wisps);
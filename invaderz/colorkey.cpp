@@ -0,0 +1,203 @@
+// colorkey.cpp
+#include "colorkey.h"
+
+#if defined(_M_IX86) || defined(__MMX__)
+#include <mmintrin.h>
+#define COLORKEY_HAVE_MMX 1
+#else
+#define COLORKEY_HAVE_MMX 0
+#endif
+
+#if defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define COLORKEY_HAVE_SSE2 1
+#else
+#define COLORKEY_HAVE_SSE2 0
+#endif
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define COLORKEY_HAVE_AVX2 1
+#else
+#define COLORKEY_HAVE_AVX2 0
+#endif
+
+// The SIMD kernels all work the same way, per byte:
+//   diff = (p -sat k) | (k -sat p)       |p - k|
+//   over = diff -sat tol                 nonzero where |p - k| > tol
+// with 255 in the alpha lane of tol so alpha never counts. A texel whose four
+// `over` bytes are all zero is inside the key and is cleared; the rest get
+// alpha 255.
+
+// ------------------------------
+// Scalar
+// ------------------------------
+static inline uint32_t KeyTexel(uint32_t t, uint32_t key, int tol)
+{
+    for (int s = 0; s < 24; s += 8)
+    {
+        const int d = (int)((t >> s) & 0xFF) - (int)((key >> s) & 0xFF);
+        if (d > tol || d < -tol)
+            return t | 0xFF000000u;
+    }
+    return 0;
+}
+
+static void Key_Scalar(uint32_t* t, uint32_t count, uint32_t key, int tol)
+{
+    for (uint32_t i = 0; i < count; ++i)
+        t[i] = KeyTexel(t[i], key, tol);
+}
+
+static inline uint32_t TolMask(int tol)
+{
+    return 0xFF000000u | ((uint32_t)tol * 0x00010101u);
+}
+
+// ------------------------------
+// MMX
+// ------------------------------
+#if COLORKEY_HAVE_MMX
+static void Key_MMX(uint32_t* t, uint32_t count, uint32_t key, int tol)
+{
+    const __m64 k = _mm_set1_pi32((int)key);
+    const __m64 tv = _mm_set1_pi32((int)TolMask(tol));
+    const __m64 solid = _mm_set1_pi32((int)0xFF000000u);
+    const __m64 zero = _mm_setzero_si64();
+
+    __m64* p = (__m64*)t;
+    const uint32_t pairs = count / 2;
+
+    for (uint32_t i = 0; i < pairs; ++i)
+    {
+        const __m64 v = p[i];
+        const __m64 diff = _mm_or_si64(_mm_subs_pu8(v, k), _mm_subs_pu8(k, v));
+        const __m64 in = _mm_cmpeq_pi32(_mm_subs_pu8(diff, tv), zero);
+
+        p[i] = _mm_andnot_si64(in, _mm_or_si64(v, solid));
+    }
+
+    _mm_empty();
+
+    if (count & 1)
+        t[count - 1] = KeyTexel(t[count - 1], key, tol);
+}
+#endif
+
+// ------------------------------
+// SSE2
+// ------------------------------
+#if COLORKEY_HAVE_SSE2
+static void Key_SSE2(uint32_t* t, uint32_t count, uint32_t key, int tol)
+{
+    const __m128i k = _mm_set1_epi32((int)key);
+    const __m128i tv = _mm_set1_epi32((int)TolMask(tol));
+    const __m128i solid = _mm_set1_epi32((int)0xFF000000u);
+    const __m128i zero = _mm_setzero_si128();
+
+    uint32_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128i* p = (__m128i*)(t + i);
+        const __m128i v = _mm_loadu_si128(p);
+        const __m128i diff = _mm_or_si128(_mm_subs_epu8(v, k), _mm_subs_epu8(k, v));
+        const __m128i in = _mm_cmpeq_epi32(_mm_subs_epu8(diff, tv), zero);
+
+        _mm_storeu_si128(p, _mm_andnot_si128(in, _mm_or_si128(v, solid)));
+    }
+
+    for (; i < count; ++i)
+        t[i] = KeyTexel(t[i], key, tol);
+}
+#endif
+
+// ------------------------------
+// AVX2
+// ------------------------------
+#if COLORKEY_HAVE_AVX2
+static void Key_AVX2(uint32_t* t, uint32_t count, uint32_t key, int tol)
+{
+    const __m256i k = _mm256_set1_epi32((int)key);
+    const __m256i tv = _mm256_set1_epi32((int)TolMask(tol));
+    const __m256i solid = _mm256_set1_epi32((int)0xFF000000u);
+    const __m256i zero = _mm256_setzero_si256();
+
+    uint32_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256i* p = (__m256i*)(t + i);
+        const __m256i v = _mm256_loadu_si256(p);
+        const __m256i diff = _mm256_or_si256(_mm256_subs_epu8(v, k), _mm256_subs_epu8(k, v));
+        const __m256i in = _mm256_cmpeq_epi32(_mm256_subs_epu8(diff, tv), zero);
+
+        _mm256_storeu_si256(p, _mm256_andnot_si256(in, _mm256_or_si256(v, solid)));
+    }
+
+    for (; i < count; ++i)
+        t[i] = KeyTexel(t[i], key, tol);
+}
+#endif
+
+typedef void (*ColorKeyFn)(uint32_t*, uint32_t, uint32_t, int);
+
+static const ColorKeyFn kKernels[COLORKEY_KERNEL_COUNT] =
+{
+    Key_Scalar,
+#if COLORKEY_HAVE_MMX
+    Key_MMX,
+#else
+    NULL,
+#endif
+#if COLORKEY_HAVE_SSE2
+    Key_SSE2,
+#else
+    NULL,
+#endif
+#if COLORKEY_HAVE_AVX2
+    Key_AVX2,
+#else
+    NULL,
+#endif
+};
+
+static const char* const kKernelNames[COLORKEY_KERNEL_COUNT] = { "scalar", "mmx", "sse2", "avx2" };
+
+static ColorKey_Kernel s_kernel =
+    COLORKEY_HAVE_AVX2 ? COLORKEY_KERNEL_AVX2 :
+    COLORKEY_HAVE_SSE2 ? COLORKEY_KERNEL_SSE2 :
+    COLORKEY_HAVE_MMX ? COLORKEY_KERNEL_MMX : COLORKEY_KERNEL_SCALAR;
+
+// ------------------------------
+// Public API
+// ------------------------------
+void ColorKey_Apply(uint32_t* texels, uint32_t count, uint32_t key, int tol)
+{
+    if (!texels || count == 0) return;
+
+    if (tol < 0) tol = 0;
+    if (tol > 255) tol = 255;
+
+    kKernels[s_kernel](texels, count, key & 0x00FFFFFFu, tol);
+}
+
+bool ColorKey_KernelAvailable(ColorKey_Kernel k)
+{
+    return (unsigned)k < (unsigned)COLORKEY_KERNEL_COUNT && kKernels[k] != NULL;
+}
+
+bool ColorKey_SetKernel(ColorKey_Kernel k)
+{
+    if (!ColorKey_KernelAvailable(k)) return false;
+    s_kernel = k;
+    return true;
+}
+
+ColorKey_Kernel ColorKey_GetKernel()
+{
+    return s_kernel;
+}
+
+const char* ColorKey_KernelName(ColorKey_Kernel k)
+{
+    return ((unsigned)k < (unsigned)COLORKEY_KERNEL_COUNT) ? kKernelNames[k] : "?";
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include <stdint.h>
+
+// -----------------------------------------------------------------------------
+// Colour-key punchout for raw A8R8G8B8 art (the title logos).
+//
+// A texel whose R, G and B are each within `tol` of the key colour becomes
+// transparent black (0x00000000); every other texel keeps its colour and gets
+// alpha 255. Alpha is only ever 0 or 255, so that's already premultiplied:
+// draw the result with ONE / INVSRCALPHA. The input alpha is ignored.
+//
+// tools/texcook.cpp --key runs the same code offline and marks its output
+// DDPF_ALPHAPREMULT (texfmt.h), so the loader can skip this at boot.
+//
+// Kernels (same output, best one picked at build time; ColorKey_SetKernel
+// for tests):
+//   scalar  per-channel compare, one texel at a time (reference)
+//   mmx     2 texels per step with saturating byte subtracts (MMX, so it
+//           runs on the Pentium III; 32-bit x86 builds only)
+//   sse2    4 texels per step (host builds)
+//   avx2    8 texels per step (host builds with -mavx2)
+// -----------------------------------------------------------------------------
+
+enum ColorKey_Kernel
+{
+    COLORKEY_KERNEL_SCALAR = 0,
+    COLORKEY_KERNEL_MMX,
+    COLORKEY_KERNEL_SSE2,
+    COLORKEY_KERNEL_AVX2,
+
+    COLORKEY_KERNEL_COUNT
+};
+
+// Keys `count` 0xAARRGGBB texels in place. `key` is 0x??RRGGBB (alpha
+// ignored); `tol` is clamped to 0..255.
+void ColorKey_Apply(uint32_t* texels, uint32_t count, uint32_t key, int tol);
+
+bool ColorKey_KernelAvailable(ColorKey_Kernel k);
+bool ColorKey_SetKernel(ColorKey_Kernel k);
+ColorKey_Kernel ColorKey_GetKernel();
+const char* ColorKey_KernelName(ColorKey_Kernel k);
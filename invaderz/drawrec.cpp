@@ -0,0 +1,476 @@
+// drawrec.cpp
+#include "drawrec.h"
+
+#include <xtl.h>
+#include <xgraphics.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include "drawstream.h"
+#include "rstate.h"
+#include "swizzle.h"
+#include "texfmt.h"
+
+// Device provided by main.cpp
+extern LPDIRECT3DDEVICE8 g_pDevice;
+
+// Written out when full and at every frame end
+static const DWORD DRAWREC_BUFFER = 512 * 1024;
+
+// Distinct textures remembered between DrawRec_ForgetTextures calls
+static const int DRAWREC_MAX_TEXTURES = 64;
+
+struct RecTexture
+{
+    LPDIRECT3DBASETEXTURE8 ptr;
+    bool written;       // contents are in the stream
+    bool target;        // render target: contents come from replayed draws
+};
+
+static HANDLE s_file = INVALID_HANDLE_VALUE;
+static BYTE*  s_buf = NULL;
+static DWORD  s_used = 0;
+static int    s_framesLeft = 0;
+static DWORD  s_frame = 0;
+static bool   s_inFrame = false;
+
+static int    s_backW = 640;
+static int    s_backH = 480;
+
+static RecTexture s_tex[DRAWREC_MAX_TEXTURES];
+static int s_texCount = 0;
+
+// ------------------------------
+// Output
+// ------------------------------
+static void WriteOut(const void* data, DWORD size)
+{
+    DWORD written = 0;
+    if (!WriteFile(s_file, data, size, &written, NULL) || written != size)
+        DrawRec_Stop();
+}
+
+static void FlushBuffer()
+{
+    if (s_used == 0 || s_file == INVALID_HANDLE_VALUE) return;
+
+    const DWORD n = s_used;
+    s_used = 0;
+    WriteOut(s_buf, n);
+}
+
+static void Append(const void* data, DWORD size)
+{
+    if (s_file == INVALID_HANDLE_VALUE) return;
+
+    if (s_used + size > DRAWREC_BUFFER)
+    {
+        FlushBuffer();
+        if (size > DRAWREC_BUFFER)
+        {
+            WriteOut(data, size);
+            return;
+        }
+    }
+
+    memcpy(s_buf + s_used, data, size);
+    s_used += size;
+}
+
+// Header + fixed payload + optional trailing bytes
+static void Emit(DWORD type, const void* payload, DWORD payloadSize, const void* extra = NULL, DWORD extraSize = 0)
+{
+    if (!s_inFrame) return;
+
+    DS_Record r;
+    r.type = (uint16_t)type;
+    r.reserved = 0;
+    r.size = payloadSize + extraSize;
+
+    Append(&r, sizeof(r));
+    if (payloadSize) Append(payload, payloadSize);
+    if (extraSize) Append(extra, extraSize);
+}
+
+// ------------------------------
+// Textures
+// ------------------------------
+static RecTexture* FindTexture(LPDIRECT3DBASETEXTURE8 tex, uint32_t& id)
+{
+    for (int i = 0; i < s_texCount; ++i)
+    {
+        if (s_tex[i].ptr == tex)
+        {
+            id = (uint32_t)(i + 1);
+            return &s_tex[i];
+        }
+    }
+
+    if (s_texCount >= DRAWREC_MAX_TEXTURES)
+    {
+        id = 0;
+        return NULL;
+    }
+
+    RecTexture& t = s_tex[s_texCount++];
+    t.ptr = tex;
+    t.written = false;
+    t.target = false;
+    id = (uint32_t)s_texCount;
+    return &t;
+}
+
+static bool IsArgb(D3DFORMAT fmt)
+{
+    return fmt == D3DFMT_A8R8G8B8 || fmt == D3DFMT_X8R8G8B8 ||
+           fmt == D3DFMT_LIN_A8R8G8B8 || fmt == D3DFMT_LIN_X8R8G8B8;
+}
+
+static TexFmt BlockFormat(D3DFORMAT fmt)
+{
+    if (fmt == D3DFMT_DXT1) return TEXFMT_DXT1;
+    if (fmt == D3DFMT_DXT4) return TEXFMT_DXT4;
+    if (fmt == D3DFMT_DXT5) return TEXFMT_DXT5;
+    return TEXFMT_UNKNOWN;
+}
+
+// Writes level 0 as linear ARGB (DXT decoded in software). Other formats are
+// skipped; the replayer then samples white.
+static void WriteTextureData(LPDIRECT3DTEXTURE8 tex, uint32_t id, const D3DSURFACE_DESC& desc)
+{
+    const TexFmt blockFmt = BlockFormat(desc.Format);
+    if (!IsArgb(desc.Format) && blockFmt == TEXFMT_UNKNOWN) return;
+
+    const DWORD w = desc.Width;
+    const DWORD h = desc.Height;
+    DWORD* texels = (DWORD*)malloc((size_t)(w * h) * sizeof(DWORD));
+    if (!texels) return;
+
+    D3DLOCKED_RECT lr;
+    if (FAILED(tex->LockRect(0, &lr, NULL, D3DLOCK_READONLY)))
+    {
+        free(texels);
+        return;
+    }
+
+    if (blockFmt != TEXFMT_UNKNOWN)
+    {
+        TexFmt_DecodeDXT(blockFmt, lr.pBits, lr.Pitch, (int)w, (int)h,
+                         (uint32_t*)texels, (int)(w * sizeof(DWORD)));
+    }
+    else if (XGIsSwizzledFormat(desc.Format))
+    {
+        Swizzle_Unrect32(lr.pBits, (int)w, (int)h, texels, (int)(w * sizeof(DWORD)));
+    }
+    else
+    {
+        for (DWORD y = 0; y < h; ++y)
+            memcpy(texels + y * w, (const BYTE*)lr.pBits + y * lr.Pitch, w * sizeof(DWORD));
+    }
+
+    tex->UnlockRect(0);
+
+    if (desc.Format == D3DFMT_X8R8G8B8 || desc.Format == D3DFMT_LIN_X8R8G8B8)
+    {
+        for (DWORD i = 0; i < w * h; ++i)
+            texels[i] |= 0xFF000000;
+    }
+
+    DS_TextureData d;
+    d.id = id;
+    d.w = w;
+    d.h = h;
+    Emit(DS_REC_TEXTURE_DATA, &d, sizeof(d), texels, w * h * sizeof(DWORD));
+
+    free(texels);
+}
+
+// ------------------------------
+// Control
+// ------------------------------
+bool DrawRec_Start(const char* path, int frames)
+{
+    DrawRec_Stop();
+
+    if (!path || frames <= 0) return false;
+
+    s_buf = (BYTE*)malloc(DRAWREC_BUFFER);
+    if (!s_buf) return false;
+
+    s_file = CreateFileA(path, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (s_file == INVALID_HANDLE_VALUE)
+    {
+        free(s_buf);
+        s_buf = NULL;
+        return false;
+    }
+
+    DS_FileHeader hdr;
+    hdr.magic = DS_MAGIC;
+    hdr.version = DS_VERSION;
+    Append(&hdr, sizeof(hdr));
+
+    s_framesLeft = frames;
+    s_frame = 0;
+    s_texCount = 0;
+
+    LPDIRECT3DSURFACE8 back = NULL;
+    if (g_pDevice && SUCCEEDED(g_pDevice->GetRenderTarget(&back)))
+    {
+        D3DSURFACE_DESC desc;
+        if (SUCCEEDED(back->GetDesc(&desc)))
+        {
+            s_backW = (int)desc.Width;
+            s_backH = (int)desc.Height;
+        }
+        back->Release();
+    }
+
+    // Everything set before now is unknown to the stream; have it re-sent
+    RS_Invalidate();
+    return true;
+}
+
+void DrawRec_Stop()
+{
+    if (s_file != INVALID_HANDLE_VALUE)
+    {
+        HANDLE f = s_file;
+        FlushBuffer();
+        s_file = INVALID_HANDLE_VALUE;
+        CloseHandle(f);
+    }
+
+    if (s_buf)
+    {
+        free(s_buf);
+        s_buf = NULL;
+    }
+
+    s_used = 0;
+    s_framesLeft = 0;
+    s_inFrame = false;
+}
+
+bool DrawRec_Active()
+{
+    return s_file != INVALID_HANDLE_VALUE;
+}
+
+void DrawRec_BeginFrame()
+{
+    if (!DrawRec_Active()) return;
+
+    s_inFrame = true;
+
+    DS_FrameBegin b;
+    b.frame = s_frame++;
+    Emit(DS_REC_FRAME_BEGIN, &b, sizeof(b));
+
+    // Frames always start on the back buffer
+    DrawRec_Target(NULL, s_backW, s_backH);
+}
+
+void DrawRec_EndFrame()
+{
+    if (!s_inFrame) return;
+
+    Emit(DS_REC_FRAME_END, NULL, 0);
+    s_inFrame = false;
+    FlushBuffer();
+
+    if (--s_framesLeft <= 0)
+        DrawRec_Stop();
+}
+
+void DrawRec_ForgetTextures()
+{
+    s_texCount = 0;
+}
+
+void DrawRec_InvalidateTexture(LPDIRECT3DTEXTURE8 tex)
+{
+    for (int i = 0; i < s_texCount; ++i)
+    {
+        if (s_tex[i].ptr == (LPDIRECT3DBASETEXTURE8)tex)
+            s_tex[i].written = false;
+    }
+}
+
+// ------------------------------
+// Hooks
+// ------------------------------
+static uint16_t Factor(DWORD v)
+{
+    switch (v)
+    {
+    case D3DBLEND_ZERO:         return DS_FACTOR_ZERO;
+    case D3DBLEND_ONE:          return DS_FACTOR_ONE;
+    case D3DBLEND_SRCALPHA:     return DS_FACTOR_SRC_ALPHA;
+    case D3DBLEND_INVSRCALPHA:  return DS_FACTOR_INV_SRC_ALPHA;
+    default:                    return DS_FACTOR_OTHER;
+    }
+}
+
+static uint16_t Address(DWORD v)
+{
+    if (v == D3DTADDRESS_WRAP) return DS_ADDRESS_WRAP;
+    if (v == D3DTADDRESS_CLAMP) return DS_ADDRESS_CLAMP;
+    return DS_ADDRESS_OTHER;
+}
+
+void DrawRec_RenderState(D3DRENDERSTATETYPE state, DWORD value)
+{
+    if (!s_inFrame) return;
+
+    DS_StateChange c;
+    c.stage = 0;
+    c.state = (uint32_t)state;
+    c.value = (uint32_t)value;
+    c.known = DS_KNOWN_NONE;
+    c.knownValue = 0;
+
+    if (state == D3DRS_ALPHABLENDENABLE)
+    {
+        c.known = DS_KNOWN_BLEND_ENABLE;
+        c.knownValue = value ? 1 : 0;
+    }
+    else if (state == D3DRS_SRCBLEND)
+    {
+        c.known = DS_KNOWN_SRC_BLEND;
+        c.knownValue = Factor(value);
+    }
+    else if (state == D3DRS_DESTBLEND)
+    {
+        c.known = DS_KNOWN_DEST_BLEND;
+        c.knownValue = Factor(value);
+    }
+
+    Emit(DS_REC_RENDER_STATE, &c, sizeof(c));
+}
+
+void DrawRec_StageState(DWORD stage, D3DTEXTURESTAGESTATETYPE state, DWORD value)
+{
+    if (!s_inFrame) return;
+
+    DS_StateChange c;
+    c.stage = (uint32_t)stage;
+    c.state = (uint32_t)state;
+    c.value = (uint32_t)value;
+    c.known = DS_KNOWN_NONE;
+    c.knownValue = 0;
+
+    if (state == D3DTSS_COLOROP)
+    {
+        c.known = DS_KNOWN_COLOR_OP;
+        c.knownValue = (value == D3DTOP_DISABLE) ? DS_COLOROP_DISABLE : DS_COLOROP_OTHER;
+    }
+    else if (state == D3DTSS_ADDRESSU)
+    {
+        c.known = DS_KNOWN_ADDRESS_U;
+        c.knownValue = Address(value);
+    }
+    else if (state == D3DTSS_ADDRESSV)
+    {
+        c.known = DS_KNOWN_ADDRESS_V;
+        c.knownValue = Address(value);
+    }
+
+    Emit(DS_REC_STAGE_STATE, &c, sizeof(c));
+}
+
+void DrawRec_Texture(DWORD stage, LPDIRECT3DBASETEXTURE8 tex)
+{
+    if (!s_inFrame) return;
+
+    DS_TextureBind b;
+    memset(&b, 0, sizeof(b));
+    b.stage = (uint32_t)stage;
+
+    // Every texture in this game is a 2D texture
+    LPDIRECT3DTEXTURE8 tex2d = (LPDIRECT3DTEXTURE8)tex;
+    D3DSURFACE_DESC desc;
+    RecTexture* rt = NULL;
+
+    if (tex2d && SUCCEEDED(tex2d->GetLevelDesc(0, &desc)))
+    {
+        rt = FindTexture(tex, b.id);
+        b.w = desc.Width;
+        b.h = desc.Height;
+        // Compressed textures take normalized UVs like the swizzled ones
+        b.linear = (XGIsSwizzledFormat(desc.Format) ||
+                    BlockFormat(desc.Format) != TEXFMT_UNKNOWN) ? 0 : 1;
+
+        if (rt && !rt->written && !rt->target)
+        {
+            WriteTextureData(tex2d, b.id, desc);
+            rt->written = true;
+        }
+    }
+
+    Emit(DS_REC_TEXTURE, &b, sizeof(b));
+}
+
+void DrawRec_Shader(DWORD handle)
+{
+    if (!s_inFrame) return;
+
+    DS_Shader s;
+    s.fvf = (uint32_t)handle;
+    Emit(DS_REC_SHADER, &s, sizeof(s));
+}
+
+void DrawRec_Target(LPDIRECT3DTEXTURE8 tex, int w, int h)
+{
+    if (!s_inFrame) return;
+
+    DS_Target t;
+    t.id = 0;
+    t.w = (uint32_t)w;
+    t.h = (uint32_t)h;
+
+    if (tex)
+    {
+        RecTexture* rt = FindTexture((LPDIRECT3DBASETEXTURE8)tex, t.id);
+        if (rt) rt->target = true;
+    }
+
+    Emit(DS_REC_TARGET, &t, sizeof(t));
+}
+
+// ------------------------------
+// Device wrappers
+// ------------------------------
+void DrawRec_DrawPrimitiveUP(D3DPRIMITIVETYPE prim, UINT primCount, const void* verts, UINT stride)
+{
+    if (!g_pDevice) return;
+
+    g_pDevice->DrawPrimitiveUP(prim, primCount, verts, stride);
+
+    if (!s_inFrame) return;
+
+    DS_Draw d;
+    d.primCount = primCount;
+    d.stride = stride;
+
+    switch (prim)
+    {
+    case D3DPT_QUADLIST:      d.prim = DS_PRIM_QUADLIST;      d.vertexCount = primCount * 4; break;
+    case D3DPT_TRIANGLESTRIP: d.prim = DS_PRIM_TRIANGLESTRIP; d.vertexCount = primCount + 2; break;
+    case D3DPT_TRIANGLELIST:  d.prim = DS_PRIM_TRIANGLELIST;  d.vertexCount = primCount * 3; break;
+    default:                  d.prim = DS_PRIM_OTHER;         d.vertexCount = 0; break;
+    }
+
+    Emit(DS_REC_DRAW, &d, sizeof(d), verts, d.vertexCount * stride);
+}
+
+void DrawRec_Clear(D3DCOLOR color)
+{
+    if (!g_pDevice) return;
+
+    g_pDevice->Clear(0, NULL, D3DCLEAR_TARGET, color, 1.0f, 0);
+
+    DS_Clear c;
+    c.color = (uint32_t)color;
+    Emit(DS_REC_CLEAR, &c, sizeof(c));
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include <xtl.h>
+
+// -----------------------------------------------------------------------------
+// Draw stream recorder.
+//
+// Captures what reaches the device (draws with their vertices, state changes,
+// texture binds and contents, render-target switches, clears) into a binary
+// stream (drawstream.h) for tools/drawreplay.cpp to replay on a PC.
+//
+// Draws and clears go through the DrawRec_* wrappers below, which always call
+// the device and only record while a capture is running. rstate.cpp and
+// rtarget.cpp report state and target changes themselves.
+//
+// Capture is off in normal builds: set DRAWREC_CAPTURE_FRAMES to record that
+// many frames from boot to DRAWREC_PATH.
+// -----------------------------------------------------------------------------
+
+#ifndef DRAWREC_CAPTURE_FRAMES
+#define DRAWREC_CAPTURE_FRAMES 0
+#endif
+
+#define DRAWREC_PATH "T:\\drawstream.ds"
+
+// Opens `path` and records the next `frames` frames, then closes it.
+bool DrawRec_Start(const char* path, int frames);
+void DrawRec_Stop();
+bool DrawRec_Active();
+
+// Frame brackets (main.cpp), around everything drawn for one Present.
+void DrawRec_BeginFrame();
+void DrawRec_EndFrame();
+
+// Texture contents are written once per texture. Call Forget when textures
+// are released and recreated (scene changes), Invalidate after rewriting one.
+void DrawRec_ForgetTextures();
+void DrawRec_InvalidateTexture(LPDIRECT3DTEXTURE8 tex);
+
+// Hooks for calls that reached the device
+void DrawRec_RenderState(D3DRENDERSTATETYPE state, DWORD value);
+void DrawRec_StageState(DWORD stage, D3DTEXTURESTAGESTATETYPE state, DWORD value);
+void DrawRec_Texture(DWORD stage, LPDIRECT3DBASETEXTURE8 tex);
+void DrawRec_Shader(DWORD handle);
+
+// Render target switch; tex NULL = back buffer.
+void DrawRec_Target(LPDIRECT3DTEXTURE8 tex, int w, int h);
+
+// Device call + record
+void DrawRec_DrawPrimitiveUP(D3DPRIMITIVETYPE prim, UINT primCount, const void* verts, UINT stride);
+void DrawRec_Clear(D3DCOLOR color);
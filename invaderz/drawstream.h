@@ -0,0 +1,147 @@
+#pragma once
+#include <stdint.h>
+
+// -----------------------------------------------------------------------------
+// Draw stream format (written by drawrec.cpp, read by tools/drawreplay.cpp).
+//
+// File = DS_FileHeader, then records back to back. Every record is a
+// DS_Record header followed by `size` payload bytes, so readers can skip
+// types they don't know. Little-endian, no padding in the payload structs.
+//
+// A frame is everything between DS_REC_FRAME_BEGIN and DS_REC_FRAME_END.
+// State records are only written for calls that reached the device (after
+// rstate.h filtering), so counting them gives real state changes.
+//
+// D3D enum values differ between the Xbox and PC headers, so the few states
+// the replayer has to understand are also tagged with DS_KNOWN_* and a
+// normalized value; everything else is kept raw for counting only.
+// -----------------------------------------------------------------------------
+
+#define DS_MAGIC   0x53445A49u   // "IZDS"
+#define DS_VERSION 1u
+
+#pragma pack(push, 1)
+
+struct DS_FileHeader
+{
+    uint32_t magic;
+    uint32_t version;
+};
+
+enum DS_RecordType
+{
+    DS_REC_FRAME_BEGIN = 1,     // DS_FrameBegin
+    DS_REC_FRAME_END,           // no payload
+    DS_REC_RENDER_STATE,        // DS_StateChange (stage unused)
+    DS_REC_STAGE_STATE,         // DS_StateChange
+    DS_REC_TEXTURE,             // DS_TextureBind
+    DS_REC_TEXTURE_DATA,        // DS_TextureData + w * h ARGB texels
+    DS_REC_SHADER,              // DS_Shader
+    DS_REC_TARGET,              // DS_Target
+    DS_REC_CLEAR,               // DS_Clear
+    DS_REC_DRAW,                // DS_Draw + vertexCount * stride bytes
+};
+
+struct DS_Record
+{
+    uint16_t type;
+    uint16_t reserved;
+    uint32_t size;              // payload bytes after this header
+};
+
+struct DS_FrameBegin
+{
+    uint32_t frame;
+};
+
+enum DS_Known
+{
+    DS_KNOWN_NONE = 0,
+    DS_KNOWN_BLEND_ENABLE,      // value 0 / 1
+    DS_KNOWN_SRC_BLEND,         // DS_FACTOR_*
+    DS_KNOWN_DEST_BLEND,        // DS_FACTOR_*
+    DS_KNOWN_COLOR_OP,          // DS_COLOROP_*
+    DS_KNOWN_ADDRESS_U,         // DS_ADDRESS_*
+    DS_KNOWN_ADDRESS_V,
+};
+
+enum DS_Factor
+{
+    DS_FACTOR_OTHER = 0,
+    DS_FACTOR_ZERO,
+    DS_FACTOR_ONE,
+    DS_FACTOR_SRC_ALPHA,
+    DS_FACTOR_INV_SRC_ALPHA,
+};
+
+enum DS_ColorOp
+{
+    DS_COLOROP_OTHER = 0,
+    DS_COLOROP_DISABLE,
+};
+
+enum DS_Address
+{
+    DS_ADDRESS_OTHER = 0,
+    DS_ADDRESS_WRAP,
+    DS_ADDRESS_CLAMP,
+};
+
+struct DS_StateChange
+{
+    uint32_t stage;
+    uint32_t state;             // raw D3D value of the recording platform
+    uint32_t value;
+    uint16_t known;             // DS_Known
+    uint16_t knownValue;
+};
+
+struct DS_TextureBind
+{
+    uint32_t stage;
+    uint32_t id;                // 0 = none; stable while the texture lives
+    uint32_t w, h;
+    uint32_t linear;            // 1 = texel UVs (linear), 0 = normalized
+};
+
+struct DS_TextureData
+{
+    uint32_t id;
+    uint32_t w, h;
+};
+
+struct DS_Shader
+{
+    uint32_t fvf;
+};
+
+// Rendering now goes to texture `id` (0 = back buffer)
+struct DS_Target
+{
+    uint32_t id;
+    uint32_t w, h;
+};
+
+struct DS_Clear
+{
+    uint32_t color;
+};
+
+enum DS_Prim
+{
+    DS_PRIM_OTHER = 0,
+    DS_PRIM_QUADLIST,
+    DS_PRIM_TRIANGLESTRIP,
+    DS_PRIM_TRIANGLELIST,
+};
+
+// Vertices start with x, y, z, rhw, diffuse; uv(s) follow when stride >= 28
+struct DS_Draw
+{
+    uint32_t prim;              // DS_Prim
+    uint32_t primCount;
+    uint32_t stride;
+    uint32_t vertexCount;
+};
+
+#pragma pack(pop)
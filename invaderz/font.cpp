@@ -1,14 +1,13 @@
 #include "font.h"
 #include <xtl.h>
+#include <string.h>
+#include <math.h>
 
-// This matches the VERTEX layout used in renderer, but is local to this TU.
-struct VERTEX
-{
-    float x, y, z, rhw;
-    DWORD color;
-};
+#include "batch.h"    // glyph quads (or fallback pixel rects) are batched
+#include "swizzle.h"
+#include "quality.h"  // text shadows can be shed
 
-// Use the D3D device defined in renderer.cpp / main.cpp
+// Device provided by main.cpp
 extern LPDIRECT3DDEVICE8 g_pDevice;
 
 // 5x7 bitmap font data and renderer
@@ -20,12 +19,12 @@ struct Glyph
 };
 
 // NOTE:
-//  - az are mapped to AZ in FindGlyph() so we only store uppercase.
+//  - az are mapped to AZ in kGlyphIndex so we only store uppercase.
 //  - Unknown characters fall back to space.
 //  - This is a tweaked Option B style: slightly more geometric/sci-fi,
 //    but still 5x7 and compatible with the rest of the project.
 
-static Glyph g_font[] =
+static constexpr Glyph g_font[] =
 {
     // Space
     { ' ',{0x00,0x00,0x00,0x00,0x00,0x00,0x00} },
@@ -104,24 +103,111 @@ static Glyph g_font[] =
     { '>',{0x08,0x04,0x02,0x01,0x02,0x04,0x08} },
 };
 
-static const int g_fontCount = sizeof(g_font) / sizeof(g_font[0]);
+static constexpr int g_fontCount = sizeof(g_font) / sizeof(g_font[0]);
 
 // -----------------------------------------------------------------------------
-// Glyph lookup
+// Compile-time glyph tables
+//
+//  - kGlyphIndex: direct ASCII -> g_font index (lowercase folded to uppercase,
+//    unknown -> space, first entry wins like the old linear scan).
+//  - kGlyphSpans: each glyph's lit bits as row spans, adjacent bits merged, so
+//    drawing a glyph costs one rect per span instead of 35 bit tests.
 // -----------------------------------------------------------------------------
-static const Glyph* FindGlyph(char c)
+struct GlyphIndexTable
+{
+    unsigned char idx[128];
+};
+
+static constexpr GlyphIndexTable BuildGlyphIndex()
 {
-    // Force lowercase into uppercase
-    if (c >= 'a' && c <= 'z')
-        c = char(c - 'a' + 'A');
+    GlyphIndexTable t = {};
+
+    for (int code = 0; code < 128; ++code)
+    {
+        char c = (char)code;
+        if (c >= 'a' && c <= 'z')
+            c = char(c - 'a' + 'A');
+
+        t.idx[code] = 0; // default to space
+        for (int i = 0; i < g_fontCount; ++i)
+        {
+            if (g_font[i].ch == c)
+            {
+                t.idx[code] = (unsigned char)i;
+                break;
+            }
+        }
+    }
+
+    return t;
+}
+
+static constexpr GlyphIndexTable kGlyphIndex = BuildGlyphIndex();
+
+static_assert(g_fontCount <= 256, "glyph index must fit in a byte");
+
+struct GlyphSpan
+{
+    unsigned char row, x, w;
+};
+
+// 5 columns -> at most 3 separate spans per row
+static const int GLYPH_MAX_SPANS = 7 * 3;
+
+struct GlyphSpans
+{
+    unsigned char count;
+    GlyphSpan     s[GLYPH_MAX_SPANS];
+};
+
+struct GlyphSpanTable
+{
+    GlyphSpans g[g_fontCount];
+};
+
+static constexpr GlyphSpanTable BuildGlyphSpans()
+{
+    GlyphSpanTable t = {};
 
     for (int i = 0; i < g_fontCount; ++i)
     {
-        if (g_font[i].ch == c)
-            return &g_font[i];
+        GlyphSpans& gs = t.g[i];
+        gs.count = 0;
+
+        for (int row = 0; row < 7; ++row)
+        {
+            const unsigned char bits = g_font[i].r[row];
+
+            int col = 0;
+            while (col < 5)
+            {
+                if (((bits >> (4 - col)) & 1) == 0) { ++col; continue; }
+
+                int w = 1;
+                while (col + w < 5 && ((bits >> (4 - (col + w))) & 1)) ++w;
+
+                gs.s[gs.count].row = (unsigned char)row;
+                gs.s[gs.count].x = (unsigned char)col;
+                gs.s[gs.count].w = (unsigned char)w;
+                gs.count++;
+
+                col += w;
+            }
+        }
     }
-    // default to space
-    return &g_font[0];
+
+    return t;
+}
+
+static constexpr GlyphSpanTable kGlyphSpans = BuildGlyphSpans();
+
+// -----------------------------------------------------------------------------
+// Glyph lookup
+// -----------------------------------------------------------------------------
+static __forceinline int GlyphIndex(char c)
+{
+    const unsigned code = (unsigned char)c;
+    return (code < 128) ? kGlyphIndex.idx[code] : 0;
 }
 
 // -----------------------------------------------------------------------------
@@ -129,46 +215,134 @@ static const Glyph* FindGlyph(char c)
 // -----------------------------------------------------------------------------
 static void DrawCharRaw(float x, float y, char c, float scale, DWORD color)
 {
-    const Glyph* g = FindGlyph(c);
-    float pw = scale;
-    float ph = scale;
+    const GlyphSpans& gs = kGlyphSpans.g[GlyphIndex(c)];
+
+    for (int i = 0; i < gs.count; ++i)
+    {
+        const GlyphSpan& sp = gs.s[i];
+        Batch_PushRectF(x + sp.x * scale, y + sp.row * scale, sp.w * scale, scale, color);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Glyph atlas
+//
+// One 8x8 cell per ASCII code (16x8 cells = 128x64 texture). Each cell holds
+// the glyph in white plus its drop shadow in opaque black one texel down-right,
+// so a character including its shadow is a single 6x8 texel quad; the vertex
+// colour tints the white texels and leaves the shadow black.
+// -----------------------------------------------------------------------------
+static const int FONT_CELL = 8;
+static const int FONT_COLS = 16;
+static const int FONT_TEX_W = FONT_CELL * FONT_COLS;   // 128
+static const int FONT_TEX_H = FONT_CELL * 8;           // 64
+static const int FONT_QUAD_W = 6;                      // 5 glyph + 1 shadow
+static const int FONT_QUAD_H = 8;                      // 7 glyph + 1 shadow
+
+static LPDIRECT3DTEXTURE8 s_fontTex = NULL;
+static bool s_glyphBlank[128];    // nothing to draw (space, unknown chars)
+
+static void BakeGlyph(DWORD* pixels, int code)
+{
+    const GlyphSpans& gs = kGlyphSpans.g[GlyphIndex((char)code)];
+    DWORD* cell = pixels + (code / FONT_COLS) * FONT_CELL * FONT_TEX_W + (code % FONT_COLS) * FONT_CELL;
 
-    for (int row = 0; row < 7; ++row)
+    // shadow first, glyph on top (same order as the old two-pass draw)
+    for (int pass = 0; pass < 2; ++pass)
     {
-        unsigned char bits = g->r[row];
-        for (int col = 0; col < 5; ++col)
+        const int off = (pass == 0) ? 1 : 0;
+        const DWORD col = (pass == 0) ? 0xFF000000 : 0xFFFFFFFF;
+
+        for (int i = 0; i < gs.count; ++i)
         {
-            int bitIndex = 4 - col;
-            if ((bits >> bitIndex) & 1)
-            {
-                float px = x + col * pw;
-                float py = y + row * ph;
-
-                VERTEX v[4] =
-                {
-                    { px,      py,      0.0f, 1.0f, color },
-                    { px + pw, py,      0.0f, 1.0f, color },
-                    { px,      py + ph, 0.0f, 1.0f, color },
-                    { px + pw, py + ph, 0.0f, 1.0f, color }
-                };
-
-                g_pDevice->DrawPrimitiveUP(D3DPT_TRIANGLESTRIP, 2, v, sizeof(VERTEX));
-            }
+            const GlyphSpan& sp = gs.s[i];
+            DWORD* p = cell + (sp.row + off) * FONT_TEX_W + sp.x + off;
+            for (int k = 0; k < sp.w; ++k)
+                p[k] = col;
         }
     }
+
+    s_glyphBlank[code] = (gs.count == 0);
+}
+
+bool Font_Init()
+{
+    if (s_fontTex) return true;
+    if (!g_pDevice) return false;
+
+    static DWORD pixels[FONT_TEX_W * FONT_TEX_H];    // 32KB, only used here
+    memset(pixels, 0, sizeof(pixels));
+
+    for (int code = 0; code < 128; ++code)
+        BakeGlyph(pixels, code);
+
+    LPDIRECT3DTEXTURE8 tex = NULL;
+    if (FAILED(g_pDevice->CreateTexture(FONT_TEX_W, FONT_TEX_H, 1, 0, D3DFMT_A8R8G8B8, 0, &tex)))
+        return false;
+
+    D3DLOCKED_RECT lr;
+    if (FAILED(tex->LockRect(0, &lr, NULL, 0)))
+    {
+        tex->Release();
+        return false;
+    }
+
+    Swizzle_Rect32(pixels, FONT_TEX_W * 4, lr.pBits, FONT_TEX_W, FONT_TEX_H);
+    tex->UnlockRect(0);
+
+    s_fontTex = tex;
+    return true;
+}
+
+void Font_Shutdown()
+{
+    if (!s_fontTex) return;
+
+    // Nothing queued may still point at the texture
+    Batch_Flush();
+
+    s_fontTex->Release();
+    s_fontTex = NULL;
 }
 
 // -----------------------------------------------------------------------------
 // Stylized char: simple drop-shadow + main glyph
 // -----------------------------------------------------------------------------
+// Atlas UVs of a character's 6x8 quad; false if there is nothing to draw.
+static __forceinline bool GlyphUV(char c, float& u0, float& v0, float& u1, float& v1)
+{
+    const int code = (unsigned char)c;
+    if (code >= 128 || s_glyphBlank[code]) return false;
+
+    u0 = (float)((code % FONT_COLS) * FONT_CELL) / (float)FONT_TEX_W;
+    v0 = (float)((code / FONT_COLS) * FONT_CELL) / (float)FONT_TEX_H;
+    u1 = u0 + (float)FONT_QUAD_W / (float)FONT_TEX_W;
+    v1 = v0 + (float)FONT_QUAD_H / (float)FONT_TEX_H;
+    return true;
+}
+
 static void DrawChar(float x, float y, char c, float scale, DWORD color)
 {
+    if (s_fontTex)
+    {
+        float u0, v0, u1, v1;
+        if (!GlyphUV(c, u0, v0, u1, v1)) return;
+
+        // Text was always drawn opaque; keep it that way under blending
+        Batch_PushQuadUV(s_fontTex, x, y, FONT_QUAD_W * scale, FONT_QUAD_H * scale,
+            u0, v0, u1, v1, color | 0xFF000000);
+        return;
+    }
+
+    // Fallback (no atlas): lit pixels as rects
     // Slight offset for the shadow (scaled so it looks good at any size)
     float off = scale * 0.9f;
     DWORD shadowColor = D3DCOLOR_XRGB(0, 0, 0);
 
-    // Shadow pass (behind, down-right)
-    DrawCharRaw(x + off, y + off, c, scale, shadowColor);
+    // Shadow pass (behind, down-right); half the rects, so the quality
+    // governor can shed it. The atlas bakes the shadow into the same quad.
+    if (Quality_TextShadows())
+        DrawCharRaw(x + off, y + off, c, scale, shadowColor);
 
     // Main pass
     DrawCharRaw(x, y, c, scale, color);
@@ -177,8 +351,27 @@ static void DrawChar(float x, float y, char c, float scale, DWORD color)
 // -----------------------------------------------------------------------------
 // Public text draw
 // -----------------------------------------------------------------------------
+float Font_SnapScale(float scale)
+{
+    const float view = Batch_ViewScale();
+    if (view == 1.0f) return scale;
+
+    // 1.5 target pixels per glyph pixel would point-sample into uneven
+    // columns; round to whole ones (ties up), never below one.
+    float px = floorf(scale * view + 0.5f);
+    if (px < 1.0f) px = 1.0f;
+    return px / view;
+}
+
+float Font_TextWidth(const char* text, float scale)
+{
+    return (float)strlen(text) * (6.0f * Font_SnapScale(scale));
+}
+
 void DrawText(float x, float y, const char* text, float scale, DWORD color)
 {
+    scale = Font_SnapScale(scale);
+
     float cx = x;
     const float advance = 6.0f * scale; // 5px glyph + 1px gap
 
@@ -189,3 +382,38 @@ void DrawText(float x, float y, const char* text, float scale, DWORD color)
         ++text;
     }
 }
+
+// -----------------------------------------------------------------------------
+// Prebuilt text (for textcache.cpp)
+// -----------------------------------------------------------------------------
+LPDIRECT3DTEXTURE8 Font_Texture()
+{
+    return s_fontTex;
+}
+
+int Font_BuildText(BatchVertex* out, int maxQuads, float x, float y, const char* text, float scale, DWORD color)
+{
+    if (!s_fontTex) return -1;
+
+    scale = Font_SnapScale(scale);
+
+    float cx = x;
+    const float advance = 6.0f * scale; // same layout as DrawText
+    int n = 0;
+
+    while (*text && n < maxQuads)
+    {
+        float u0, v0, u1, v1;
+        if (GlyphUV(*text, u0, v0, u1, v1))
+        {
+            Batch_MakeQuadUV(&out[n * 4], cx, y, FONT_QUAD_W * scale, FONT_QUAD_H * scale,
+                u0, v0, u1, v1, color | 0xFF000000);
+            ++n;
+        }
+
+        cx += advance;
+        ++text;
+    }
+
+    return n;
+}
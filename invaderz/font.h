@@ -1,6 +1,28 @@
 #pragma once
 #include <xtl.h>
+#include "batch.h"
 
 // Simple 5x7 bitmap font renderer.
-// Uses the global g_pDevice defined in main.cpp.
+// Characters are queued through the 2D batch (batch.h) as one glyph-atlas
+// quad each, drop shadow included.
 void DrawText(float x, float y, const char* text, float scale, DWORD color);
+
+// Bakes the glyph atlas (call once the device exists). Without it DrawText
+// falls back to one rect per lit pixel.
+bool Font_Init();
+void Font_Shutdown();
+
+// Glyph atlas texture (NULL before Font_Init / if it failed).
+LPDIRECT3DTEXTURE8 Font_Texture();
+
+// Writes the quads DrawText would queue into out (4 vertices per quad, at
+// most maxQuads). Returns the quad count, or -1 if there is no atlas.
+int Font_BuildText(BatchVertex* out, int maxQuads, float x, float y, const char* text, float scale, DWORD color);
+
+// Scale the text is really drawn at. Under a view scale (arcadefb.h) it is
+// rounded so a glyph pixel covers a whole number of target pixels; at view
+// scale 1 it is returned as is.
+float Font_SnapScale(float scale);
+
+// Width DrawText covers for text at scale (6px cell, snapped scale).
+float Font_TextWidth(const char* text, float scale);
@@ -5,6 +5,7 @@
 #include <xgraphics.h>
 #include <string.h>
 #include <stdlib.h>
+#include <math.h>
 
 #include "input.h"
 #include "font.h"
@@ -14,7 +15,23 @@
 #include "sprites_classic.h"
 #include "sprites_secret.h"
 #include "SpriteAnimator.h"
+#include "atlas.h"
+#include "batch.h"
+#include "perf.h"
+#include "rstate.h"
 #include "score.h"            // High score table + render
+#include "starfield.h"
+#include "clouds.h"
+#include "textcache.h"
+#include "rtarget.h"
+#include "barrier.h"
+#include "rqueue.h"
+#include "simclock.h"
+#include "texload.h"
+#include "particles.h"
+#include "drawrec.h"
+#include "quality.h"
+#include "bitplane.h"
 
 // Device provided by main.cpp
 extern LPDIRECT3DDEVICE8 g_pDevice;
@@ -56,23 +73,8 @@ static const char* kCloudsDDS = "D:\\tex\\cloud_256.dds";
 // ------------------------------
 // Render helpers (2D)
 // ------------------------------
-struct V2D
-{
-    float x, y, z, rhw;
-    DWORD color;
-};
-
 #define FVF_2D (D3DFVF_XYZRHW | D3DFVF_DIFFUSE)
 
-struct V2DTex
-{
-    float x, y, z, rhw;
-    DWORD color;
-    float u, v;
-};
-
-#define FVF_2D_TEX (D3DFVF_XYZRHW | D3DFVF_DIFFUSE | D3DFVF_TEX1)
-
 // ------------------------------
 // Tiny RNG (integer-only)
 // ------------------------------
@@ -150,78 +152,25 @@ static void Prepare2D()
 {
     if (!g_pDevice) return;
 
-    g_pDevice->SetTexture(0, NULL);
-
-    g_pDevice->SetRenderState(D3DRS_ZENABLE, D3DZB_FALSE);
-    g_pDevice->SetRenderState(D3DRS_CULLMODE, D3DCULL_NONE);
-    g_pDevice->SetRenderState(D3DRS_LIGHTING, FALSE);
-
-    g_pDevice->SetRenderState(D3DRS_ALPHABLENDENABLE, FALSE);
-    g_pDevice->SetRenderState(D3DRS_ALPHATESTENABLE, FALSE);
-
-    g_pDevice->SetTextureStageState(0, D3DTSS_COLOROP, D3DTOP_DISABLE);
-    g_pDevice->SetTextureStageState(0, D3DTSS_ALPHAOP, D3DTOP_DISABLE);
-
-    g_pDevice->SetVertexShader(FVF_2D);
-}
-
-static void Prepare2DTextured(bool additive, bool useTextureAlpha, DWORD tf0 = D3DTEXF_POINT)
-{
-    if (!g_pDevice) return;
-
-    g_pDevice->SetRenderState(D3DRS_ZENABLE, D3DZB_FALSE);
-    g_pDevice->SetRenderState(D3DRS_CULLMODE, D3DCULL_NONE);
-    g_pDevice->SetRenderState(D3DRS_LIGHTING, FALSE);
-
-    g_pDevice->SetRenderState(D3DRS_ALPHATESTENABLE, FALSE);
-
-    g_pDevice->SetRenderState(D3DRS_ALPHABLENDENABLE, TRUE);
-    g_pDevice->SetRenderState(D3DRS_SRCBLEND, D3DBLEND_SRCALPHA);
-    g_pDevice->SetRenderState(D3DRS_DESTBLEND, additive ? D3DBLEND_ONE : D3DBLEND_INVSRCALPHA);
+    RS_SetTexture(0, NULL);
 
-    g_pDevice->SetTextureStageState(0, D3DTSS_COLOROP, D3DTOP_MODULATE);
-    g_pDevice->SetTextureStageState(0, D3DTSS_COLORARG1, D3DTA_TEXTURE);
-    g_pDevice->SetTextureStageState(0, D3DTSS_COLORARG2, D3DTA_DIFFUSE);
-
-    if (useTextureAlpha)
-    {
-        g_pDevice->SetTextureStageState(0, D3DTSS_ALPHAOP, D3DTOP_MODULATE);
-        g_pDevice->SetTextureStageState(0, D3DTSS_ALPHAARG1, D3DTA_TEXTURE);
-        g_pDevice->SetTextureStageState(0, D3DTSS_ALPHAARG2, D3DTA_DIFFUSE);
-    }
-    else
-    {
-        g_pDevice->SetTextureStageState(0, D3DTSS_ALPHAOP, D3DTOP_SELECTARG2);
-        g_pDevice->SetTextureStageState(0, D3DTSS_ALPHAARG2, D3DTA_DIFFUSE);
-    }
+    RS_SetRenderState(D3DRS_ZENABLE, D3DZB_FALSE);
+    RS_SetRenderState(D3DRS_CULLMODE, D3DCULL_NONE);
+    RS_SetRenderState(D3DRS_LIGHTING, FALSE);
 
-    g_pDevice->SetTextureStageState(0, D3DTSS_MAGFILTER, tf0);
-    g_pDevice->SetTextureStageState(0, D3DTSS_MINFILTER, tf0);
-    g_pDevice->SetTextureStageState(0, D3DTSS_MIPFILTER, D3DTEXF_NONE);
+    RS_SetRenderState(D3DRS_ALPHABLENDENABLE, FALSE);
+    RS_SetRenderState(D3DRS_ALPHATESTENABLE, FALSE);
 
-    g_pDevice->SetTextureStageState(0, D3DTSS_ADDRESSU, D3DTADDRESS_WRAP);
-    g_pDevice->SetTextureStageState(0, D3DTSS_ADDRESSV, D3DTADDRESS_WRAP);
+    RS_SetTextureStageState(0, D3DTSS_COLOROP, D3DTOP_DISABLE);
+    RS_SetTextureStageState(0, D3DTSS_ALPHAOP, D3DTOP_DISABLE);
 
-    g_pDevice->SetVertexShader(FVF_2D_TEX);
+    RS_SetVertexShader(FVF_2D);
 }
 
 static void DrawRect(int x, int y, int w, int h, DWORD color)
 {
-    if (!g_pDevice) return;
-    if (w <= 0 || h <= 0) return;
-
-    const float x0 = (float)x;
-    const float y0 = (float)y;
-    const float x1 = (float)(x + w);
-    const float y1 = (float)(y + h);
-
-    V2D v[4];
-    v[0].x = x0; v[0].y = y0; v[0].z = 0.0f; v[0].rhw = 1.0f; v[0].color = color;
-    v[1].x = x1; v[1].y = y0; v[1].z = 0.0f; v[1].rhw = 1.0f; v[1].color = color;
-    v[2].x = x0; v[2].y = y1; v[2].z = 0.0f; v[2].rhw = 1.0f; v[2].color = color;
-    v[3].x = x1; v[3].y = y1; v[3].z = 0.0f; v[3].rhw = 1.0f; v[3].color = color;
-
-    g_pDevice->DrawPrimitiveUP(D3DPT_TRIANGLESTRIP, 2, v, sizeof(V2D));
+    // Queued; submitted with neighbouring rects in one draw (see batch.h).
+    Batch_PushRect(x, y, w, h, color);
 }
 
 static void DrawHLine(int x, int y, int w, DWORD color)
@@ -233,7 +182,7 @@ static void DrawCenteredText(const char* s, int y, float scale, DWORD color)
 {
     if (!s || !s[0]) return;
 
-    float w = (float)strlen(s) * (6.0f * scale);
+    float w = Font_TextWidth(s, scale);
     float x = ((float)SCREEN_W - w) * 0.5f;
     DrawText(x, (float)y, s, scale, color);
 }
@@ -248,19 +197,16 @@ static bool s_secretMode = false;
 static SpriteAnimator s_animInvaderA;
 static SpriteAnimator s_animInvaderB;
 static SpriteAnimator s_animInvaderC;
+static DWORD s_animMsCarry = 0;     // SimClock_TickMs remainder
 
 // pixel scale for the whole game look (2 = "chunky arcade")
 static const int SPR_SCALE = 2;
 
-static __forceinline uint8_t GetSpriteIndexAt(const Sprite4& spr, int x, int y)
+static SpriteId InvaderSprite(int type)
 {
-    // packed: high nibble = left pixel, low nibble = right pixel
-    int w = (int)spr.w;
-    int idx = y * w + x;
-    int byteIndex = idx >> 1;
-    uint8_t b = spr.data[byteIndex];
-    if ((idx & 1) == 0) return (uint8_t)(b >> 4);
-    return (uint8_t)(b & 0x0F);
+    if (type == 2) return s_animInvaderA.GetCurrentSprite();
+    if (type == 1) return s_animInvaderB.GetCurrentSprite();
+    return s_animInvaderC.GetCurrentSprite();
 }
 
 static void DrawSprite4(const SpritePack4* pack, SpriteId id, int x, int y, int scale)
@@ -271,320 +217,280 @@ static void DrawSprite4(const SpritePack4* pack, SpriteId id, int x, int y, int
     const Sprite4& spr = pack->sprites[(uint32_t)id];
     if (!spr.data || spr.w == 0 || spr.h == 0) return;
 
-    // NOTE: This is intentionally simple (DrawRect per solid pixel).
-    // Sprites are tiny, so it's fine and matches the "chunky" look.
-    for (int yy = 0; yy < (int)spr.h; ++yy)
-    {
-        for (int xx = 0; xx < (int)spr.w; ++xx)
-        {
-            uint8_t pi = GetSpriteIndexAt(spr, xx, yy);
-            if (pi == 0) continue; // transparent
+    // One textured quad from the theme atlas (selected in Game_Init)
+    if (Atlas_DrawSprite(id, x, y, scale)) return;
 
-            DWORD col = (DWORD)pack->paletteARGB[pi];
-            DrawRect(x + xx * scale, y + yy * scale, scale, scale, col);
-        }
+    // Fallback if the atlas texture couldn't be created: walk the sprite's
+    // precomputed same-colour rects (sprites.h) instead of testing every pixel.
+    for (uint16_t i = 0; i < spr.rectCount; ++i)
+    {
+        const SpriteRect& r = spr.rects[i];
+        DrawRect(x + r.x * scale, y + r.y * scale, r.w * scale, r.h * scale,
+            (DWORD)pack->paletteARGB[r.color]);
     }
 }
 
 // ------------------------------
-// DDS loader (swizzled A8R8G8B8) for clouds overlay
+// Background: starfield + clouds overlay
 // ------------------------------
-#pragma pack(push, 1)
-struct DDS_PIXELFORMAT
-{
-    DWORD size;
-    DWORD flags;
-    DWORD fourCC;
-    DWORD rgbBitCount;
-    DWORD rMask;
-    DWORD gMask;
-    DWORD bMask;
-    DWORD aMask;
-};
+static const int STAR_COUNT = 96;
 
-struct DDS_HEADER
-{
-    DWORD           size;
-    DWORD           flags;
-    DWORD           height;
-    DWORD           width;
-    DWORD           pitchOrLinearSize;
-    DWORD           depth;
-    DWORD           mipMapCount;
-    DWORD           reserved1[11];
-    DDS_PIXELFORMAT ddspf;
-    DWORD           caps;
-    DWORD           caps2;
-    DWORD           caps3;
-    DWORD           caps4;
-    DWORD           reserved2;
-};
-#pragma pack(pop)
+static StarfieldState s_stars;
 
-static __forceinline int IsPow2(int v) { return (v > 0) && ((v & (v - 1)) == 0); }
+static LPDIRECT3DTEXTURE8 s_texClouds = NULL;
+static int  s_cloudW = 0;
+static int  s_cloudH = 0;
 
-static LPDIRECT3DTEXTURE8 LoadTextureFromDDS_Rect(const char* path, int& outW, int& outH)
-{
-    outW = 0;
-    outH = 0;
+// UV scroll accumulators
+static int s_cloudU0 = 0;
+static int s_cloudV0 = 0;
+static int s_cloudU1 = 0;
+static int s_cloudV1 = 0;
 
-    if (!g_pDevice || !path || !path[0])
-        return NULL;
+// The background is cosmetic, so it is advanced on the render side to the
+// tick of the snapshot being drawn rather than by the game logic.
+static int s_bgTick = 0;
 
-    HANDLE hFile = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL,
-        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+// After a stall the stars jump rather than replaying every missed tick
+static const int BG_MAX_CATCHUP = 8;
 
-    if (hFile == INVALID_HANDLE_VALUE)
-        return NULL;
+static void Background_Advance(int tick)
+{
+    int steps = tick - s_bgTick;
+    if (steps > BG_MAX_CATCHUP) steps = BG_MAX_CATCHUP;
 
-    DWORD bytesRead = 0;
+    for (int i = 0; i < steps; ++i)
+        Starfield_Update(s_stars);
 
-    DWORD magic = 0;
-    if (!ReadFile(hFile, &magic, sizeof(DWORD), &bytesRead, NULL) ||
-        bytesRead != sizeof(DWORD) ||
-        magic != 0x20534444)
-    {
-        CloseHandle(hFile);
-        return NULL;
-    }
+    s_bgTick = tick;
 
-    DDS_HEADER hdr;
-    if (!ReadFile(hFile, &hdr, sizeof(DDS_HEADER), &bytesRead, NULL) ||
-        bytesRead != sizeof(DDS_HEADER))
-    {
-        CloseHandle(hFile);
-        return NULL;
-    }
+    // Scroll is a pure function of the tick; wrapping in 32 bits is seamless
+    // because (1 << 32) / (texW << 16) is a whole number of texture widths.
+    const DWORD t = (DWORD)tick;
+    s_cloudU0 = (int)(t << 13);
+    s_cloudV0 = (int)(t << 12);
+    s_cloudU1 = (int)(128u - (t << 12));
+    s_cloudV1 = (int)(64u + (t << 13));
+}
 
-    if (hdr.size != 124 || hdr.ddspf.size != 32)
-    {
-        CloseHandle(hFile);
-        return NULL;
-    }
+static void Background_Init()
+{
+    Starfield_Init(s_stars, STAR_COUNT, STARFIELD_GAME, SCREEN_W, SCREEN_H, RngNext());
 
-    const DWORD DDPF_FOURCC = 0x4;
-    const DWORD DDPF_RGB = 0x40;
-    const DWORD DDPF_ALPHAPIXELS = 0x1;
+    if (s_texClouds) { s_texClouds->Release(); s_texClouds = NULL; }
+    s_cloudW = 0;
+    s_cloudH = 0;
 
-    if (hdr.ddspf.flags & DDPF_FOURCC)
-    {
-        CloseHandle(hFile);
-        return NULL;
-    }
+    TexLoad_Info info;
+    s_texClouds = TexLoad_FromDDS(kCloudsDDS, info, TEXLOAD_NO_KEY);
+    s_cloudW = info.w;
+    s_cloudH = info.h;
 
-    if (hdr.ddspf.rgbBitCount != 32 ||
-        (hdr.ddspf.flags & (DDPF_RGB | DDPF_ALPHAPIXELS)) != (DDPF_RGB | DDPF_ALPHAPIXELS) ||
-        hdr.ddspf.rMask != 0x00FF0000 ||
-        hdr.ddspf.gMask != 0x0000FF00 ||
-        hdr.ddspf.bMask != 0x000000FF ||
-        hdr.ddspf.aMask != 0xFF000000)
-    {
-        CloseHandle(hFile);
-        return NULL;
-    }
+    // A DXT4 asset was premultiplied when it was cooked
+    if (info.fmt != TEXFMT_DXT4)
+        Clouds_PrepareTexture(s_texClouds, s_cloudW, s_cloudH);
 
-    int w = (int)hdr.width;
-    int h = (int)hdr.height;
+    s_bgTick = 0;
+    Background_Advance(0);
+}
 
-    if (!IsPow2(w) || !IsPow2(h))
-    {
-        CloseHandle(hFile);
-        return NULL;
-    }
+static void Background_Shutdown()
+{
+    Starfield_Shutdown(s_stars);
 
-    DWORD pixelBytes = (DWORD)(w * h * 4);
+    if (s_texClouds) { s_texClouds->Release(); s_texClouds = NULL; }
+    s_cloudW = s_cloudH = 0;
+}
 
-    BYTE* pixels = (BYTE*)malloc(pixelBytes);
-    if (!pixels)
-    {
-        CloseHandle(hFile);
-        return NULL;
-    }
+// Clouds set up two texture stages themselves, so they go through the render
+// queue as a device pass with this frame's scroll offsets.
+struct CloudsPass
+{
+    CloudLayer haze;
+    CloudLayer wisps;
+};
 
-    if (!ReadFile(hFile, pixels, pixelBytes, &bytesRead, NULL) ||
-        bytesRead != pixelBytes)
-    {
-        free(pixels);
-        CloseHandle(hFile);
-        return NULL;
-    }
+static void DrawCloudsPass(const void* data)
+{
+    const CloudsPass& p = *(const CloudsPass*)data;
 
-    CloseHandle(hFile);
+    // Both layers in one pass (clouds.h)
+    Clouds_Render(s_texClouds, s_cloudW, s_cloudH, p.haze, p.wisps);
 
-    LPDIRECT3DTEXTURE8 tex = NULL;
-    if (FAILED(g_pDevice->CreateTexture((UINT)w, (UINT)h, 1, 0, D3DFMT_A8R8G8B8, 0, &tex)))
-    {
-        free(pixels);
-        return NULL;
-    }
+    Prepare2D();
+}
 
-    D3DLOCKED_RECT lr;
-    if (FAILED(tex->LockRect(0, &lr, NULL, 0)))
-    {
-        tex->Release();
-        free(pixels);
-        return NULL;
-    }
+static void RenderClouds()
+{
+    if (s_cloudW <= 0 || s_cloudH <= 0) return;
 
-    XGSwizzleRect(pixels, w * 4, NULL, lr.pBits, w, h, NULL, 4);
+    CloudsPass p;
 
-    tex->UnlockRect(0);
-    free(pixels);
+    // Tint + stronger alpha so the "dust/nebula" actually reads
+    p.haze.u = (float)s_cloudU0 / (float)(s_cloudW << 16);
+    p.haze.v = (float)s_cloudV0 / (float)(s_cloudH << 16);
+    p.haze.tint = D3DCOLOR_ARGB(35, 80, 110, 255);      // bluish base haze
 
-    outW = w;
-    outH = h;
-    return tex;
+    p.wisps.u = (float)s_cloudU1 / (float)(s_cloudW << 16);
+    p.wisps.v = (float)s_cloudV1 / (float)(s_cloudH << 16);
+    p.wisps.tint = D3DCOLOR_ARGB(60, 200, 120, 255);    // purple-ish highlight wisps
+    if (!Quality_CloudWisps()) p.wisps.tint = 0;        // shed first under load
+
+    RQ_PushPass(DrawCloudsPass, &p, sizeof(p));
 }
 
 // ------------------------------
-// Background: starfield + clouds overlay
+// Explosions (particles.h)
 // ------------------------------
-static const int STAR_COUNT = 96;
+// The game logic only queues bursts: what blew up and where. Particles are
+// cosmetic, so like the background they are spawned and moved on the render
+// side. Bursts go through a ring and the snapshot carries how many have been
+// queued, so none are lost when the renderer skips a snapshot. The tick side
+// is never more than a few ticks (a few bursts) ahead, far short of the ring.
+enum BurstKind
+{
+    BURST_INVADER = 0,
+    BURST_UFO,
+    BURST_PLAYER,
+    BURST_SHIELD,
 
-static int  s_starX[STAR_COUNT];
-static int  s_starY[STAR_COUNT];
-static int  s_starSpd[STAR_COUNT];   // 1..3
-static BYTE s_starB[STAR_COUNT];     // brightness
+    BURST_KIND_COUNT
+};
 
-static LPDIRECT3DTEXTURE8 s_texClouds = NULL;
-static int  s_cloudW = 0;
-static int  s_cloudH = 0;
+struct Burst
+{
+    short    x, y;              // top-left of the sprite that blew up
+    BurstKind kind;
+    SpriteId sprite;
+};
 
-// UV scroll accumulators
-static int s_cloudU0 = 0;
-static int s_cloudV0 = 0;
-static int s_cloudU1 = 0;
-static int s_cloudV1 = 0;
+struct BurstStyle
+{
+    ParticleStyle debris;       // one particle per lit sprite pixel
+    ParticleStyle sparks;
+    int   sparkCount;
+    DWORD sparkColor;           // 0x00RRGGBB
+};
 
-static void Background_Init()
+static const BurstStyle kBurstStyle[BURST_KIND_COUNT] =
 {
-    for (int i = 0; i < STAR_COUNT; ++i)
-    {
-        s_starX[i] = RngRange(0, SCREEN_W - 1);
-        s_starY[i] = RngRange(0, SCREEN_H - 1);
-        s_starSpd[i] = RngRange(1, 3);
+    { { 1.6f, 0.5f, 24, 48 }, { 3.0f, 0.3f, 12, 30 },  24, 0xFFFFFF },    // invader
+    { { 2.2f, 0.8f, 40, 70 }, { 4.5f, 0.5f, 20, 50 },  96, 0xFF4040 },    // UFO
+    { { 2.0f, 1.0f, 50, 90 }, { 5.0f, 0.5f, 30, 80 }, 160, 0xFFD040 },    // player
+    { { 1.0f, 0.4f, 16, 32 }, { 2.0f, 0.3f,  8, 20 },  12, 0x60FF60 },    // shield
+};
 
-        int b = RngRange(90, 220);
-        s_starB[i] = (BYTE)b;
-    }
+static const int BURST_RING = 64;
+static Burst s_bursts[BURST_RING];
+static DWORD s_burstsQueued = 0;        // tick side
+static DWORD s_burstsSpawned = 0;       // render side
 
-    if (s_texClouds) { s_texClouds->Release(); s_texClouds = NULL; }
-    s_cloudW = 0;
-    s_cloudH = 0;
+static ParticlePool s_particles;
+static int s_ptTick = 0;
 
-    s_texClouds = LoadTextureFromDDS_Rect(kCloudsDDS, s_cloudW, s_cloudH);
+// Tick side
+static void QueueBurst(BurstKind kind, int x, int y, SpriteId sprite)
+{
+    Burst& b = s_bursts[s_burstsQueued % BURST_RING];
+    b.x = (short)x;
+    b.y = (short)y;
+    b.kind = kind;
+    b.sprite = sprite;
 
-    s_cloudU0 = 0;
-    s_cloudV0 = 0;
-    s_cloudU1 = 128;
-    s_cloudV1 = 64;
+    s_burstsQueued++;
 }
 
-static void Background_Shutdown()
+static void SpawnBurst(const Burst& b)
 {
-    if (s_texClouds) { s_texClouds->Release(); s_texClouds = NULL; }
-    s_cloudW = s_cloudH = 0;
-}
+    if (!s_pack) return;
 
-static void Background_Update()
-{
-    for (int i = 0; i < STAR_COUNT; ++i)
-    {
-        s_starY[i] += s_starSpd[i];
-        if (s_starY[i] >= SCREEN_H)
-        {
-            s_starY[i] -= SCREEN_H;
-            s_starX[i] = RngRange(0, SCREEN_W - 1);
-            if ((RngNext() & 7) == 0) s_starSpd[i] = RngRange(1, 3);
-        }
-    }
+    const BurstStyle& st = kBurstStyle[b.kind];
+    const Sprite4& spr = s_pack->sprites[(uint32_t)b.sprite];
 
-    s_cloudU0 += (1 << 13);
-    s_cloudV0 += (1 << 12);
-    s_cloudU1 -= (1 << 12);
-    s_cloudV1 += (1 << 13);
+    Particles_Shatter(s_particles, *s_pack, b.sprite, (float)b.x, (float)b.y, SPR_SCALE, st.debris);
+    Particles_Sparks(s_particles,
+        (float)(b.x + spr.w * SPR_SCALE / 2), (float)(b.y + spr.h * SPR_SCALE / 2),
+        st.sparkCount, st.sparkColor, st.sparks);
 }
 
-static void RenderStars()
+// Render side: spawns the bursts queued up to `queued`, then moves the
+// particles on to `tick` (capped like the background after a stall).
+static void Explosions_Advance(DWORD queued, int tick)
 {
-    // Local anim counter so we don't depend on any external s_frame.
-    static int s_starAnim = 0;
-    s_starAnim++;
+    const LONGLONG t0 = SimClock_Now();
 
-    for (int i = 0; i < STAR_COUNT; ++i)
-    {
-        int bb = (int)s_starB[i];
+    // Only possible after a very long stall: the oldest were overwritten
+    if (queued - s_burstsSpawned > (DWORD)BURST_RING)
+        s_burstsSpawned = queued - BURST_RING;
 
-        // tiny twinkle on a subset (no RNG)
-        if ((i & 7) == 0)
-        {
-            int t = (s_starAnim + i * 13) & 31;    // 0..31
-            int wobble = (t < 16) ? t : (31 - t);  // 0..15 triangle wave
-            bb += wobble * 2;
-            if (bb > 255) bb = 255;
-        }
+    Particles_SetBudget(s_particles, Quality_ParticleBudget(s_particles.capacity));
 
-        BYTE b = (BYTE)bb;
+    for (; s_burstsSpawned != queued; ++s_burstsSpawned)
+        SpawnBurst(s_bursts[s_burstsSpawned % BURST_RING]);
 
-        DrawRect(s_starX[i], s_starY[i], 1, 1, D3DCOLOR_XRGB(b, b, b));
+    int steps = tick - s_ptTick;
+    if (steps > BG_MAX_CATCHUP) steps = BG_MAX_CATCHUP;
 
-        if ((i & 15) == 0)
-        {
-            int x = s_starX[i];
-            int y = s_starY[i];
-            DrawRect(x, y, 2, 1, D3DCOLOR_XRGB(b, b, b));
-        }
+    for (int i = 0; i < steps; ++i)
+        Particles_Update(s_particles);
 
-        // "dust" stars (bigger points)
-        if ((i & 23) == 0)
-        {
-            int x = s_starX[i] - 1;
-            int y = s_starY[i] - 1;
-            DrawRect(x, y, 3, 3, D3DCOLOR_XRGB(b, b, b));
-        }
-    }
+    s_ptTick = tick;
+
+    Perf_Add(PERF_PARTICLE_UPDATE_US, SimClock_MicrosSince(t0));
 }
 
-static void DrawCloudLayer(LPDIRECT3DTEXTURE8 tex, int tw, int th, int uFix, int vFix, BYTE alpha, bool additive)
+static void Explosions_Init()
 {
-    if (!g_pDevice || !tex || tw <= 0 || th <= 0) return;
+    // Own seed: explosions mustn't change what the game's RNG deals out
+    Particles_Init(s_particles, PARTICLES_MAX, SCREEN_W, SCREEN_H, 0x5EEDB007u);
 
-    float u0 = (float)uFix / (float)(tw << 16);
-    float v0 = (float)vFix / (float)(th << 16);
+    s_burstsQueued = 0;
+    s_burstsSpawned = 0;
+    s_ptTick = 0;
+}
+
+static void Explosions_Shutdown()
+{
+    Particles_Shutdown(s_particles);
+}
 
-    float uSpan = (float)SCREEN_W / (float)tw;
-    float vSpan = (float)SCREEN_H / (float)th;
+// Thousands of particles would crowd the render queue's arena and they blend
+// additively, so they are a device pass of their own: built straight into one
+// vertex array and drawn PARTICLE_DRAW_QUADS at a time (normally one draw).
+static const int PARTICLE_DRAW_QUADS = 2048;
+static ParticleVertex s_ptVerts[PARTICLE_DRAW_QUADS * 4];
 
-    float u1 = u0 + uSpan;
-    float v1 = v0 + vSpan;
+static void DrawParticlesPass(const void*)
+{
+    const LONGLONG t0 = SimClock_Now();
+    const float view = Batch_ViewScale();
 
-    // Tint + stronger additive so the "dust/nebula" actually reads
-    BYTE r = 255, g = 255, b = 255;
+    Prepare2D();
+    RS_SetRenderState(D3DRS_ALPHABLENDENABLE, TRUE);
+    RS_SetRenderState(D3DRS_SRCBLEND, D3DBLEND_SRCALPHA);
+    RS_SetRenderState(D3DRS_DESTBLEND, D3DBLEND_ONE);
 
-    if (additive)
-    {
-        r = 200; g = 120; b = 255;   // purple-ish highlight wisps
-        if (alpha < 60) alpha = 60;
-    }
-    else
+    int n = 0;
+    for (int first = 0; first < s_particles.count; first += n)
     {
-        r = 80; g = 110; b = 255;    // bluish base haze
-        if (alpha < 35) alpha = 35;
-    }
+        n = Particles_BuildQuads(s_particles, first, s_ptVerts, PARTICLE_DRAW_QUADS,
+            (float)SPR_SCALE, view);
+        if (n <= 0) break;
 
-    DWORD col = D3DCOLOR_ARGB(alpha, r, g, b);
+        DrawRec_DrawPrimitiveUP(D3DPT_QUADLIST, (UINT)n, s_ptVerts, sizeof(ParticleVertex));
+        Perf_Add(PERF_DRAW_CALLS, 1);
+    }
 
-    V2DTex v[4];
-    v[0].x = 0.0f;            v[0].y = 0.0f;            v[0].z = 0.0f; v[0].rhw = 1.0f; v[0].color = col; v[0].u = u0; v[0].v = v0;
-    v[1].x = (float)SCREEN_W; v[1].y = 0.0f;            v[1].z = 0.0f; v[1].rhw = 1.0f; v[1].color = col; v[1].u = u1; v[1].v = v0;
-    v[2].x = 0.0f;            v[2].y = (float)SCREEN_H; v[2].z = 0.0f; v[2].rhw = 1.0f; v[2].color = col; v[2].u = u0; v[2].v = v1;
-    v[3].x = (float)SCREEN_W; v[3].y = (float)SCREEN_H; v[3].z = 0.0f; v[3].rhw = 1.0f; v[3].color = col; v[3].u = u1; v[3].v = v1;
+    Prepare2D();
 
-    Prepare2DTextured(additive, true, D3DTEXF_LINEAR);
-    g_pDevice->SetTexture(0, tex);
-    g_pDevice->DrawPrimitiveUP(D3DPT_TRIANGLESTRIP, 2, v, sizeof(V2DTex));
+    Perf_Add(PERF_PARTICLES, (DWORD)s_particles.count);
+    Perf_Add(PERF_PARTICLE_DRAW_US, SimClock_MicrosSince(t0));
+}
 
-    Prepare2D();
+static void RenderParticles()
+{
+    if (s_particles.count > 0)
+        RQ_PushPass(DrawParticlesPass, NULL, 0);
 }
 
 // ------------------------------
@@ -642,6 +548,8 @@ struct Enemy
 };
 
 static Enemy s_en[EN_ROWS][EN_COLS];
+static int s_enCellX = 0;   // formation spacing (set by ResetWave)
+static int s_enCellY = 0;
 static int s_enDir = 1;
 static int s_enSpeed = 1;
 static int s_enStepTimer = 0;
@@ -658,6 +566,76 @@ static const int SHIELD_TILES_H = 3;
 static int s_shX[SHIELDS];
 static int s_shY[SHIELDS];
 static bool s_shTiles[SHIELDS][SHIELD_TILES_H][SHIELD_TILES_W];  // per-tile alive state
+static const int SHIELD_TILE_TEXELS = 8;
+
+// Drawn shape, owned by the render side: patched from the snapshot's tile
+// masks (Shields_Sync) when tiles die, restamped when a wave revives them.
+static BarrierState s_shSurface[SHIELDS];
+static DWORD s_shShown[SHIELDS];            // tile mask each surface shows
+
+static void Shields_Init()
+{
+    for (int i = 0; i < SHIELDS; ++i)
+    {
+        Barrier_Init(s_shSurface[i], SHIELD_TILES_W * SHIELD_TILE_TEXELS, SHIELD_TILES_H * SHIELD_TILE_TEXELS);
+        Barrier_Clear(s_shSurface[i]);
+        s_shShown[i] = 0;
+    }
+}
+
+static void Shields_Shutdown()
+{
+    for (int i = 0; i < SHIELDS; ++i)
+        Barrier_Shutdown(s_shSurface[i]);
+}
+
+static void KillShieldTile(int i, int tx, int ty)
+{
+    s_shTiles[i][ty][tx] = false;
+
+    const int tileSize = SHIELD_TILE_TEXELS * SPR_SCALE;
+    QueueBurst(BURST_SHIELD, s_shX[i] + tx * tileSize, s_shY[i] + ty * tileSize, SPR_BARRIER_TILE);
+}
+
+// Bit ty * SHIELD_TILES_W + tx per alive tile
+static DWORD ShieldMask(int i)
+{
+    DWORD mask = 0;
+    for (int ty = 0; ty < SHIELD_TILES_H; ++ty)
+        for (int tx = 0; tx < SHIELD_TILES_W; ++tx)
+            if (s_shTiles[i][ty][tx]) mask |= 1u << (ty * SHIELD_TILES_W + tx);
+    return mask;
+}
+
+static void Shields_Sync(const DWORD* masks)
+{
+    for (int i = 0; i < SHIELDS; ++i)
+    {
+        const DWORD want = masks[i];
+        const DWORD have = s_shShown[i];
+        if (want == have) continue;
+
+        BarrierState& b = s_shSurface[i];
+
+        // Tiles came back (new wave): start over. Otherwise cut the dead ones.
+        const bool revived = (want & ~have) != 0;
+        if (revived) Barrier_Clear(b);
+
+        for (int t = 0; t < SHIELD_TILES_W * SHIELD_TILES_H; ++t)
+        {
+            const int x = (t % SHIELD_TILES_W) * SHIELD_TILE_TEXELS;
+            const int y = (t / SHIELD_TILES_W) * SHIELD_TILE_TEXELS;
+            const DWORD bit = 1u << t;
+
+            if (revived && (want & bit) && s_pack)
+                Barrier_Stamp(b, *s_pack, SPR_BARRIER_TILE, x, y);
+            else if (!revived && (have & bit) && !(want & bit))
+                Barrier_Erase(b, x, y, SHIELD_TILE_TEXELS, SHIELD_TILE_TEXELS);
+        }
+
+        s_shShown[i] = want;
+    }
+}
 
 // UI
 static bool s_showReady = true;
@@ -673,6 +651,18 @@ static bool s_goSubmitted = false;
 static char s_goInitials[4] = { 'A','A','A',0 };
 static int  s_goCursor = 0;
 
+// The table is only changed (and saved) on the main thread, which also draws
+// it: the tick side records the request here and the snapshot carries it to
+// Game_Step (SubmitScores).
+static DWORD s_hsSubmitsQueued = 0;     // tick side
+static DWORD s_hsSubmitsDone = 0;       // main thread
+static char  s_hsInitials[4] = { 0 };
+static int   s_hsScore = 0;
+
+// Buttons for the ticks. Polled on the main thread (Game_Step), so the sim
+// thread never reads the pad state PumpInput is writing.
+static volatile LONG s_simButtons = 0;
+
 // ------------------------------
 // Helpers
 // ------------------------------
@@ -700,9 +690,7 @@ static __forceinline void IncLetter(int idx, int delta)
 
 static void BeginGameOverFlow()
 {
-    // Ensure table is loaded (main does it, but safe here too)
-    ScoreHS_Init();
-
+    // Table loaded by main / Game_Init; only read here
     s_goQualifies = ScoreHS_Qualifies(s_score);
     s_goEntryMode = s_goQualifies ? true : false;
     s_goSubmitted = false;
@@ -714,6 +702,13 @@ static void BeginGameOverFlow()
     s_goCursor = 0;
 }
 
+static void QueueScoreSubmit()
+{
+    memcpy(s_hsInitials, s_goInitials, sizeof(s_hsInitials));
+    s_hsScore = s_score;
+    s_hsSubmitsQueued++;
+}
+
 static void ResetWave()
 {
     // Use sprite sizes (scaled) if available
@@ -732,6 +727,8 @@ static void ResetWave()
     const int startY = 80;
     const int cellX = invW + 16;      // spacing
     const int cellY = invH + 10;
+    s_enCellX = cellX;
+    s_enCellY = cellY;
 
     for (int r = 0; r < EN_ROWS; ++r)
     {
@@ -793,7 +790,7 @@ static void ResetWave()
         s_shX[i] = 92 + i * 138;
         s_shY[i] = baseY;
 
-        // Initialize all tiles as alive
+        // Initialize all tiles as alive (the surface follows via Shields_Sync)
         for (int ty = 0; ty < SHIELD_TILES_H; ++ty)
             for (int tx = 0; tx < SHIELD_TILES_W; ++tx)
                 s_shTiles[i][ty][tx] = true;
@@ -847,6 +844,8 @@ static void KillPlayer()
     s_playerDeadTimer = 90;
     s_bulletActive = false;
 
+    QueueBurst(BURST_PLAYER, s_playerX - (s_playerW / 2), s_playerY, SPR_PLAYER);
+
     Sfx_Play(SFX_PLAYER_DEAD, DSBVOLUME_MAX);
 
     // GAME OVER when lives reach 0 (not -1)
@@ -1149,6 +1148,8 @@ static void UpdateBullets()
                     s_bulletActive = false;
                     s_ufoActive = false;
 
+                    QueueBurst(BURST_UFO, ux, uy, SPR_UFO);
+
                     // Random UFO score: 50, 100, 150, 200, 250, or 300 (classic)
                     int ufoScore = ((int)(RngNext() % 6) + 1) * 50;
                     ScoreAdd(ufoScore);
@@ -1170,6 +1171,8 @@ static void UpdateBullets()
                         e.alive = false;
                         s_bulletActive = false;
 
+                        QueueBurst(BURST_INVADER, e.x, e.y, InvaderSprite(e.type));
+
                         int pts = (e.type == 2) ? 30 : (e.type == 1) ? 20 : 10;
                         ScoreAdd(pts);
                         Sfx_Play(SFX_ENEMY_DEATH, DSBVOLUME_MAX);
@@ -1197,7 +1200,7 @@ static void UpdateBullets()
 
                         if (Aabb(bx, by, s_bulletW, s_bulletH, tileX, tileY, tileSize, tileSize))
                         {
-                            s_shTiles[i][ty][tx] = false;  // Destroy this tile
+                            KillShieldTile(i, tx, ty);  // Destroy this tile
                             s_bulletActive = false;
                             Sfx_Play(SFX_HIT, -800);
                             return;
@@ -1255,7 +1258,7 @@ static void UpdateBullets()
 
                     if (Aabb(ebx, eby, s_ebW, s_ebH, tileX, tileY, tileSize, tileSize))
                     {
-                        s_shTiles[s][ty][tx] = false;  // Destroy this tile
+                        KillShieldTile(s, tx, ty);  // Destroy this tile
                         s_ebActive[i] = false;
                         Sfx_Play(SFX_HIT, -800);
                         break;
@@ -1266,42 +1269,561 @@ static void UpdateBullets()
     }
 }
 
-static void RenderHUD()
+// HUD labels only get re-formatted when their value changes
+static TextCacheEntry s_hudScore;
+static TextCacheEntry s_hudLives;
+static TextCacheEntry s_hudWave;
+
+static void DrawHudLabel(TextCacheEntry& e, float x, const char* label, int value)
 {
-    g_pDevice->SetTexture(0, NULL);
-    g_pDevice->SetRenderState(D3DRS_ALPHABLENDENABLE, FALSE);
-    g_pDevice->SetRenderState(D3DRS_ALPHATESTENABLE, FALSE);
-    g_pDevice->SetRenderState(D3DRS_ZENABLE, D3DZB_FALSE);
-    g_pDevice->SetRenderState(D3DRS_CULLMODE, D3DCULL_NONE);
-    g_pDevice->SetRenderState(D3DRS_LIGHTING, FALSE);
-    g_pDevice->SetTextureStageState(0, D3DTSS_COLOROP, D3DTOP_DISABLE);
-    g_pDevice->SetTextureStageState(0, D3DTSS_ALPHAOP, D3DTOP_DISABLE);
-    g_pDevice->SetVertexShader(D3DFVF_XYZRHW | D3DFVF_DIFFUSE);
+    const DWORD white = D3DCOLOR_XRGB(255, 255, 255);
 
-    char line[128];
+    if (TextCache_Draw(e, (DWORD)value, x, 6.0f, 2.0f, white))
+        return;
 
-    DrawHLine(0, 20, SCREEN_W, D3DCOLOR_XRGB(255, 255, 255));
+    char line[64];
+    MakeLabelInt(line, label, value);
+    TextCache_Store(e, (DWORD)value, x, 6.0f, 2.0f, white, line);
+}
+
+// ------------------------------
+// Render interpolation
+// ------------------------------
+// Logic runs in fixed ticks (simclock.h) and rendering usually lands between
+// two of them, so smoothly moving things (player, shots, UFO) are drawn
+// `alpha` of the way from where the previous tick left them. The formation
+// marches in discrete steps on purpose and isn't interpolated.
+struct PrevPos
+{
+    int x, y;
+    bool active;
+};
+
+static PrevPos s_prevPlayer;
+static PrevPos s_prevBullet;
+static PrevPos s_prevEb[ENEMY_BUL_MAX];
+static PrevPos s_prevUfo;
+
+// Moves longer than this in one tick are respawns or wraps: snap, don't slide
+static const int LERP_SNAP = 32;
+
+static __forceinline void Keep(PrevPos& p, int x, int y, bool active)
+{
+    p.x = x;
+    p.y = y;
+    p.active = active;
+}
+
+// Called at the start of every tick
+static void SavePrevious()
+{
+    Keep(s_prevPlayer, s_playerX, s_playerY, true);
+    Keep(s_prevBullet, s_bulletX, s_bulletY, s_bulletActive);
+    Keep(s_prevUfo, s_ufoX, 40, s_ufoActive);
+
+    for (int i = 0; i < ENEMY_BUL_MAX; ++i)
+        Keep(s_prevEb[i], s_ebX[i], s_ebY[i], s_ebActive[i]);
+}
+
+static __forceinline int Lerp(int prev, int cur, float alpha)
+{
+    const int d = cur - prev;
+    if (d > LERP_SNAP || d < -LERP_SNAP) return cur;
+
+    return prev + (int)floorf((float)d * alpha + 0.5f);
+}
+
+static __forceinline int LerpX(const PrevPos& p, int x, float alpha)
+{
+    return p.active ? Lerp(p.x, x, alpha) : x;
+}
+
+static __forceinline int LerpY(const PrevPos& p, int y, float alpha)
+{
+    return p.active ? Lerp(p.y, y, alpha) : y;
+}
+
+// ------------------------------
+// Render snapshots
+// ------------------------------
+// Everything Game_Render draws, copied out at the end of every tick. Snapshots
+// go through a triple buffer: the tick side always has a slot to fill, the
+// render side always has a complete one to draw, and they swap through the
+// middle slot with one interlocked exchange, so neither ever waits or sees a
+// half-written tick (GAME_SIM_THREAD runs them on different threads).
+static const int EN_COUNT = EN_ROWS * EN_COLS;
+
+struct GameSnapshot
+{
+    int      frame;                 // ticks since Game_Init
+    LONGLONG stamp;                 // SimClock_Now() when published
+
+    // Moving things, with where they were a tick earlier
+    int     playerX, playerY, playerDeadTimer;
+    PrevPos prevPlayer;
+    bool    bulletActive;
+    int     bulletX, bulletY;
+    PrevPos prevBullet;
+    bool    ebActive[ENEMY_BUL_MAX];
+    int     ebX[ENEMY_BUL_MAX], ebY[ENEMY_BUL_MAX];
+    PrevPos prevEb[ENEMY_BUL_MAX];
+    bool    ufoActive;
+    int     ufoX;
+    PrevPos prevUfo;
+
+    // Formation: bit r * EN_COLS + c
+    uint64_t enAlive;
+    short    enX[EN_COUNT], enY[EN_COUNT];
+    BYTE     enType[EN_COUNT];
+    SpriteId invSprite[3];          // current animation frame per type
+
+    int   shX[SHIELDS], shY[SHIELDS];
+    DWORD shTiles[SHIELDS];         // ShieldMask
+
+    // Sizes the tick side owns (Game_Init, ResetWave)
+    int playerW, bulletW, ebW;
+    int enCellX, enCellY;
+
+    DWORD bursts;                   // explosions queued so far (QueueBurst)
+
+    // High-score submits requested so far, and the latest one
+    DWORD hsSubmits;
+    char  hsInitials[4];
+    int   hsScore;
+
+    // HUD / overlays
+    int  score, lives, level;
+    bool showReady, gameOver;
+    bool goEntryMode, goSubmitted;
+    char goInitials[4];
+    int  goCursor;
+};
+
+static GameSnapshot s_snaps[3];
+
+// Slot indices; SNAP_FRESH on the middle one means render hasn't taken it yet
+static const LONG SNAP_FRESH = 4;
+static int s_snapWrite = 0;                 // tick side
+static int s_snapRead = 1;                  // render side
+static volatile LONG s_snapMiddle = 2;
+
+static void PublishSnapshot()
+{
+    GameSnapshot& s = s_snaps[s_snapWrite];
+
+    s.frame = s_frame;
+    s.stamp = SimClock_Now();
+
+    s.playerX = s_playerX;
+    s.playerY = s_playerY;
+    s.playerDeadTimer = s_playerDeadTimer;
+    s.prevPlayer = s_prevPlayer;
+    s.bulletActive = s_bulletActive;
+    s.bulletX = s_bulletX;
+    s.bulletY = s_bulletY;
+    s.prevBullet = s_prevBullet;
+    for (int i = 0; i < ENEMY_BUL_MAX; ++i)
+    {
+        s.ebActive[i] = s_ebActive[i];
+        s.ebX[i] = s_ebX[i];
+        s.ebY[i] = s_ebY[i];
+        s.prevEb[i] = s_prevEb[i];
+    }
+    s.ufoActive = s_ufoActive;
+    s.ufoX = s_ufoX;
+    s.prevUfo = s_prevUfo;
+
+    s.enAlive = 0;
+    for (int r = 0; r < EN_ROWS; ++r)
+    {
+        for (int c = 0; c < EN_COLS; ++c)
+        {
+            const Enemy& e = s_en[r][c];
+            const int i = r * EN_COLS + c;
+
+            if (e.alive) s.enAlive |= 1ull << i;
+            s.enX[i] = (short)e.x;
+            s.enY[i] = (short)e.y;
+            s.enType[i] = (BYTE)e.type;
+        }
+    }
+    for (int t = 0; t < 3; ++t)
+        s.invSprite[t] = InvaderSprite(t);
+
+    for (int i = 0; i < SHIELDS; ++i)
+    {
+        s.shX[i] = s_shX[i];
+        s.shY[i] = s_shY[i];
+        s.shTiles[i] = ShieldMask(i);
+    }
+
+    s.playerW = s_playerW;
+    s.bulletW = s_bulletW;
+    s.ebW = s_ebW;
+    s.enCellX = s_enCellX;
+    s.enCellY = s_enCellY;
+
+    s.bursts = s_burstsQueued;
+
+    s.hsSubmits = s_hsSubmitsQueued;
+    memcpy(s.hsInitials, s_hsInitials, sizeof(s.hsInitials));
+    s.hsScore = s_hsScore;
+
+    s.score = s_score;
+    s.lives = s_lives;
+    s.level = s_level;
+    s.showReady = s_showReady;
+    s.gameOver = s_gameOver;
+    s.goEntryMode = s_goEntryMode;
+    s.goSubmitted = s_goSubmitted;
+    memcpy(s.goInitials, s_goInitials, sizeof(s.goInitials));
+    s.goCursor = s_goCursor;
+
+    s_snapWrite = (int)(InterlockedExchange(&s_snapMiddle, s_snapWrite | SNAP_FRESH) & 3);
+}
+
+// Newest complete snapshot; stays valid until the next call.
+static const GameSnapshot& LatestSnapshot()
+{
+    if (s_snapMiddle & SNAP_FRESH)
+        s_snapRead = (int)(InterlockedExchange(&s_snapMiddle, s_snapRead) & 3);
+
+    return s_snaps[s_snapRead];
+}
+
+static void ResetSnapshots()
+{
+    s_snapWrite = 0;
+    s_snapRead = 1;
+    s_snapMiddle = 2;
+
+    PublishSnapshot();
+}
+
+// ------------------------------
+// Formation impostor
+// ------------------------------
+// Marching is a pure translation (every live invader moves by the same step),
+// so the formation only changes look when an invader dies or an animation
+// frame flips. It is drawn into a render target at 1 texel per sprite pixel on
+// those events only, and put on screen as one quad at the formation origin.
+static RenderTarget s_formRT = { NULL, NULL, 0, 0 };
+static bool     s_formValid = false;
+static uint64_t s_formAlive = 0;            // bit r * EN_COLS + c
+static SpriteId s_formSprite[3];            // current frame per invader type
+static int      s_formCellX = 0;            // cell size in impostor texels
+static int      s_formCellY = 0;
+
+static void Formation_Shutdown()
+{
+    RT_Release(s_formRT);
+    s_formValid = false;
+}
+
+// Sizes the target from the current pack's invader frames; needs ResetWave's
+// cell spacing. Without it Formation_Draw returns false and the caller draws
+// invaders one by one.
+static void Formation_Init()
+{
+    Formation_Shutdown();
+
+    if (!s_pack || !s_pack->animations || s_pack->animCount < 3) return;
+
+    int maxW = 0, maxH = 0;
+    for (int a = ANIM_INVADER_A; a <= ANIM_INVADER_C; ++a)
+    {
+        const SpriteAnim& anim = s_pack->animations[a];
+        for (uint32_t f = 0; f < anim.frameCount; ++f)
+        {
+            const uint32_t id = (uint32_t)anim.frames[f].spriteId;
+            if (id >= s_pack->spriteCount) continue;
+
+            const Sprite4& spr = s_pack->sprites[id];
+            if ((int)spr.w > maxW) maxW = (int)spr.w;
+            if ((int)spr.h > maxH) maxH = (int)spr.h;
+        }
+    }
+
+    s_formCellX = s_enCellX / SPR_SCALE;
+    s_formCellY = s_enCellY / SPR_SCALE;
+
+    const int w = (EN_COLS - 1) * s_formCellX + maxW;
+    const int h = (EN_ROWS - 1) * s_formCellY + maxH;
+
+    RT_Create(s_formRT, w, h, D3DFMT_LIN_A8R8G8B8);
+}
+
+static void Formation_Rebuild(const GameSnapshot& s)
+{
+    if (!RT_Begin(s_formRT, D3DCOLOR_ARGB(0, 0, 0, 0), 1.0f))
+        return;
+
+    for (int r = 0; r < EN_ROWS; ++r)
+    {
+        for (int c = 0; c < EN_COLS; ++c)
+        {
+            const int i = r * EN_COLS + c;
+            if (!(s.enAlive & (1ull << i))) continue;
+
+            DrawSprite4(s_pack, s.invSprite[s.enType[i]], c * s_formCellX, r * s_formCellY, 1);
+        }
+    }
+
+    RT_End();
+
+    s_formValid = true;
+    s_formAlive = s.enAlive;
+    for (int t = 0; t < 3; ++t)
+        s_formSprite[t] = s.invSprite[t];
+
+    Perf_Add(PERF_IMPOSTOR_REBUILDS, 1);
+}
+
+static bool Formation_Draw(const GameSnapshot& s)
+{
+    if (!s_formRT.tex) return false;
+    if (!s.enAlive) return true;
+
+    // Dead invaders stop moving, so take the origin from a live one
+    int first = 0;
+    while (!(s.enAlive & (1ull << first))) ++first;
+
+    const int originX = s.enX[first] - (first % EN_COLS) * s.enCellX;
+    const int originY = s.enY[first] - (first / EN_COLS) * s.enCellY;
+
+    bool stale = !s_formValid || s.enAlive != s_formAlive;
+    for (int t = 0; t < 3 && !stale; ++t)
+        stale = (s_formSprite[t] != s.invSprite[t]);
+
+    if (stale)
+    {
+        Formation_Rebuild(s);
+        if (!s_formValid) return false;
+    }
+
+    Batch_PushQuadUV(s_formRT.tex,
+        (float)originX, (float)originY,
+        (float)(s_formRT.w * SPR_SCALE), (float)(s_formRT.h * SPR_SCALE),
+        0.0f, 0.0f, (float)s_formRT.w, (float)s_formRT.h,
+        D3DCOLOR_ARGB(255, 255, 255, 255));
+    return true;
+}
+
+// ------------------------------
+// Bitplane playfield (GAME_BITPLANE, bitplane.h)
+// ------------------------------
+// Rebuilt in the plane every frame (clearing 9600 bytes and OR-ing in ~80
+// sprites is cheaper than tracking what moved), expanded into an 8-bit alpha
+// texture on upload (there is no 1bpp texture format), and drawn as one quad
+// per run of rows that share an overlay colour, all in one draw.
+#define FVF_PLANE (D3DFVF_XYZRHW | D3DFVF_DIFFUSE | D3DFVF_TEX1)
+
+static Bitplane  s_plane;
+static BitSprite s_planeSprites[SPR_COUNT];
+static DWORD     s_planeRowColor[BITPLANE_H];   // overlay colour per row
+
+// Filled alternately, so the lock never waits for the GPU to finish reading
+// last frame's plane
+static LPDIRECT3DTEXTURE8 s_planeTex[2] = { NULL, NULL };
+static int  s_planeNext = 0;
+static bool s_planeOn = false;                  // entities go to the plane
+
+static __forceinline int ToPlane(int v)
+{
+    // Floor, so sprites partly off the left edge clip instead of jumping
+    return (v >= 0) ? (v / SPR_SCALE) : -((-v + SPR_SCALE - 1) / SPR_SCALE);
+}
+
+// Palette colour covering most of a sprite
+static DWORD SpriteMainColor(SpriteId id)
+{
+    const Sprite4& spr = s_pack->sprites[(uint32_t)id];
+
+    int area[16] = { 0 };
+    int best = 0;
+
+    for (uint16_t i = 0; i < spr.rectCount; ++i)
+    {
+        const SpriteRect& r = spr.rects[i];
+        area[r.color & 15] += r.w * r.h;
+        if (area[r.color & 15] > area[best]) best = r.color & 15;
+    }
+
+    return (DWORD)s_pack->paletteARGB[best] | 0xFF000000;
+}
+
+// Bands like the cabinet's cellophane, each in the colour of what lives
+// there: the UFO's row, the formation, the shields and the player. Invaders
+// that march down into the shield band change colour, as on the arcade.
+static void Playfield_BuildOverlay(const GameSnapshot& s)
+{
+    const DWORD ufo = SpriteMainColor(SPR_UFO);
+    const DWORD invader = SpriteMainColor(SPR_INVADER_A);
+    const DWORD shield = SpriteMainColor(SPR_BARRIER_TILE);
+    const DWORD player = SpriteMainColor(SPR_PLAYER);
+
+    const int ufoEnd = (40 + 16 * SPR_SCALE) / SPR_SCALE;
+    const int shieldTop = s.shY[0] / SPR_SCALE;
+    const int playerTop = s.playerY / SPR_SCALE;
+
+    for (int y = 0; y < BITPLANE_H; ++y)
+    {
+        DWORD c = player;
+        if (y < ufoEnd) c = ufo;
+        else if (y < shieldTop) c = invader;
+        else if (y < playerTop) c = shield;
+
+        s_planeRowColor[y] = c;
+    }
+}
+
+static void Playfield_Shutdown()
+{
+    for (int i = 0; i < 2; ++i)
+    {
+        if (s_planeTex[i]) { s_planeTex[i]->Release(); s_planeTex[i] = NULL; }
+    }
+    s_planeOn = false;
+}
+
+// Takes the player and shield rows from the first snapshot. Without the
+// textures Playfield_Begin returns false and everything is drawn as sprites.
+static void Playfield_Init(const GameSnapshot& s)
+{
+    Playfield_Shutdown();
+
+    if (!GAME_BITPLANE || !g_pDevice || !s_pack) return;
+
+    for (uint32_t i = 0; i < SPR_COUNT && i < s_pack->spriteCount; ++i)
+        BitSprite_FromSprite4(s_planeSprites[i], s_pack->sprites[i]);
+
+    for (int i = 0; i < 2; ++i)
+    {
+        if (FAILED(g_pDevice->CreateTexture(BITPLANE_W, BITPLANE_H, 1, 0, D3DFMT_LIN_A8, 0, &s_planeTex[i])))
+        {
+            s_planeTex[i] = NULL;
+            Playfield_Shutdown();
+            return;
+        }
+    }
+
+    s_planeNext = 0;
+    Playfield_BuildOverlay(s);
+}
+
+static bool Playfield_Begin()
+{
+    s_planeOn = (s_planeTex[0] != NULL);
+    if (s_planeOn) Bitplane_Clear(s_plane);
+    return s_planeOn;
+}
 
-    MakeLabelInt(line, "SCORE ", s_score);
-    DrawText(24.0f, 6.0f, line, 2.0f, D3DCOLOR_XRGB(255, 255, 255));
+// A playfield sprite at 640x480 coordinates: into the plane, or queued
+static void DrawEntity(SpriteId id, int x, int y)
+{
+    if (s_planeOn)
+        Bitplane_Blit(s_plane, s_planeSprites[(uint32_t)id], ToPlane(x), ToPlane(y));
+    else
+        DrawSprite4(s_pack, id, x, y, SPR_SCALE);
+}
+
+static void DrawPlayfieldPass(const void* data)
+{
+    const LPDIRECT3DTEXTURE8 tex = *(const LPDIRECT3DTEXTURE8*)data;
+
+    // Screen pixels per plane pixel (1 inside the arcade framebuffer)
+    const float px = (float)SPR_SCALE * Batch_ViewScale();
+
+    // One quad per run of rows sharing a colour; linear textures take texel UVs
+    static BatchVertex v[BITPLANE_H * 4];
+    int quads = 0;
+
+    for (int y0 = 0; y0 < BITPLANE_H; )
+    {
+        int y1 = y0 + 1;
+        while (y1 < BITPLANE_H && s_planeRowColor[y1] == s_planeRowColor[y0]) ++y1;
+
+        Batch_MakeQuadUV(v + quads * 4,
+            0.0f, (float)y0 * px, (float)BITPLANE_W * px, (float)(y1 - y0) * px,
+            0.0f, (float)y0, (float)BITPLANE_W, (float)y1,
+            s_planeRowColor[y0]);
+
+        ++quads;
+        y0 = y1;
+    }
+
+    Prepare2D();
+
+    // Colour from the overlay, coverage from the plane (0 or 255)
+    RS_SetTexture(0, tex);
+    RS_SetTextureStageState(0, D3DTSS_COLOROP, D3DTOP_SELECTARG1);
+    RS_SetTextureStageState(0, D3DTSS_COLORARG1, D3DTA_DIFFUSE);
+    RS_SetTextureStageState(0, D3DTSS_ALPHAOP, D3DTOP_SELECTARG1);
+    RS_SetTextureStageState(0, D3DTSS_ALPHAARG1, D3DTA_TEXTURE);
+    RS_SetTextureStageState(0, D3DTSS_MAGFILTER, D3DTEXF_POINT);
+    RS_SetTextureStageState(0, D3DTSS_MINFILTER, D3DTEXF_POINT);
+    RS_SetTextureStageState(0, D3DTSS_MIPFILTER, D3DTEXF_NONE);
+    RS_SetTextureStageState(0, D3DTSS_ADDRESSU, D3DTADDRESS_CLAMP);
+    RS_SetTextureStageState(0, D3DTSS_ADDRESSV, D3DTADDRESS_CLAMP);
+
+    RS_SetRenderState(D3DRS_ALPHATESTENABLE, TRUE);
+    RS_SetRenderState(D3DRS_ALPHAREF, 0x80);
+    RS_SetRenderState(D3DRS_ALPHAFUNC, D3DCMP_GREATEREQUAL);
+
+    RS_SetVertexShader(FVF_PLANE);
+
+    DrawRec_DrawPrimitiveUP(D3DPT_QUADLIST, (UINT)quads, v, sizeof(BatchVertex));
+    Perf_Add(PERF_DRAW_CALLS, 1);
+
+    RS_SetRenderState(D3DRS_ALPHATESTENABLE, FALSE);
+    Prepare2D();
+}
+
+// Uploads this frame's plane and queues its draw.
+static void Playfield_End()
+{
+    if (!s_planeOn) return;
+    s_planeOn = false;
+
+    LPDIRECT3DTEXTURE8 tex = s_planeTex[s_planeNext];
+    s_planeNext ^= 1;
+
+    D3DLOCKED_RECT lr;
+    if (FAILED(tex->LockRect(0, &lr, NULL, 0))) return;
+
+    Bitplane_Expand8(s_plane, 0, BITPLANE_H, lr.pBits, lr.Pitch);
+
+    tex->UnlockRect(0);
+    DrawRec_InvalidateTexture(tex);
+
+    RQ_PushPass(DrawPlayfieldPass, &tex, sizeof(tex));
+}
+
+// Queued (see Game_Render); the batch sets its own state when it draws.
+static void RenderHUD(const GameSnapshot& s)
+{
+    RQ_SetLayer(RQ_LAYER_HUD);
+
+    DrawHLine(0, 20, SCREEN_W, D3DCOLOR_XRGB(255, 255, 255));
 
-    MakeLabelInt(line, "LIVES ", (s_lives < 0) ? 0 : s_lives);
-    DrawText(420.0f, 6.0f, line, 2.0f, D3DCOLOR_XRGB(255, 255, 255));
+    DrawHudLabel(s_hudScore, 24.0f, "SCORE ", s.score);
+    DrawHudLabel(s_hudLives, 420.0f, "LIVES ", (s.lives < 0) ? 0 : s.lives);
 
     // Wave number display (top right)
-    MakeLabelInt(line, "WAVE ", s_level);
-    DrawText(540.0f, 6.0f, line, 2.0f, D3DCOLOR_XRGB(255, 255, 255));
+    DrawHudLabel(s_hudWave, 540.0f, "WAVE ", s.level);
 
-    if (s_showReady && !s_gameOver)
+    RQ_SetLayer(RQ_LAYER_OVERLAY);
+
+    if (s.showReady && !s.gameOver)
         DrawCenteredText("GET READY", 240, 3.0f, D3DCOLOR_XRGB(255, 255, 255));
 
     // GAME OVER overlay: big flashing title at top + highscores / initials entry
-    if (s_gameOver)
+    if (s.gameOver)
     {
-        DWORD flash = (((s_frame / 10) & 1) == 0) ? D3DCOLOR_XRGB(255, 60, 60) : D3DCOLOR_XRGB(255, 210, 0);
+        DWORD flash = (((s.frame / 10) & 1) == 0) ? D3DCOLOR_XRGB(255, 60, 60) : D3DCOLOR_XRGB(255, 210, 0);
         DrawCenteredText("GAME OVER", 44, 5.0f, flash);
 
-        if (s_goEntryMode && !s_goSubmitted)
+        if (s.goEntryMode && !s.goSubmitted)
         {
             DrawCenteredText("NEW HIGH SCORE!", 118, 3.0f, D3DCOLOR_XRGB(255, 0, 255));
             DrawCenteredText("ENTER INITIALS", 156, 2.5f, D3DCOLOR_XRGB(255, 255, 255));
@@ -1309,11 +1831,11 @@ static void RenderHUD()
             // Initials display with cursor highlight
             char iniLine[32];
             iniLine[0] = 0;
-            iniLine[0] = s_goInitials[0];
+            iniLine[0] = s.goInitials[0];
             iniLine[1] = ' ';
-            iniLine[2] = s_goInitials[1];
+            iniLine[2] = s.goInitials[1];
             iniLine[3] = ' ';
-            iniLine[4] = s_goInitials[2];
+            iniLine[4] = s.goInitials[2];
             iniLine[5] = 0;
 
             DrawCenteredText(iniLine, 206, 4.0f, D3DCOLOR_XRGB(255, 255, 255));
@@ -1327,7 +1849,7 @@ static void RenderHUD()
             const int baseX = (SCREEN_W - totalW) / 2;
 
             // letters are at char indices 0,2,4
-            int charPos = (s_goCursor == 0) ? 0 : (s_goCursor == 1) ? 2 : 4;
+            int charPos = (s.goCursor == 0) ? 0 : (s.goCursor == 1) ? 2 : 4;
             int lx = baseX + charPos * charW;
 
             // underline block under selected letter
@@ -1353,6 +1875,60 @@ static void RenderHUD()
     }
 }
 
+#if GAME_SIM_THREAD
+// ------------------------------
+// Sim thread
+// ------------------------------
+// Runs Game_Update on its own fixed-step clock while the main thread renders
+// snapshots. It ends by itself when the game asks to leave (Game_Step then
+// returns false) or when Game_Shutdown stops it.
+static HANDLE s_simThread = NULL;
+static volatile LONG s_simStop = 0;
+static volatile LONG s_simFinished = 0;
+
+static DWORD WINAPI SimThreadProc(LPVOID)
+{
+    SimClock clock;
+    SimClock_Reset(clock);
+
+    while (!s_simStop)
+    {
+        const int ticks = SimClock_Advance(clock);
+
+        for (int i = 0; i < ticks; ++i)
+        {
+            if (!Game_Update())
+            {
+                InterlockedExchange(&s_simFinished, 1);
+                return 0;
+            }
+        }
+
+        // Nothing due yet: give the render thread the CPU
+        if (ticks == 0)
+            Sleep(1);
+    }
+    return 0;
+}
+
+static void SimThread_Start()
+{
+    s_simStop = 0;
+    s_simFinished = 0;
+    s_simThread = CreateThread(NULL, 0, SimThreadProc, NULL, 0, NULL);
+}
+
+static void SimThread_Stop()
+{
+    if (!s_simThread) return;
+
+    InterlockedExchange(&s_simStop, 1);
+    WaitForSingleObject(s_simThread, INFINITE);
+    CloseHandle(s_simThread);
+    s_simThread = NULL;
+}
+#endif
+
 // ------------------------------
 // Public API
 // ------------------------------
@@ -1379,6 +1955,9 @@ void Game_Init(bool secretMode)
     s_secretMode = Title_IsSecret() ? true : false;
     s_pack = s_secretMode ? &g_packSecret : &g_packClassic;
 
+    // Expanded once per theme; later selections just swap textures
+    Atlas_Select(s_secretMode);
+
     // Initialize sprite animations
     if (s_pack->animations && s_pack->animCount >= 3)
     {
@@ -1399,6 +1978,7 @@ void Game_Init(bool secretMode)
     Sfx_Load(SFX_UFO, kSfxPath_Ufo);
 
     Background_Init();
+    Explosions_Init();
 
     // Place player relative to scaled sprite height
     if (s_pack)
@@ -1413,25 +1993,49 @@ void Game_Init(bool secretMode)
     if (s_playerY > (SCREEN_H - s_playerH - 2))
         s_playerY = (SCREEN_H - s_playerH - 2);
 
+    Shields_Init();
     ResetWave();
+    Formation_Init();
+
+    // Loaded here, on the main thread, before any tick asks about it
+    ScoreHS_Init();
+    s_hsSubmitsQueued = 0;
+    s_hsSubmitsDone = 0;
+    s_simButtons = GetButtons();
+
+    s_animMsCarry = 0;
+    SavePrevious();
+    ResetSnapshots();
+    Playfield_Init(LatestSnapshot());
 
     s_running = true;
+
+#if GAME_SIM_THREAD
+    SimThread_Start();
+#endif
 }
 
 void Game_Shutdown()
 {
+#if GAME_SIM_THREAD
+    SimThread_Stop();
+#endif
+
     Sfx_UnloadAll();
     Background_Shutdown();
+    Explosions_Shutdown();
+    Formation_Shutdown();
+    Playfield_Shutdown();
+    Shields_Shutdown();
     s_running = false;
 }
 
-bool Game_Update()
+// One tick of game logic (see Game_Update)
+static bool Tick()
 {
-    if (!s_running) return false;
-
     s_frame++;
 
-    WORD now = GetButtons();
+    WORD now = (WORD)s_simButtons;
 
     // GAME OVER flow:
     // - If qualifies: enter initials
@@ -1439,9 +2043,6 @@ bool Game_Update()
     // - START: if entering initials, submit/finish; otherwise restart
     if (s_gameOver)
     {
-        // Keep background alive (stars/clouds continue)
-        Background_Update();
-
         // Initials entry
         if (s_goEntryMode && !s_goSubmitted)
         {
@@ -1464,7 +2065,7 @@ bool Game_Update()
                 else
                 {
                     // Submit
-                    ScoreHS_Submit(s_goInitials, s_score);
+                    QueueScoreSubmit();
                     s_goSubmitted = true;
                     s_goEntryMode = false;
                 }
@@ -1472,7 +2073,7 @@ bool Game_Update()
             else if (start)
             {
                 // START also submits immediately
-                ScoreHS_Submit(s_goInitials, s_score);
+                QueueScoreSubmit();
                 s_goSubmitted = true;
                 s_goEntryMode = false;
             }
@@ -1493,10 +2094,8 @@ bool Game_Update()
     }
 
     // Normal gameplay
-    Background_Update();
-
-    // Update sprite animations (assuming 60 FPS, each frame is ~16.67ms)
-    const uint32_t deltaMs = 17;
+    // Update sprite animations by exactly one tick (16 or 17 ms)
+    const uint32_t deltaMs = (uint32_t)SimClock_TickMs(s_animMsCarry);
     s_animInvaderA.Update(deltaMs);
     s_animInvaderB.Update(deltaMs);
     s_animInvaderC.Update(deltaMs);
@@ -1510,91 +2109,170 @@ bool Game_Update()
     return true;
 }
 
-void Game_Render()
+bool Game_Update()
+{
+    if (!s_running) return false;
+
+    SavePrevious();
+    const bool keepGoing = Tick();
+    PublishSnapshot();
+
+    return keepGoing;
+}
+
+// Carries out the high-score submits the ticks asked for (main thread only).
+// Submits happen once per game, so only the newest one can be pending.
+static void SubmitScores(const GameSnapshot& s)
+{
+    if (s.hsSubmits == s_hsSubmitsDone) return;
+
+    ScoreHS_Submit(s.hsInitials, s.hsScore);
+    s_hsSubmitsDone = s.hsSubmits;
+}
+
+bool Game_Step(int ticks)
+{
+    InterlockedExchange(&s_simButtons, (LONG)GetButtons());
+
+#if GAME_SIM_THREAD
+    if (s_simThread)
+    {
+        (void)ticks;
+
+        // Read first: the final snapshot is published before this is set
+        const bool finished = (s_simFinished != 0);
+        SubmitScores(LatestSnapshot());
+        return s_running && !finished;
+    }
+#endif
+
+    bool keepGoing = true;
+    for (int i = 0; i < ticks && keepGoing; ++i)
+        keepGoing = Game_Update();
+
+    SubmitScores(LatestSnapshot());
+    return keepGoing;
+}
+
+void Game_Render(float alpha)
 {
     if (!g_pDevice) return;
 
+    const GameSnapshot& s = LatestSnapshot();
+
+#if GAME_SIM_THREAD
+    // Ticks run on their own clock: place rendering after the snapshot's tick
+    if (s_simThread)
+    {
+        alpha = SimClock_TicksSince(s.stamp);
+        if (alpha > 1.0f) alpha = 1.0f;
+    }
+#endif
+
+    // Render-side state catches up with the snapshot
+    Background_Advance(s.frame);
+    Explosions_Advance(s.bursts, s.frame);
+    Shields_Sync(s.shTiles);
+
     Prepare2D();
 
+    // Everything below is recorded and drawn sorted at RQ_End (rqueue.h):
+    // same-texture sprites share a flush whatever order they're issued in.
+    RQ_Begin();
+
     // Background: stars + dust/nebula overlay
-    RenderStars();
-    DrawCloudLayer(s_texClouds, s_cloudW, s_cloudH, s_cloudU0, s_cloudV0, 30, false);
-    DrawCloudLayer(s_texClouds, s_cloudW, s_cloudH, s_cloudU1, s_cloudV1, 18, true);
+    RQ_SetLayer(RQ_LAYER_BACKGROUND);
+    Starfield_SetDensity(s_stars, Quality_StarPercent());
+    Starfield_Render(s_stars, false);
+    RenderClouds();
+
+    RQ_SetLayer(RQ_LAYER_ENTITIES);
+
+    // Playfield into the bitplane (GAME_BITPLANE), or sprites as usual
+    const bool plane = Playfield_Begin();
 
     // UFO (sprite)
-    if (s_ufoActive)
-        DrawSprite4(s_pack, SPR_UFO, s_ufoX, 40, SPR_SCALE);
+    if (s.ufoActive)
+        DrawEntity(SPR_UFO, LerpX(s.prevUfo, s.ufoX, alpha), 40);
 
-    // Enemies (sprites with animation)
-    for (int r = 0; r < EN_ROWS; ++r)
+    // Enemies: one impostor quad, or every invader if there is no impostor
+    if (plane || !Formation_Draw(s))
     {
-        for (int c = 0; c < EN_COLS; ++c)
+        for (int i = 0; i < EN_COUNT; ++i)
         {
-            const Enemy& e = s_en[r][c];
-            if (!e.alive) continue;
+            if (!(s.enAlive & (1ull << i))) continue;
 
-            // Get animated sprite based on enemy type
-            SpriteId sid = SPR_INVADER_C;
-            if (e.type == 2)
-                sid = s_animInvaderA.GetCurrentSprite();
-            else if (e.type == 1)
-                sid = s_animInvaderB.GetCurrentSprite();
-            else
-                sid = s_animInvaderC.GetCurrentSprite();
-
-            DrawSprite4(s_pack, sid, e.x, e.y, SPR_SCALE);
+            DrawEntity(s.invSprite[s.enType[i]], s.enX[i], s.enY[i]);
         }
     }
 
-    // Shields (barrier tiles, only draw alive tiles)
+    // Shields: one quad each, or the alive tiles if the surface is missing
     const int tile = 8 * SPR_SCALE;
 
     for (int i = 0; i < SHIELDS; ++i)
     {
+        if (!plane && Barrier_Draw(s_shSurface[i], s.shX[i], s.shY[i], SPR_SCALE)) continue;
+
         for (int ty = 0; ty < SHIELD_TILES_H; ++ty)
         {
             for (int tx = 0; tx < SHIELD_TILES_W; ++tx)
             {
-                if (!s_shTiles[i][ty][tx]) continue;  // Skip destroyed tiles
+                if (!(s.shTiles[i] & (1u << (ty * SHIELD_TILES_W + tx)))) continue;  // Skip destroyed tiles
 
-                DrawSprite4(s_pack, SPR_BARRIER_TILE, s_shX[i] + tx * tile, s_shY[i] + ty * tile, SPR_SCALE);
+                DrawEntity(SPR_BARRIER_TILE, s.shX[i] + tx * tile, s.shY[i] + ty * tile);
             }
         }
     }
 
     // Player (sprite + blink while dead timer)
-    if (!s_gameOver)
+    if (!s.gameOver)
     {
         bool drawPlayer = true;
-        if (s_playerDeadTimer > 0)
-            drawPlayer = (((s_playerDeadTimer / 6) & 1) == 0) ? true : false;
+        if (s.playerDeadTimer > 0)
+            drawPlayer = (((s.playerDeadTimer / 6) & 1) == 0) ? true : false;
 
         if (drawPlayer)
         {
-            int px = s_playerX - (s_playerW / 2);
-            DrawSprite4(s_pack, SPR_PLAYER, px, s_playerY, SPR_SCALE);
+            int px = LerpX(s.prevPlayer, s.playerX, alpha) - (s.playerW / 2);
+            DrawEntity(SPR_PLAYER, px, s.playerY);
         }
     }
 
     // Player bullet (sprite)
-    if (s_bulletActive)
-        DrawSprite4(s_pack, SPR_PLAYER_BULLET, s_bulletX - (s_bulletW / 2), s_bulletY, SPR_SCALE);
+    if (s.bulletActive)
+        DrawEntity(SPR_PLAYER_BULLET,
+            LerpX(s.prevBullet, s.bulletX, alpha) - (s.bulletW / 2),
+            LerpY(s.prevBullet, s.bulletY, alpha));
 
     // Enemy bullets (cycle sprites per slot)
     for (int i = 0; i < ENEMY_BUL_MAX; ++i)
     {
-        if (!s_ebActive[i]) continue;
+        if (!s.ebActive[i]) continue;
 
         SpriteId bid = SPR_EBULLET_ZIG;
         if ((i % 3) == 1) bid = SPR_EBULLET_PLUNGER;
         else if ((i % 3) == 2) bid = SPR_EBULLET_ROLL;
 
-        DrawSprite4(s_pack, bid, s_ebX[i] - (s_ebW / 2), s_ebY[i], SPR_SCALE);
+        DrawEntity(bid,
+            LerpX(s.prevEb[i], s.ebX[i], alpha) - (s.ebW / 2),
+            LerpY(s.prevEb[i], s.ebY[i], alpha));
     }
 
+    // Ground line (part of the playfield when there is a plane)
+    if (plane)
+        Bitplane_Fill(s_plane, 0, (SCREEN_H - 60) / SPR_SCALE, BITPLANE_W, 1);
+
+    Playfield_End();
+
+    // Explosion debris over everything it came from
+    RenderParticles();
+
     // Ground line
-    DrawHLine(0, SCREEN_H - 60, SCREEN_W, D3DCOLOR_XRGB(80, 255, 80));
+    if (!plane)
+        DrawHLine(0, SCREEN_H - 60, SCREEN_W, D3DCOLOR_XRGB(80, 255, 80));
 
     // HUD / text (includes game over overlay now)
-    RenderHUD();
+    RenderHUD(s);
+
+    RQ_End();
 }
\ No newline at end of file
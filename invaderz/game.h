@@ -4,14 +4,47 @@
 //
 // Usage:
 //   Game_Init(secretMode);
-//   while (Game_Update()) { Game_Render(); }
+//   while (Game_Step(ticks)) { Game_Render(alpha); }   // once per frame
 //   Game_Shutdown();
+//
+// Game_Update advances exactly one fixed tick (1/SIM_TICK_HZ s, simclock.h);
+// all game timers count ticks. Every tick ends by publishing a snapshot of
+// what is on screen (positions, alive masks, HUD values), and Game_Render
+// only ever draws the latest snapshot, never the live game state.
+//
+// With GAME_SIM_THREAD set, Game_Init starts a thread that runs the ticks on
+// its own clock and Game_Step just reports whether it is still going, so
+// logic and drawing overlap. Either way Game_Step, on the main thread, hands
+// the ticks this frame's buttons and carries out high-score submits, so the
+// pad state and the table are only ever touched there. Off by default: the Xbox has one core, and the
+// single-threaded loop is the reference.
+
+#ifndef GAME_SIM_THREAD
+#define GAME_SIM_THREAD 0
+#endif
+
+// With GAME_BITPLANE set, the playfield (invaders, UFO, shields, player,
+// bullets, ground line) is drawn arcade style: every sprite is OR-ed into a
+// 1bpp bitplane (bitplane.h), which is uploaded once per frame and put on
+// screen as one draw, coloured by a fixed per-row palette strip like the
+// cabinet's overlay. Sprites lose their own colours. Off by default.
+#ifndef GAME_BITPLANE
+#define GAME_BITPLANE 0
+#endif
 
 // secretMode is latched from Title before Title_Shutdown().
 void Game_Init(bool secretMode);
 void Game_Shutdown();
 
-// Returns false when the game loop should exit back to caller (e.g., START to quit).
+// Runs one tick. Returns false when the game loop should exit back to caller
+// (e.g., START to quit).
 bool Game_Update();
 
-void Game_Render();
+// Runs `ticks` updates (or, with the sim thread, ignores it). Returns false
+// once the game wants to exit.
+bool Game_Step(int ticks);
+
+// alpha in [0, 1): how far rendering is past the last tick; moving sprites are
+// drawn that far from their previous tick's position towards the current one.
+// The sim thread build works this out from the snapshot's timestamp instead.
+void Game_Render(float alpha);
@@ -10,10 +10,19 @@
 #include <string.h>
 
 #include "input.h"
+#include "font.h"
 #include "music.h"
 #include "title.h"
 #include "game.h"
 #include "score.h"
+#include "atlas.h"
+#include "batch.h"
+#include "perf.h"
+#include "rstate.h"
+#include "arcadefb.h"
+#include "drawrec.h"
+#include "simclock.h"
+#include "quality.h"
 
 // Global D3D device used by title.cpp / font.cpp / etc.
 LPDIRECT3DDEVICE8 g_pDevice = NULL;
@@ -22,6 +31,12 @@ static LPDIRECT3D8 s_d3d = NULL;
 static const UINT SCREEN_W = 640;
 static const UINT SCREEN_H = 480;
 
+// Render the game at 320x240 and upscale once (see arcadefb.h). Define to 0
+// to draw straight to the 640x480 back buffer.
+#ifndef USE_ARCADE_FB
+#define USE_ARCADE_FB 1
+#endif
+
 static bool InitD3D()
 {
     s_d3d = Direct3DCreate8(D3D_SDK_VERSION);
@@ -82,9 +97,9 @@ static bool InitD3D()
     g_pDevice->SetViewport(&vp);
 
     // Safe baseline state for 2D
-    g_pDevice->SetRenderState(D3DRS_ZENABLE, D3DZB_FALSE);
-    g_pDevice->SetRenderState(D3DRS_CULLMODE, D3DCULL_NONE);
-    g_pDevice->SetRenderState(D3DRS_LIGHTING, FALSE);
+    RS_SetRenderState(D3DRS_ZENABLE, D3DZB_FALSE);
+    RS_SetRenderState(D3DRS_CULLMODE, D3DCULL_NONE);
+    RS_SetRenderState(D3DRS_LIGHTING, FALSE);
 
     return true;
 }
@@ -120,6 +135,17 @@ int __cdecl main()
     if (!InitD3D())
         return 0;
 
+    // Glyph atlas for DrawText
+    Font_Init();
+
+#if USE_ARCADE_FB
+    ArcadeFB_Init();
+#endif
+
+#if DRAWREC_CAPTURE_FRAMES > 0
+    DrawRec_Start(DRAWREC_PATH, DRAWREC_CAPTURE_FRAMES);
+#endif
+
     // Input
     InitInput();
 
@@ -133,9 +159,16 @@ int __cdecl main()
     // Edge tracking for dashboard exit on Title only
     WORD prevButtons = 0;
 
+    // Logic runs in fixed 60 Hz ticks from here on, independent of the display
+    SimClock clock;
+    SimClock_Reset(clock);
+
     bool running = true;
     while (running)
     {
+        // Update + render time drives the quality governor (quality.h)
+        Quality_BeginFrame();
+
         PumpInput();
 
         // Stream music + handle ramps (must be every frame)
@@ -144,14 +177,14 @@ int __cdecl main()
         WORD nowButtons = GetButtons();
         WORD pressedEdges = (WORD)(nowButtons & (WORD)~prevButtons);
 
+        // Ticks due for the real time since the last frame (0 is fine: the
+        // frame just re-renders further into the current tick).
+        const int ticks = SimClock_Advance(clock);
+
+        DrawRec_BeginFrame();
+
         // Global clear
-        g_pDevice->Clear(
-            0, NULL,
-            D3DCLEAR_TARGET,
-            D3DCOLOR_XRGB(0, 0, 0),
-            1.0f,
-            0
-        );
+        DrawRec_Clear(D3DCOLOR_XRGB(0, 0, 0));
 
         if (state == STATE_TITLE)
         {
@@ -162,8 +195,13 @@ int __cdecl main()
                 // If it returns for any reason, just keep rendering.
             }
 
-            // Title_Update returns true when START edge is detected
-            if (Title_Update())
+            // Title_Update returns true when START edge is detected. Input is
+            // polled once per frame; the first tick consumes its edges.
+            bool start = false;
+            for (int i = 0; i < ticks && !start; ++i)
+                start = Title_Update();
+
+            if (start)
             {
                 // Latch secret mode BEFORE Title_Shutdown (Title may clear its internal flag on shutdown)
                 const bool secretMode = Title_IsSecret();
@@ -173,10 +211,20 @@ int __cdecl main()
 
                 Game_Init(secretMode);
                 state = STATE_GAME;
+                DrawRec_ForgetTextures();
+
+                // Don't replay the time spent loading as game ticks
+                SimClock_Reset(clock);
 
                 // IMPORTANT: skip rendering Title this frame after shutdown
                 prevButtons = nowButtons;
+
+                // The load isn't frame work: keep it away from the governor,
+                // and latch this frame's counters as any other frame does
+                Quality_SkipFrame();
+                DrawRec_EndFrame();
                 g_pDevice->Present(NULL, NULL, NULL, NULL);
+                Perf_EndFrame();
                 continue;
             }
 
@@ -184,35 +232,63 @@ int __cdecl main()
             if (SUCCEEDED(g_pDevice->BeginScene()))
             {
                 Title_Render();
+                Quality_DrawOverlay();
+                Batch_Flush();
                 g_pDevice->EndScene();
             }
         }
         else // STATE_GAME
         {
-            // Game_Update returns false when it wants to exit back to title
-            if (!Game_Update())
+            // False when the game wants to exit back to title (see Game_Step)
+            if (!Game_Step(ticks))
             {
                 Game_Shutdown();
 
                 // Back to title (re-init assets + title music)
                 Title_Init("D:\\tex\\title_classic.dds", "D:\\tex\\title_secret.dds");
                 state = STATE_TITLE;
+                DrawRec_ForgetTextures();
+                SimClock_Reset(clock);
 
                 // reset edge tracking so X doesnt instantly fire on return
                 prevButtons = nowButtons;
+
+                // Same as the title -> game switch above
+                Quality_SkipFrame();
+                DrawRec_EndFrame();
                 g_pDevice->Present(NULL, NULL, NULL, NULL);
+                Perf_EndFrame();
                 continue;
             }
 
             if (SUCCEEDED(g_pDevice->BeginScene()))
             {
-                Game_Render();
+                // Moving things are drawn between their last two ticks
+                const float alpha = SimClock_Alpha(clock);
+
+                if (ArcadeFB_Begin())
+                {
+                    Game_Render(alpha);
+                    ArcadeFB_End();
+                }
+                else
+                {
+                    Game_Render(alpha);
+                }
+                Quality_DrawOverlay();
+                Batch_Flush();
                 g_pDevice->EndScene();
             }
         }
 
+        Quality_EndFrame();
+
+        DrawRec_EndFrame();
         g_pDevice->Present(NULL, NULL, NULL, NULL);
         prevButtons = nowButtons;
+
+        // Latch draw-call / batch counters for this frame (logged in debug)
+        Perf_EndFrame();
     }
 
     // Shutdown
@@ -221,7 +297,11 @@ int __cdecl main()
     else
         Title_Shutdown();
 
+    DrawRec_Stop();
     Music_Shutdown();
+    Atlas_Shutdown();
+    Font_Shutdown();
+    ArcadeFB_Shutdown();
     ShutdownD3D();
     return 0;
 }
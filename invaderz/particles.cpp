@@ -0,0 +1,319 @@
+// particles.cpp
+#include "particles.h"
+
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__SSE__)
+#include <xmmintrin.h>
+#define PARTICLES_SSE 1
+#else
+#define PARTICLES_SSE 0
+#endif
+
+// Unit vectors for spark directions (filled on first Init)
+static const int DIR_COUNT = 64;
+static float s_dirX[DIR_COUNT];
+static float s_dirY[DIR_COUNT];
+static bool s_dirReady = false;
+
+static inline uint32_t PtRngNext(ParticlePool& p)
+{
+    p.rng = p.rng * 1664525u + 1013904223u;
+    return p.rng;
+}
+
+// Uniform in [lo, hi)
+static inline float PtRandF(ParticlePool& p, float lo, float hi)
+{
+    return lo + (hi - lo) * (float)(PtRngNext(p) >> 8) * (1.0f / 16777216.0f);
+}
+
+static inline int PtRandLife(ParticlePool& p, const ParticleStyle& st)
+{
+    const int span = st.lifeMax - st.lifeMin + 1;
+    if (span <= 1) return st.lifeMin;
+    return st.lifeMin + (int)((PtRngNext(p) >> 8) % (uint32_t)span);
+}
+
+static inline int RoundUp4(int v) { return (v + 3) & ~3; }
+
+// ------------------------------
+// Init / shutdown
+// ------------------------------
+bool Particles_Init(ParticlePool& p, int capacity, int width, int height, uint32_t seed)
+{
+    Particles_Shutdown(p);
+
+    if (capacity < 4) capacity = 4;
+    if (capacity > PARTICLES_MAX) capacity = PARTICLES_MAX;
+
+    // Update runs over whole groups of 4, so the arrays are padded to one
+    const int padded = RoundUp4(capacity);
+
+    // x, y, vx, vy, life (floats) + color, each array 16-byte aligned
+    const size_t fBytes = (size_t)padded * sizeof(float);
+    const size_t cBytes = (size_t)padded * sizeof(uint32_t);
+    void* block = malloc(fBytes * 5 + cBytes + 16);
+    if (!block)
+        return false;
+
+    memset(block, 0, fBytes * 5 + cBytes + 16);
+
+    uint8_t* b = (uint8_t*)(((size_t)block + 15) & ~(size_t)15);
+    p.x = (float*)b;             b += fBytes;
+    p.y = (float*)b;             b += fBytes;
+    p.vx = (float*)b;            b += fBytes;
+    p.vy = (float*)b;            b += fBytes;
+    p.life = (float*)b;          b += fBytes;
+    p.color = (uint32_t*)b;
+
+    p.block = block;
+    p.count = 0;
+    p.capacity = capacity;
+    p.budget = capacity;
+    p.gravity = 0.06f;
+    p.drag = 0.975f;
+    p.width = (float)width;
+    p.height = (float)height;
+    p.rng = seed ? seed : 0x2468ACE1u;
+
+    if (!s_dirReady)
+    {
+        for (int i = 0; i < DIR_COUNT; ++i)
+        {
+            const float a = (float)i * (6.2831853f / (float)DIR_COUNT);
+            s_dirX[i] = cosf(a);
+            s_dirY[i] = sinf(a);
+        }
+        s_dirReady = true;
+    }
+
+    return true;
+}
+
+void Particles_Shutdown(ParticlePool& p)
+{
+    if (p.block) free(p.block);
+    memset(&p, 0, sizeof(p));
+}
+
+void Particles_Clear(ParticlePool& p)
+{
+    p.count = 0;
+}
+
+void Particles_SetBudget(ParticlePool& p, int n)
+{
+    if (n < 0) n = 0;
+    if (n > p.capacity) n = p.capacity;
+    p.budget = n;
+}
+
+// ------------------------------
+// Spawning
+// ------------------------------
+bool Particles_Spawn(ParticlePool& p, float x, float y, float vx, float vy, int life, uint32_t rgb)
+{
+    if (p.count >= p.budget || life <= 0) return false;
+
+    const int i = p.count++;
+    p.x[i] = x;
+    p.y[i] = y;
+    p.vx[i] = vx;
+    p.vy[i] = vy;
+    p.life[i] = (float)life;
+    p.color[i] = rgb & 0x00FFFFFFu;
+    return true;
+}
+
+int Particles_Shatter(ParticlePool& p, const SpritePack4& pack, SpriteId id,
+                      float x, float y, int scale, const ParticleStyle& st)
+{
+    if (!p.block || (uint32_t)id >= pack.spriteCount) return 0;
+
+    const Sprite4& spr = pack.sprites[(uint32_t)id];
+    if (!spr.rects || spr.w == 0 || spr.h == 0) return 0;
+
+    // Offsets from the centre in half-sizes: edge pixels get the full speed
+    const float cx = (float)spr.w * 0.5f;
+    const float cy = (float)spr.h * 0.5f;
+    const float sx = st.speed / cx;
+    const float sy = st.speed / cy;
+
+    int spawned = 0;
+
+    for (uint16_t i = 0; i < spr.rectCount; ++i)
+    {
+        const SpriteRect& r = spr.rects[i];
+        const uint32_t rgb = pack.paletteARGB[r.color];
+
+        for (int py = r.y; py < r.y + r.h; ++py)
+        {
+            for (int px = r.x; px < r.x + r.w; ++px)
+            {
+                const float dx = (float)px + 0.5f - cx;
+                const float dy = (float)py + 0.5f - cy;
+                const float kick = PtRandF(p, 0.5f, 1.5f);
+
+                if (!Particles_Spawn(p,
+                        x + (float)(px * scale), y + (float)(py * scale),
+                        dx * sx * kick + PtRandF(p, -st.jitter, st.jitter),
+                        dy * sy * kick + PtRandF(p, -st.jitter, st.jitter),
+                        PtRandLife(p, st), rgb))
+                    return spawned;
+
+                ++spawned;
+            }
+        }
+    }
+
+    return spawned;
+}
+
+int Particles_Sparks(ParticlePool& p, float x, float y, int n, uint32_t rgb, const ParticleStyle& st)
+{
+    if (!p.block) return 0;
+
+    int spawned = 0;
+
+    for (int i = 0; i < n; ++i)
+    {
+        const int d = (int)((PtRngNext(p) >> 8) % (uint32_t)DIR_COUNT);
+        const float v = st.speed * PtRandF(p, 0.3f, 1.0f);
+
+        if (!Particles_Spawn(p, x, y,
+                s_dirX[d] * v + PtRandF(p, -st.jitter, st.jitter),
+                s_dirY[d] * v + PtRandF(p, -st.jitter, st.jitter),
+                PtRandLife(p, st), rgb))
+            break;
+
+        ++spawned;
+    }
+
+    return spawned;
+}
+
+// ------------------------------
+// Update
+// ------------------------------
+void Particles_Update(ParticlePool& p)
+{
+    if (!p.block || p.count == 0) return;
+
+    float* x = p.x;
+    float* y = p.y;
+    float* vx = p.vx;
+    float* vy = p.vy;
+    float* life = p.life;
+
+    // Integrate; particles that left the screen get life 0 here, so the free
+    // pass below only has to look at life.
+#if PARTICLES_SSE
+    const __m128 g = _mm_set1_ps(p.gravity);
+    const __m128 drag = _mm_set1_ps(p.drag);
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 ww = _mm_set1_ps(p.width);
+    const __m128 hh = _mm_set1_ps(p.height);
+
+    // Lanes past `count` are stale; they are moved too and never read
+    const int n = RoundUp4(p.count);
+    for (int i = 0; i < n; i += 4)
+    {
+        const __m128 nvx = _mm_mul_ps(_mm_load_ps(&vx[i]), drag);
+        const __m128 nvy = _mm_add_ps(_mm_mul_ps(_mm_load_ps(&vy[i]), drag), g);
+        const __m128 nx = _mm_add_ps(_mm_load_ps(&x[i]), nvx);
+        const __m128 ny = _mm_add_ps(_mm_load_ps(&y[i]), nvy);
+
+        const __m128 out = _mm_or_ps(
+            _mm_or_ps(_mm_cmplt_ps(nx, zero), _mm_cmpge_ps(nx, ww)),
+            _mm_or_ps(_mm_cmplt_ps(ny, zero), _mm_cmpge_ps(ny, hh)));
+
+        _mm_store_ps(&vx[i], nvx);
+        _mm_store_ps(&vy[i], nvy);
+        _mm_store_ps(&x[i], nx);
+        _mm_store_ps(&y[i], ny);
+        _mm_store_ps(&life[i], _mm_andnot_ps(out, _mm_sub_ps(_mm_load_ps(&life[i]), one)));
+    }
+#else
+    for (int i = 0; i < p.count; ++i)
+    {
+        vx[i] *= p.drag;
+        vy[i] = vy[i] * p.drag + p.gravity;
+        x[i] += vx[i];
+        y[i] += vy[i];
+        life[i] -= 1.0f;
+
+        if (x[i] < 0.0f || x[i] >= p.width || y[i] < 0.0f || y[i] >= p.height)
+            life[i] = 0.0f;
+    }
+#endif
+
+    // Free: walk backwards so the particle moved into a hole (always the last
+    // live one) has already been checked
+    uint32_t* color = p.color;
+    int last = p.count - 1;
+
+    for (int i = last; i >= 0; --i)
+    {
+        if (life[i] > 0.0f) continue;
+
+        x[i] = x[last];
+        y[i] = y[last];
+        vx[i] = vx[last];
+        vy[i] = vy[last];
+        life[i] = life[last];
+        color[i] = color[last];
+        --last;
+    }
+
+    p.count = last + 1;
+}
+
+// ------------------------------
+// Render
+// ------------------------------
+int Particles_BuildQuads(const ParticlePool& p, int first, ParticleVertex* out, int maxQuads,
+                         float size, float scale)
+{
+    if (!p.block || !out || first < 0 || first >= p.count) return 0;
+
+    int n = p.count - first;
+    if (n > maxQuads) n = maxQuads;
+
+    // At least one target pixel, or particles vanish in the arcade framebuffer
+    float s = size * scale;
+    if (s < 1.0f) s = 1.0f;
+
+    const float kFade = 255.0f / (float)PARTICLE_FADE_TICKS;
+
+    for (int i = 0; i < n; ++i)
+    {
+        const int k = first + i;
+        const float x0 = p.x[k] * scale;
+        const float y0 = p.y[k] * scale;
+        const float x1 = x0 + s;
+        const float y1 = y0 + s;
+
+        const float l = p.life[k];
+        const uint32_t a = (l >= (float)PARTICLE_FADE_TICKS) ? 255u : (uint32_t)(l * kFade);
+        const uint32_t c = (a << 24) | p.color[k];
+
+        ParticleVertex* v = out + i * 4;
+        v[0].x = x0; v[0].y = y0;
+        v[1].x = x1; v[1].y = y0;
+        v[2].x = x1; v[2].y = y1;
+        v[3].x = x0; v[3].y = y1;
+
+        for (int j = 0; j < 4; ++j)
+        {
+            v[j].z = 0.0f;
+            v[j].rhw = 1.0f;
+            v[j].color = c;
+        }
+    }
+
+    return n;
+}
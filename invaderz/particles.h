@@ -0,0 +1,93 @@
+#pragma once
+#include <stdint.h>
+
+#include "sprites.h"
+
+// -----------------------------------------------------------------------------
+// Pooled explosion particles (invader, player, UFO and shield debris).
+//
+// A fixed-capacity pool in structure-of-arrays form, carved out of one
+// allocation at init; nothing is allocated afterwards. Live particles are
+// packed at the front:
+//   spawn  append at `count` (dropped when the pool is full)
+//   free   the last live particle moves into the hole
+// so both are O(1) and the update loop never skips dead slots. Update moves
+// four particles at a time with SSE (scalar elsewhere).
+//
+// Portable (no D3D): the game turns the pool into quads with
+// Particles_BuildQuads and draws them itself, tools/hostbench.cpp times it.
+// -----------------------------------------------------------------------------
+
+#define PARTICLES_MAX   4096
+
+// Particles fade out over their last PARTICLE_FADE_TICKS ticks
+#define PARTICLE_FADE_TICKS 16
+
+struct ParticlePool
+{
+    // SoA, 16-byte aligned, carved out of one allocation
+    float*    x;
+    float*    y;
+    float*    vx;
+    float*    vy;
+    float*    life;         // ticks left; <= 0 is dead
+    uint32_t* color;        // 0x00RRGGBB
+
+    int count;              // live particles, packed at the front
+    int capacity;
+    int budget;             // spawns stop at this many (<= capacity)
+
+    float gravity;          // px per tick, added to vy every tick
+    float drag;             // velocity scale per tick
+    float width, height;    // particles leaving this area die
+
+    uint32_t rng;
+    void* block;
+};
+
+// How a burst flies apart (px and ticks at the game's 640x480 scale).
+struct ParticleStyle
+{
+    float speed;            // outward speed at the edge of the sprite
+    float jitter;           // random speed added on each axis
+    int   lifeMin, lifeMax; // ticks
+};
+
+// Same layout as the game's FVF_2D vertex (XYZRHW | DIFFUSE)
+struct ParticleVertex
+{
+    float x, y, z, rhw;
+    uint32_t color;
+};
+
+bool Particles_Init(ParticlePool& p, int capacity, int width, int height, uint32_t seed);
+void Particles_Shutdown(ParticlePool& p);
+
+// Kills every particle.
+void Particles_Clear(ParticlePool& p);
+
+// Caps spawning at `n` live particles (clamped to the capacity). Particles
+// already alive past the cap live out their time. The quality governor
+// (quality.h) lowers it under load.
+void Particles_SetBudget(ParticlePool& p, int n);
+
+// O(1). False (nothing spawned) when the pool is full or over budget.
+bool Particles_Spawn(ParticlePool& p, float x, float y, float vx, float vy, int life, uint32_t rgb);
+
+// Breaks sprite `id` drawn at (x, y) with `scale` into one particle per lit
+// pixel, in the pixel's colour, flying away from the sprite's centre.
+// Returns how many were spawned.
+int Particles_Shatter(ParticlePool& p, const SpritePack4& pack, SpriteId id,
+                      float x, float y, int scale, const ParticleStyle& st);
+
+// `n` particles of one colour from (x, y) in random directions.
+int Particles_Sparks(ParticlePool& p, float x, float y, int n, uint32_t rgb, const ParticleStyle& st);
+
+// Moves every particle one tick and frees the dead ones.
+void Particles_Update(ParticlePool& p);
+
+// Writes up to `maxQuads` quads (4 vertices each, for a QUADLIST) starting at
+// particle `first`: `size` px squares, alpha fading with life, positions and
+// size multiplied by `scale` (the batch's view scale). Returns quads written.
+int Particles_BuildQuads(const ParticlePool& p, int first, ParticleVertex* out, int maxQuads,
+                         float size, float scale);
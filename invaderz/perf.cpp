@@ -0,0 +1,127 @@
+// perf.cpp
+#include "perf.h"
+
+#include <xtl.h>
+
+#include "strfmt.h"
+
+#if defined(_DEBUG)
+#define PERF_LOG 1
+#else
+#define PERF_LOG 0
+#endif
+
+static DWORD s_cur[PERF_COUNTER_COUNT];
+static DWORD s_last[PERF_COUNTER_COUNT];
+static DWORD s_frames = 0;
+
+// Sums over the current / last complete 60-frame window
+static const DWORD PERF_WINDOW = 60;
+static DWORD s_accum[PERF_COUNTER_COUNT];
+static DWORD s_window[PERF_COUNTER_COUNT];
+static DWORD s_peakParticles = 0;
+static DWORD s_windowPeakParticles = 0;
+
+static const char* const kPerfNames[PERF_COUNTER_COUNT] =
+{
+    "draws",
+    "quads",
+    "flushes",
+    "txthit",
+    "txtmiss",
+    "rs_set",
+    "rs_skip",
+    "imp_rebuild",
+    "rq_cmds",
+    "particles",
+    "pt_upd_us",
+    "pt_draw_us",
+};
+
+#if PERF_LOG
+static void LogLatched()
+{
+    char line[320];
+    char* p = StrFmt_Append(line, "perf:");
+
+    for (int i = 0; i < PERF_COUNTER_COUNT; ++i)
+    {
+        p = StrFmt_Append(p, " ");
+        p = StrFmt_Append(p, kPerfNames[i]);
+        p = StrFmt_Append(p, "=");
+        p = StrFmt_AppendUInt(p, s_last[i]);
+    }
+
+    StrFmt_Append(p, "\n");
+    OutputDebugStringA(line);
+
+    p = StrFmt_Append(line, "perf: impostor rebuilds=");
+    p = StrFmt_AppendUInt(p, s_window[PERF_IMPOSTOR_REBUILDS]);
+    p = StrFmt_Append(p, " frames=");
+    p = StrFmt_AppendUInt(p, PERF_WINDOW);
+    StrFmt_Append(p, "\n");
+    OutputDebugStringA(line);
+
+    p = StrFmt_Append(line, "perf: particles update_us=");
+    p = StrFmt_AppendUInt(p, s_window[PERF_PARTICLE_UPDATE_US] / PERF_WINDOW);
+    p = StrFmt_Append(p, " draw_us=");
+    p = StrFmt_AppendUInt(p, s_window[PERF_PARTICLE_DRAW_US] / PERF_WINDOW);
+    p = StrFmt_Append(p, " per frame, peak live=");
+    p = StrFmt_AppendUInt(p, s_windowPeakParticles);
+    StrFmt_Append(p, "\n");
+    OutputDebugStringA(line);
+}
+#endif
+
+// ------------------------------
+// Public API
+// ------------------------------
+void Perf_Add(PerfCounter c, DWORD n)
+{
+    if ((unsigned)c >= (unsigned)PERF_COUNTER_COUNT) return;
+    s_cur[c] += n;
+}
+
+DWORD Perf_Get(PerfCounter c)
+{
+    if ((unsigned)c >= (unsigned)PERF_COUNTER_COUNT) return 0;
+    return s_last[c];
+}
+
+DWORD Perf_GetWindow(PerfCounter c)
+{
+    if ((unsigned)c >= (unsigned)PERF_COUNTER_COUNT) return 0;
+    return s_window[c];
+}
+
+void Perf_EndFrame()
+{
+    for (int i = 0; i < PERF_COUNTER_COUNT; ++i)
+    {
+        s_last[i] = s_cur[i];
+        s_accum[i] += s_cur[i];
+        s_cur[i] = 0;
+    }
+
+    if (s_last[PERF_PARTICLES] > s_peakParticles)
+        s_peakParticles = s_last[PERF_PARTICLES];
+
+    s_frames++;
+
+    if ((s_frames % PERF_WINDOW) == 0)
+    {
+        for (int i = 0; i < PERF_COUNTER_COUNT; ++i)
+        {
+            s_window[i] = s_accum[i];
+            s_accum[i] = 0;
+        }
+
+        s_windowPeakParticles = s_peakParticles;
+        s_peakParticles = 0;
+
+#if PERF_LOG
+        // 60fps -> once a second
+        LogLatched();
+#endif
+    }
+}
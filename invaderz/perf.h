@@ -0,0 +1,42 @@
+#pragma once
+#include <xtl.h>
+
+// -----------------------------------------------------------------------------
+// Per-frame render/perf counters.
+//
+// Usage:
+//   Perf_Add(PERF_DRAW_CALLS, 1);   // anywhere during the frame
+//   Perf_EndFrame();                // once per presented frame (main.cpp)
+//   Perf_Get(PERF_DRAW_CALLS);      // value latched for the last full frame
+//
+// Debug builds print the latched counters once a second (OutputDebugStringA),
+// plus how many of the window's frames needed a formation impostor rebuild
+// and the window's particle update / draw time.
+// -----------------------------------------------------------------------------
+
+enum PerfCounter
+{
+    PERF_DRAW_CALLS = 0,    // DrawPrimitiveUP calls issued this frame
+    PERF_BATCH_QUADS,       // quads submitted through the 2D batch
+    PERF_BATCH_FLUSHES,     // batch flushes that produced a draw
+    PERF_TEXT_HITS,         // text cache entries replayed as-is
+    PERF_TEXT_MISSES,       // text cache entries that had to be re-formatted
+    PERF_STATE_ISSUED,      // state sets that reached the device (rstate.h)
+    PERF_STATE_FILTERED,    // state sets dropped as redundant
+    PERF_IMPOSTOR_REBUILDS, // formation impostor re-rendered (game.cpp)
+    PERF_QUEUE_COMMANDS,    // draws recorded into the render queue (rqueue.h)
+    PERF_PARTICLES,         // live particles drawn (particles.h)
+    PERF_PARTICLE_UPDATE_US,// microseconds spent moving particles
+    PERF_PARTICLE_DRAW_US,  // microseconds spent building + submitting them
+
+    PERF_COUNTER_COUNT
+};
+
+void  Perf_Add(PerfCounter c, DWORD n);
+DWORD Perf_Get(PerfCounter c);
+
+// Total over the last full 60-frame window (~1s), e.g. rebuilds per second.
+DWORD Perf_GetWindow(PerfCounter c);
+
+// Latches this frame's counters and resets them for the next frame.
+void  Perf_EndFrame();
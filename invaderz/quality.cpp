@@ -0,0 +1,238 @@
+// quality.cpp
+#include "quality.h"
+
+#include <xtl.h>
+
+#include "simclock.h"
+#include "font.h"
+#include "strfmt.h"
+
+#if defined(_DEBUG)
+#define QUALITY_LOG 1
+#else
+#define QUALITY_LOG 0
+#endif
+
+// One 60 Hz frame is 16667us. Shed above 90% of it, restore below 65%.
+static const DWORD FRAME_US = 1000000 / SIM_TICK_HZ;
+static const DWORD SHED_US = FRAME_US * 9 / 10;
+static const DWORD RESTORE_US = FRAME_US * 65 / 100;
+
+// A frame interval this long means a vsync was missed
+static const DWORD MISSED_US = FRAME_US * 3 / 2;
+
+static const int SHED_FRAMES = 10;              // over budget in a row
+static const int RESTORE_FRAMES = 180;          // under budget in a row (~3s)
+static const int RESTORE_FRAMES_MAX = 1440;     // after repeated bounces (~24s)
+static const int BOUNCE_FRAMES = 120;           // shed this soon after a restore
+
+// Work time is smoothed over ~8 frames (EMA, weight 1/8)
+static const int SMOOTH_SHIFT = 3;
+
+static int      s_level = 0;
+static DWORD    s_workUs = 0;
+static LONGLONG s_frameStart = 0;
+static DWORD    s_intervalUs = 0;        // since the previous BeginFrame
+static int      s_overFrames = 0;
+static int      s_underFrames = 0;
+static int      s_restoreWait = RESTORE_FRAMES;
+static int      s_sinceRestore = 0x7FFFFFFF;
+
+#if QUALITY_LOG || QUALITY_OVERLAY
+// Microseconds as milliseconds with one decimal
+static char* AppendMs(char* dst, DWORD us)
+{
+    dst = StrFmt_AppendUInt(dst, us / 1000);
+    dst = StrFmt_Append(dst, ".");
+    dst = StrFmt_AppendUInt(dst, (us / 100) % 10);
+    return StrFmt_Append(dst, "MS");
+}
+
+// What level `level` sheds on top of the one below it
+static const char* const kShedNames[QUALITY_LEVEL_MAX + 1] =
+{
+    "",
+    "WISPS",
+    "STARS/2 SHADOWS",
+    "PARTICLES/4",
+    "PARTICLES/16 STARS/4",
+};
+#endif
+
+#if QUALITY_LOG
+static void LogChange(int from, int to)
+{
+    char line[128];
+    char* p = StrFmt_Append(line, "quality: level ");
+    p = StrFmt_AppendUInt(p, (DWORD)from);
+    p = StrFmt_Append(p, " -> ");
+    p = StrFmt_AppendUInt(p, (DWORD)to);
+    p = StrFmt_Append(p, (to > from) ? " shed " : " restored ");
+    p = StrFmt_Append(p, kShedNames[(to > from) ? to : from]);
+    p = StrFmt_Append(p, " work=");
+    p = AppendMs(p, s_workUs);
+    p = StrFmt_Append(p, " restore_wait=");
+    p = StrFmt_AppendUInt(p, (DWORD)s_restoreWait);
+    StrFmt_Append(p, "\n");
+    OutputDebugStringA(line);
+}
+#endif
+
+static void SetLevel(int level)
+{
+    if (level < 0) level = 0;
+    if (level > QUALITY_LEVEL_MAX) level = QUALITY_LEVEL_MAX;
+    if (level == s_level) return;
+
+#if QUALITY_LOG
+    const int from = s_level;
+#endif
+
+    if (level > s_level)
+    {
+        // Came straight back: the restore was premature, wait longer next time
+        if (s_sinceRestore < BOUNCE_FRAMES)
+        {
+            s_restoreWait *= 2;
+            if (s_restoreWait > RESTORE_FRAMES_MAX) s_restoreWait = RESTORE_FRAMES_MAX;
+        }
+    }
+    else
+    {
+        s_sinceRestore = 0;
+    }
+
+    s_level = level;
+    s_overFrames = 0;
+    s_underFrames = 0;
+
+#if QUALITY_LOG
+    LogChange(from, level);
+#endif
+}
+
+// ------------------------------
+// Public API
+// ------------------------------
+void Quality_Reset()
+{
+    s_level = 0;
+    s_workUs = 0;
+    s_frameStart = 0;
+    s_intervalUs = 0;
+    s_overFrames = 0;
+    s_underFrames = 0;
+    s_restoreWait = RESTORE_FRAMES;
+    s_sinceRestore = 0x7FFFFFFF;
+}
+
+void Quality_BeginFrame()
+{
+    s_intervalUs = (s_frameStart != 0) ? SimClock_MicrosSince(s_frameStart) : 0;
+    s_frameStart = SimClock_Now();
+}
+
+void Quality_EndFrame()
+{
+    if (s_frameStart == 0) return;
+
+    const DWORD work = SimClock_MicrosSince(s_frameStart);
+
+    // First frame: start from the measurement rather than from zero
+    if (s_workUs == 0)
+        s_workUs = work;
+    else
+        s_workUs = (DWORD)((LONG)s_workUs + (((LONG)work - (LONG)s_workUs) >> SMOOTH_SHIFT));
+
+    // A long frame-to-frame interval is a missed vsync whatever the CPU
+    // did (the GPU may be the one running late)
+    const bool missed = s_intervalUs > MISSED_US;
+
+    if (s_sinceRestore < 0x7FFFFFFF) s_sinceRestore++;
+
+    // Long stable stretch at the restored level: bounces are forgiven
+    if (s_sinceRestore > RESTORE_FRAMES_MAX)
+        s_restoreWait = RESTORE_FRAMES;
+
+    if (s_workUs > SHED_US || missed)
+    {
+        s_underFrames = 0;
+        if (++s_overFrames >= SHED_FRAMES && s_level < QUALITY_LEVEL_MAX)
+            SetLevel(s_level + 1);
+    }
+    else
+    {
+        s_overFrames = 0;
+        if (s_workUs < RESTORE_US)
+        {
+            if (++s_underFrames >= s_restoreWait && s_level > 0)
+                SetLevel(s_level - 1);
+        }
+        else
+        {
+            s_underFrames = 0;
+        }
+    }
+}
+
+void Quality_SkipFrame()
+{
+    // BeginFrame takes no interval and EndFrame measures nothing without it
+    s_frameStart = 0;
+}
+
+int Quality_Level()
+{
+    return s_level;
+}
+
+DWORD Quality_WorkUs()
+{
+    return s_workUs;
+}
+
+bool Quality_CloudWisps()
+{
+    return s_level < 1;
+}
+
+int Quality_StarPercent()
+{
+    if (s_level >= 4) return 25;
+    if (s_level >= 2) return 50;
+    return 100;
+}
+
+bool Quality_TextShadows()
+{
+    return s_level < 2;
+}
+
+int Quality_ParticleBudget(int capacity)
+{
+    if (s_level >= 4) return capacity / 16;
+    if (s_level >= 3) return capacity / 4;
+    return capacity;
+}
+
+void Quality_DrawOverlay()
+{
+#if QUALITY_OVERLAY
+    char line[96];
+    char* p = StrFmt_Append(line, "Q");
+    p = StrFmt_AppendUInt(p, (DWORD)s_level);
+    p = StrFmt_Append(p, " ");
+    p = AppendMs(p, s_workUs);
+
+    // Levels 3 and 4 cut the same things further: list the deepest cut only
+    for (int l = 1; l <= s_level; ++l)
+    {
+        if (l == 3 && s_level == 4) continue;
+
+        p = StrFmt_Append(p, " -");
+        p = StrFmt_Append(p, kShedNames[l]);
+    }
+
+    DrawText(8.0f, 462.0f, line, 1.5f, (s_level > 0) ? D3DCOLOR_XRGB(255, 160, 0) : D3DCOLOR_XRGB(120, 120, 120));
+#endif
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include <xtl.h>
+
+// -----------------------------------------------------------------------------
+// Adaptive quality governor.
+//
+// main.cpp brackets each frame's update + render with Quality_BeginFrame /
+// Quality_EndFrame (the wait in Present is not work). When the smoothed work
+// time stays over budget, or frames keep missing their vsync, optional work
+// is shed one level at a time; after a long stretch well under budget a level
+// comes back. Levels are cumulative:
+//   0  everything
+//   1  no wisp layer over the haze (clouds.h: the second texture stage)
+//   2  half the stars drawn, no text drop shadows (the shadows only cost
+//      anything in the font's fallback path; with the glyph atlas they are
+//      baked into the same quad, so they never get a level of their own)
+//   3  particle budget cut to a quarter
+//   4  particle budget cut to a sixteenth, a quarter of the stars drawn
+//
+// Hysteresis: shedding needs a few over-budget frames in a row, restoring a
+// few seconds under a much lower threshold, and a level that is shed again
+// right after coming back waits twice as long before the next try.
+//
+// Renderers ask for their settings each frame (Quality_CloudWisps, ...).
+// Debug builds log every change and can draw the state in a corner
+// (Quality_DrawOverlay).
+// -----------------------------------------------------------------------------
+
+#define QUALITY_LEVEL_MAX 4
+
+#if defined(_DEBUG)
+#define QUALITY_OVERLAY 1
+#else
+#define QUALITY_OVERLAY 0
+#endif
+
+// Back to level 0 with nothing measured.
+void Quality_Reset();
+
+void Quality_BeginFrame();
+void Quality_EndFrame();
+
+// Instead of Quality_EndFrame on a frame that loaded a screen (Title_Init,
+// Game_Init): neither its work nor the gap to the next frame is measured, so
+// a load doesn't read as a missed vsync.
+void Quality_SkipFrame();
+
+int   Quality_Level();
+
+// Smoothed update + render time, microseconds.
+DWORD Quality_WorkUs();
+
+// What the current level allows
+bool Quality_CloudWisps();
+int  Quality_StarPercent();
+bool Quality_TextShadows();
+int  Quality_ParticleBudget(int capacity);
+
+// Level, work time and what is shed, as text at the bottom left of the
+// screen (queued through the batch). No-op unless QUALITY_OVERLAY.
+void Quality_DrawOverlay();
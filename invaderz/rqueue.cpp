@@ -0,0 +1,423 @@
+// rqueue.cpp
+#include "rqueue.h"
+
+#include <xtl.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "batch.h"
+#include "perf.h"
+#include "rtarget.h"
+
+// A busy game-over screen records a few hundred commands; running out of
+// either limit just submits what is queued so far and starts again.
+static const int RQ_MAX_CMDS = 2048;
+static const int RQ_ARENA_BYTES = 256 * 1024;   // ~2300 quads of vertices
+static const int RQ_MAX_TEXTURES = 64;          // distinct per submit (slot 0 = none)
+static const int RQ_MAX_BUCKETS = 96;           // (layer, group, state) sets per submit
+
+// Blend is implied by the batch (flat = opaque, textured = alpha); passes
+// set their own state and never share a flush with anything.
+enum RQ_Blend
+{
+    RQ_BLEND_OPAQUE = 0,
+    RQ_BLEND_ALPHA,
+    RQ_BLEND_PASS,
+};
+
+struct RQ_Cmd
+{
+    BatchVertex* verts;         // quads * 4, in the arena (NULL for a pass)
+    int quads;
+    LPDIRECT3DTEXTURE8 tex;
+    RQ_PassFn pass;
+    const void* data;           // pass data, in the arena
+    WORD texSlot;
+    BYTE layer;
+    BYTE blend;
+};
+
+// Screen area covered by everything in one (layer, group, state) set
+struct RQ_Bucket
+{
+    float x0, y0, x1, y1;
+    DWORD state;
+    int group;
+    int layer;
+};
+
+static DWORD s_arena[RQ_ARENA_BYTES / sizeof(DWORD)];
+static int s_arenaUsed = 0;                     // bytes
+
+static RQ_Cmd s_cmds[RQ_MAX_CMDS];
+static int s_cmdCount = 0;
+
+static uint64_t s_keys[RQ_MAX_CMDS];
+static uint64_t s_sortTmp[RQ_MAX_CMDS];
+
+static LPDIRECT3DTEXTURE8 s_texSlots[RQ_MAX_TEXTURES];
+static int s_texCount = 1;
+
+static RQ_Bucket s_buckets[RQ_MAX_BUCKETS];
+
+static bool s_open = false;
+static bool s_submitting = false;
+static int s_rtDepth = 0;                       // target depth at RQ_Begin
+static RQ_Layer s_layer = RQ_LAYER_BACKGROUND;
+
+// ------------------------------
+// Arena
+// ------------------------------
+static __forceinline int ArenaFree()
+{
+    return RQ_ARENA_BYTES - s_arenaUsed;
+}
+
+static void* ArenaAlloc(int bytes)
+{
+    bytes = (bytes + 3) & ~3;
+    if (bytes > ArenaFree()) return NULL;
+
+    void* p = (BYTE*)s_arena + s_arenaUsed;
+    s_arenaUsed += bytes;
+    return p;
+}
+
+static void Reset()
+{
+    s_arenaUsed = 0;
+    s_cmdCount = 0;
+    s_texCount = 1;
+    s_texSlots[0] = NULL;
+}
+
+// Slot for `tex` in this submit's texture table; -1 when the table is full.
+static int TextureSlot(LPDIRECT3DTEXTURE8 tex)
+{
+    if (!tex) return 0;
+
+    for (int i = 1; i < s_texCount; ++i)
+        if (s_texSlots[i] == tex) return i;
+
+    if (s_texCount >= RQ_MAX_TEXTURES) return -1;
+
+    s_texSlots[s_texCount] = tex;
+    return s_texCount++;
+}
+
+// ------------------------------
+// Sort
+// ------------------------------
+static void QuadBounds(const RQ_Cmd& c, RQ_Bucket& b)
+{
+    if (c.pass)
+    {
+        b.x0 = b.y0 = -1.0e9f;
+        b.x1 = b.y1 = 1.0e9f;
+        return;
+    }
+
+    const BatchVertex* v = c.verts;
+    b.x0 = b.x1 = v[0].x;
+    b.y0 = b.y1 = v[0].y;
+
+    for (int i = 1; i < c.quads * 4; ++i)
+    {
+        if (v[i].x < b.x0) b.x0 = v[i].x;
+        if (v[i].x > b.x1) b.x1 = v[i].x;
+        if (v[i].y < b.y0) b.y0 = v[i].y;
+        if (v[i].y > b.y1) b.y1 = v[i].y;
+    }
+}
+
+static __forceinline bool Overlaps(const RQ_Bucket& a, const RQ_Bucket& b)
+{
+    return a.x0 < b.x1 && b.x0 < a.x1 && a.y0 < b.y1 && b.y0 < a.y1;
+}
+
+// Builds every command's key in submission order. A command's group is one
+// past the deepest overlapping set with different state (or equal to the
+// deepest overlapping set with the same state), so sorting by group first
+// never moves it across something it covers or is covered by. If the bucket
+// table fills up, the rest of that layer falls back to one group per command.
+static void BuildKeys()
+{
+    int top[RQ_LAYER_COUNT];
+    bool ordered[RQ_LAYER_COUNT];
+    for (int l = 0; l < RQ_LAYER_COUNT; ++l)
+    {
+        top[l] = 0;
+        ordered[l] = false;
+    }
+
+    int buckets = 0;
+
+    for (int i = 0; i < s_cmdCount; ++i)
+    {
+        const RQ_Cmd& c = s_cmds[i];
+        const int layer = c.layer;
+        const DWORD state = ((DWORD)c.texSlot << 2) | c.blend;
+
+        RQ_Bucket area;
+        QuadBounds(c, area);
+
+        int group = 0;
+
+        if (ordered[layer])
+        {
+            group = top[layer] + 1;
+        }
+        else
+        {
+            for (int b = 0; b < buckets; ++b)
+            {
+                const RQ_Bucket& o = s_buckets[b];
+                if (o.layer != layer || !Overlaps(o, area)) continue;
+
+                const int need = o.group + ((o.state != state) ? 1 : 0);
+                if (need > group) group = need;
+            }
+
+            int found = -1;
+            for (int b = 0; b < buckets && found < 0; ++b)
+            {
+                const RQ_Bucket& o = s_buckets[b];
+                if (o.layer == layer && o.group == group && o.state == state)
+                    found = b;
+            }
+
+            if (found >= 0)
+            {
+                RQ_Bucket& o = s_buckets[found];
+                if (area.x0 < o.x0) o.x0 = area.x0;
+                if (area.y0 < o.y0) o.y0 = area.y0;
+                if (area.x1 > o.x1) o.x1 = area.x1;
+                if (area.y1 > o.y1) o.y1 = area.y1;
+            }
+            else if (buckets < RQ_MAX_BUCKETS)
+            {
+                area.state = state;
+                area.group = group;
+                area.layer = layer;
+                s_buckets[buckets++] = area;
+            }
+            else
+            {
+                ordered[layer] = true;
+                group = top[layer] + 1;
+            }
+        }
+
+        if (group > top[layer]) top[layer] = group;
+
+        s_keys[i] = ((uint64_t)layer << 60)
+                  | ((uint64_t)(group & 0xFFF) << 48)
+                  | ((uint64_t)(c.texSlot & 0x3FFF) << 34)
+                  | ((uint64_t)c.blend << 32)
+                  | (uint64_t)i;
+    }
+}
+
+// Bottom-up merge sort (keys are unique: the low 32 bits are the sequence).
+static void SortKeys(int n)
+{
+    uint64_t* src = s_keys;
+    uint64_t* dst = s_sortTmp;
+
+    for (int width = 1; width < n; width *= 2)
+    {
+        for (int lo = 0; lo < n; lo += 2 * width)
+        {
+            int mid = lo + width;
+            int hi = lo + 2 * width;
+            if (mid > n) mid = n;
+            if (hi > n) hi = n;
+
+            int a = lo, b = mid, o = lo;
+            while (a < mid && b < hi)
+                dst[o++] = (src[a] < src[b]) ? src[a++] : src[b++];
+            while (a < mid) dst[o++] = src[a++];
+            while (b < hi)  dst[o++] = src[b++];
+        }
+
+        uint64_t* t = src;
+        src = dst;
+        dst = t;
+    }
+
+    if (src != s_keys)
+        memcpy(s_keys, src, (size_t)n * sizeof(s_keys[0]));
+}
+
+// ------------------------------
+// Submit
+// ------------------------------
+static void PushFlat(const BatchVertex* v, int quads)
+{
+    while (quads > 0)
+    {
+        int got = 0;
+        BatchVertex* dst = Batch_AllocQuads(NULL, quads, got);
+        memcpy(dst, v, (size_t)got * 4 * sizeof(BatchVertex));
+        v += got * 4;
+        quads -= got;
+    }
+}
+
+static void Submit()
+{
+    if (s_cmdCount == 0)
+    {
+        Reset();
+        return;
+    }
+
+    s_submitting = true;
+
+    BuildKeys();
+    SortKeys(s_cmdCount);
+
+    for (int i = 0; i < s_cmdCount; ++i)
+    {
+        const RQ_Cmd& c = s_cmds[(uint32_t)s_keys[i]];
+
+        if (c.pass)
+        {
+            Batch_Flush();
+            c.pass(c.data);
+        }
+        else if (c.tex)
+        {
+            Batch_PushQuads(c.tex, c.verts, c.quads);
+        }
+        else
+        {
+            PushFlat(c.verts, c.quads);
+        }
+    }
+
+    s_submitting = false;
+
+    Perf_Add(PERF_QUEUE_COMMANDS, (DWORD)s_cmdCount);
+    Reset();
+}
+
+// ------------------------------
+// Public API
+// ------------------------------
+void RQ_Begin()
+{
+    if (s_open) return;
+
+    // Anything queued before the frame draws first
+    Batch_Flush();
+
+    Reset();
+    s_open = true;
+    s_rtDepth = RT_Depth();
+    s_layer = RQ_LAYER_BACKGROUND;
+}
+
+void RQ_End()
+{
+    if (!s_open) return;
+
+    Submit();
+    s_open = false;
+}
+
+void RQ_SetLayer(RQ_Layer layer)
+{
+    if ((int)layer < 0 || layer >= RQ_LAYER_COUNT) return;
+    s_layer = layer;
+}
+
+bool RQ_Recording()
+{
+    return s_open && !s_submitting && RT_Depth() == s_rtDepth;
+}
+
+void RQ_PushPass(RQ_PassFn fn, const void* data, int size)
+{
+    if (!fn) return;
+
+    if (!RQ_Recording())
+    {
+        Batch_Flush();
+        fn(data);
+        return;
+    }
+
+    if (size < 0) size = 0;
+
+    void* copy = ArenaAlloc(size);
+    if (!copy || s_cmdCount >= RQ_MAX_CMDS)
+    {
+        Submit();
+        copy = ArenaAlloc(size);
+    }
+
+    if (!copy)
+    {
+        // Larger than the whole arena: run it in place
+        Batch_Flush();
+        fn(data);
+        return;
+    }
+
+    if (size > 0) memcpy(copy, data, (size_t)size);
+
+    RQ_Cmd& c = s_cmds[s_cmdCount++];
+    c.verts = NULL;
+    c.quads = 0;
+    c.tex = NULL;
+    c.pass = fn;
+    c.data = copy;
+    c.texSlot = 0;
+    c.layer = (BYTE)s_layer;
+    c.blend = RQ_BLEND_PASS;
+}
+
+BatchVertex* RQ_AllocQuads(LPDIRECT3DTEXTURE8 tex, int want, int& got)
+{
+    const int quadBytes = 4 * sizeof(BatchVertex);
+
+    got = 0;
+    if (want <= 0) return (BatchVertex*)((BYTE*)s_arena + s_arenaUsed);
+
+    int slot = TextureSlot(tex);
+    if (slot < 0 || ArenaFree() < quadBytes || s_cmdCount >= RQ_MAX_CMDS)
+    {
+        Submit();
+        slot = TextureSlot(tex);
+    }
+
+    int n = ArenaFree() / quadBytes;
+    if (n > want) n = want;
+
+    BatchVertex* v = (BatchVertex*)ArenaAlloc(n * quadBytes);
+    got = n;
+
+    // Grow the previous command when this continues it in the arena
+    if (s_cmdCount > 0)
+    {
+        RQ_Cmd& last = s_cmds[s_cmdCount - 1];
+        if (!last.pass && last.tex == tex && last.layer == (BYTE)s_layer &&
+            last.verts + last.quads * 4 == v)
+        {
+            last.quads += n;
+            return v;
+        }
+    }
+
+    RQ_Cmd& c = s_cmds[s_cmdCount++];
+    c.verts = v;
+    c.quads = n;
+    c.tex = tex;
+    c.pass = NULL;
+    c.data = NULL;
+    c.texSlot = (WORD)slot;
+    c.layer = (BYTE)s_layer;
+    c.blend = tex ? RQ_BLEND_ALPHA : RQ_BLEND_OPAQUE;
+    return v;
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include <xtl.h>
+
+#include "batch.h"
+
+// -----------------------------------------------------------------------------
+// Sorted render queue.
+//
+// Between RQ_Begin and RQ_End, everything pushed to the batch (batch.h) is
+// recorded as a command into a per-frame arena instead of being drawn, tagged
+// with the current layer. RQ_End sorts the commands by a 64-bit key and feeds
+// them to the batch, so same-texture work ends up in the same flush.
+//
+// Key, high to low:  layer:4 | group:12 | texture:14 | blend:2 | sequence:32
+//
+// Layers always draw in order. Inside a layer a command may move earlier, next
+// to others with the same texture and blend, only if it doesn't overlap
+// anything with different state it would jump over; `group` is the overlap
+// depth that enforces this, so the picture is the same as drawing in
+// submission order. Equal keys up to the sequence keep submission order.
+//
+// Draws made inside an RT_Begin/RT_End opened after RQ_Begin go straight to
+// the batch (they belong to another target). Code that talks to the device
+// itself goes through RQ_PushPass.
+//
+// Usage:
+//   RQ_Begin();
+//   RQ_SetLayer(RQ_LAYER_BACKGROUND);
+//   ...Batch_Push* / Starfield_Render / DrawText...
+//   RQ_SetLayer(RQ_LAYER_HUD);
+//   ...
+//   RQ_End();
+// -----------------------------------------------------------------------------
+
+enum RQ_Layer
+{
+    RQ_LAYER_BACKGROUND = 0,    // stars, clouds
+    RQ_LAYER_ENTITIES,          // invaders, shields, player, bullets
+    RQ_LAYER_HUD,               // score line and labels
+    RQ_LAYER_OVERLAY,           // GET READY, game over screens
+
+    RQ_LAYER_COUNT
+};
+
+// Device pass: called at its place in the sorted order with a copy of the
+// data given to RQ_PushPass. The batch is flushed before the call; the pass
+// sets whatever state it needs.
+typedef void (*RQ_PassFn)(const void* data);
+
+void RQ_Begin();
+void RQ_End();
+
+// Layer for commands recorded from now on (RQ_LAYER_BACKGROUND at Begin).
+void RQ_SetLayer(RQ_Layer layer);
+
+// True while batch pushes are being recorded.
+bool RQ_Recording();
+
+// Records a pass covering the whole screen; `size` bytes of `data` are copied.
+// Outside recording the pass runs immediately.
+void RQ_PushPass(RQ_PassFn fn, const void* data, int size);
+
+// Batch side (batch.cpp): reserves up to `want` quads drawn with `tex`
+// (NULL = flat colour) as one command. Same contract as Batch_AllocQuads.
+BatchVertex* RQ_AllocQuads(LPDIRECT3DTEXTURE8 tex, int want, int& got);
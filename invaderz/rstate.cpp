@@ -0,0 +1,71 @@
+// rstate.cpp
+#include "rstate.h"
+
+#include <xtl.h>
+
+#include "statecache.h"
+#include "perf.h"
+#include "drawrec.h"
+
+// Device provided by main.cpp
+extern LPDIRECT3DDEVICE8 g_pDevice;
+
+static StateCache s_cache;    // zeroed = nothing known yet
+
+static __forceinline void Count(bool issue)
+{
+    Perf_Add(issue ? PERF_STATE_ISSUED : PERF_STATE_FILTERED, 1);
+}
+
+void RS_SetRenderState(D3DRENDERSTATETYPE state, DWORD value)
+{
+    const bool issue = StateCache_RenderState(s_cache, (uint32_t)state, (uint32_t)value);
+    Count(issue);
+
+    if (issue && g_pDevice)
+    {
+        g_pDevice->SetRenderState(state, value);
+        DrawRec_RenderState(state, value);
+    }
+}
+
+void RS_SetTextureStageState(DWORD stage, D3DTEXTURESTAGESTATETYPE state, DWORD value)
+{
+    const bool issue = StateCache_StageState(s_cache, (uint32_t)stage, (uint32_t)state, (uint32_t)value);
+    Count(issue);
+
+    if (issue && g_pDevice)
+    {
+        g_pDevice->SetTextureStageState(stage, state, value);
+        DrawRec_StageState(stage, state, value);
+    }
+}
+
+void RS_SetTexture(DWORD stage, LPDIRECT3DBASETEXTURE8 tex)
+{
+    const bool issue = StateCache_Texture(s_cache, (uint32_t)stage, (uintptr_t)tex);
+    Count(issue);
+
+    if (issue && g_pDevice)
+    {
+        g_pDevice->SetTexture(stage, tex);
+        DrawRec_Texture(stage, tex);
+    }
+}
+
+void RS_SetVertexShader(DWORD handle)
+{
+    const bool issue = StateCache_VertexShader(s_cache, (uint32_t)handle);
+    Count(issue);
+
+    if (issue && g_pDevice)
+    {
+        g_pDevice->SetVertexShader(handle);
+        DrawRec_Shader(handle);
+    }
+}
+
+void RS_Invalidate()
+{
+    StateCache_Reset(s_cache);
+}
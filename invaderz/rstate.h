@@ -0,0 +1,21 @@
+#pragma once
+#include <xtl.h>
+
+// -----------------------------------------------------------------------------
+// Filtered device state.
+//
+// Drop-in replacements for the g_pDevice state setters that skip calls which
+// would not change anything (state shadow lives in statecache.h). All state
+// changes in the game go through these; if something talks to g_pDevice
+// directly, call RS_Invalidate() afterwards.
+//
+// Issued/filtered totals show up in perf.h (PERF_STATE_ISSUED / _FILTERED).
+// -----------------------------------------------------------------------------
+
+void RS_SetRenderState(D3DRENDERSTATETYPE state, DWORD value);
+void RS_SetTextureStageState(DWORD stage, D3DTEXTURESTAGESTATETYPE state, DWORD value);
+void RS_SetTexture(DWORD stage, LPDIRECT3DBASETEXTURE8 tex);
+void RS_SetVertexShader(DWORD handle);
+
+// Forget the shadowed state; the next set of everything reaches the device.
+void RS_Invalidate();
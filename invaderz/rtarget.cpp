@@ -0,0 +1,146 @@
+// rtarget.cpp
+#include "rtarget.h"
+
+#include <xtl.h>
+
+#include "batch.h"
+#include "rstate.h"
+#include "drawrec.h"
+
+// Device provided by main.cpp
+extern LPDIRECT3DDEVICE8 g_pDevice;
+
+// Arcade framebuffer + one target drawn inside it is all we need
+static const int RT_STACK_MAX = 4;
+
+struct SavedTarget
+{
+    LPDIRECT3DSURFACE8 color;
+    LPDIRECT3DSURFACE8 depth;
+    D3DVIEWPORT8 vp;
+    float viewScale;
+    LPDIRECT3DTEXTURE8 tex;     // what `color` belongs to (NULL = back buffer)
+};
+
+static SavedTarget s_stack[RT_STACK_MAX];
+static int s_depth = 0;
+
+// Texture currently rendered to (NULL = back buffer), for the draw recorder
+static LPDIRECT3DTEXTURE8 s_curTex = NULL;
+
+bool RT_Create(RenderTarget& rt, int w, int h, D3DFORMAT fmt)
+{
+    rt.tex = NULL;
+    rt.surf = NULL;
+    rt.w = 0;
+    rt.h = 0;
+
+    if (!g_pDevice || w <= 0 || h <= 0) return false;
+
+    if (FAILED(g_pDevice->CreateTexture((UINT)w, (UINT)h, 1, D3DUSAGE_RENDERTARGET, fmt, D3DPOOL_DEFAULT, &rt.tex)))
+    {
+        rt.tex = NULL;
+        return false;
+    }
+
+    if (FAILED(rt.tex->GetSurfaceLevel(0, &rt.surf)))
+    {
+        rt.surf = NULL;
+        RT_Release(rt);
+        return false;
+    }
+
+    rt.w = w;
+    rt.h = h;
+    return true;
+}
+
+void RT_Release(RenderTarget& rt)
+{
+    if (rt.surf)
+    {
+        rt.surf->Release();
+        rt.surf = NULL;
+    }
+    if (rt.tex)
+    {
+        rt.tex->Release();
+        rt.tex = NULL;
+    }
+    rt.w = 0;
+    rt.h = 0;
+}
+
+bool RT_Begin(RenderTarget& rt, D3DCOLOR clear, float viewScale)
+{
+    if (!g_pDevice || !rt.surf) return false;
+    if (s_depth >= RT_STACK_MAX) return false;
+
+    SavedTarget& s = s_stack[s_depth];
+
+    if (FAILED(g_pDevice->GetRenderTarget(&s.color)))
+        return false;
+
+    // No auto depth buffer in this game; keep whatever is there anyway
+    if (FAILED(g_pDevice->GetDepthStencilSurface(&s.depth)))
+        s.depth = NULL;
+
+    g_pDevice->GetViewport(&s.vp);
+    s.viewScale = Batch_ViewScale();
+    s.tex = s_curTex;
+    s_depth++;
+
+    // Queued quads belong to the old target
+    Batch_Flush();
+
+    // May still be bound from when it was last sampled
+    RS_SetTexture(0, NULL);
+
+    g_pDevice->SetRenderTarget(rt.surf, NULL);
+    s_curTex = rt.tex;
+    DrawRec_Target(rt.tex, rt.w, rt.h);
+
+    D3DVIEWPORT8 vp;
+    vp.X = 0;
+    vp.Y = 0;
+    vp.Width = (DWORD)rt.w;
+    vp.Height = (DWORD)rt.h;
+    vp.MinZ = 0.0f;
+    vp.MaxZ = 1.0f;
+    g_pDevice->SetViewport(&vp);
+
+    DrawRec_Clear(clear);
+
+    Batch_SetViewScale(viewScale);
+    return true;
+}
+
+void RT_End()
+{
+    if (s_depth <= 0) return;
+
+    // Everything queued so far goes to this target, at its view scale
+    Batch_Flush();
+
+    SavedTarget& s = s_stack[--s_depth];
+
+    g_pDevice->SetRenderTarget(s.color, s.depth);
+    g_pDevice->SetViewport(&s.vp);
+    Batch_SetViewScale(s.viewScale);
+
+    s_curTex = s.tex;
+    DrawRec_Target(s.tex, (int)s.vp.Width, (int)s.vp.Height);
+
+    s.color->Release();
+    s.color = NULL;
+    if (s.depth)
+    {
+        s.depth->Release();
+        s.depth = NULL;
+    }
+}
+
+int RT_Depth()
+{
+    return s_depth;
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include <xtl.h>
+
+// -----------------------------------------------------------------------------
+// Offscreen render targets.
+//
+// A linear texture that can be drawn into and then sampled (texel UVs, not
+// normalized). RT_Begin/RT_End redirect rendering and nest: End puts back the
+// target, viewport and batch view scale that were current at Begin.
+//
+// Usage:
+//   RT_Begin(rt, clearColor, viewScale);
+//   ...draw through the batch...
+//   RT_End();
+//   Batch_PushQuadUV(rt.tex, x, y, w, h, 0, 0, rt.w, rt.h, color);
+// -----------------------------------------------------------------------------
+
+struct RenderTarget
+{
+    LPDIRECT3DTEXTURE8 tex;
+    LPDIRECT3DSURFACE8 surf;
+    int w, h;
+};
+
+// fmt should be a linear format (D3DFMT_LIN_*). False if the device refuses.
+bool RT_Create(RenderTarget& rt, int w, int h, D3DFORMAT fmt);
+void RT_Release(RenderTarget& rt);
+
+// Flushes the batch, switches to `rt`, clears it and sets the batch view
+// scale. Returns false (nothing changed) if rt wasn't created or the stack
+// is full.
+bool RT_Begin(RenderTarget& rt, D3DCOLOR clear, float viewScale);
+void RT_End();
+
+// Targets currently begun (0 = drawing to the back buffer).
+int RT_Depth();
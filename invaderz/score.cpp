@@ -6,6 +6,7 @@
 #include <stdlib.h>
 
 #include "font.h"
+#include "textcache.h"
 
 // -----------------------------------------------------------------------------
 // Small helpers (existing)
@@ -121,6 +122,7 @@ static const char* kHS_DataFileA = "highscore.dat";
 
 static bool s_hsLoaded = false;
 static HighScoreEntry s_hs[SCORE_HS_MAX];
+static DWORD s_hsRevision = 0;         // bumped whenever s_hs changes (keys the row cache)
 
 static bool s_hsPathReady = false;
 static char s_hsSaveDirA[MAX_PATH];   // directory path
@@ -540,6 +542,7 @@ void ScoreHS_Init()
     }
 
     s_hsLoaded = true;
+    s_hsRevision++;
 }
 
 bool ScoreHS_Qualifies(int score)
@@ -572,6 +575,7 @@ void ScoreHS_Submit(const char initials3[4], int score)
     s_hs[SCORE_HS_MAX - 1].score = score;
 
     HS_SortHighToLow();
+    s_hsRevision++;
     HS_SaveFile();
 }
 
@@ -586,10 +590,13 @@ bool ScoreHS_Get(int rank, HighScoreEntry& out)
     return true;
 }
 
-void ScoreHS_RenderTable(float x, float y, float scale, DWORD color)
-{
-    ScoreHS_Init();
+// -----------------------------------------------------------------------------
+// Table rendering
+// -----------------------------------------------------------------------------
+static TextCacheEntry s_rowCache[SCORE_HS_MAX];
 
+static int HS_MaxDigits()
+{
     int maxDigits = 1;
     for (int i = 0; i < SCORE_HS_MAX; ++i)
     {
@@ -604,51 +611,72 @@ void ScoreHS_RenderTable(float x, float y, float scale, DWORD color)
     }
     if (maxDigits < 4) maxDigits = 4;
     if (maxDigits > 8) maxDigits = 8;
+    return maxDigits;
+}
 
-    for (int i = 0; i < SCORE_HS_MAX; ++i)
-    {
-        char line[64];
-        int pos = 0;
+static void HS_FormatRow(char* line, int lineSize, int i, int maxDigits)
+{
+    int pos = 0;
 
-        int rank = i + 1;
-        line[pos++] = (char)('0' + (rank / 10));
-        line[pos++] = (char)('0' + (rank % 10));
-        line[pos++] = ' ';
-        line[pos++] = ' ';
+    int rank = i + 1;
+    line[pos++] = (char)('0' + (rank / 10));
+    line[pos++] = (char)('0' + (rank % 10));
+    line[pos++] = ' ';
+    line[pos++] = ' ';
 
-        line[pos++] = s_hs[i].initials[0];
-        line[pos++] = s_hs[i].initials[1];
-        line[pos++] = s_hs[i].initials[2];
-        line[pos++] = ' ';
-        line[pos++] = ' ';
+    line[pos++] = s_hs[i].initials[0];
+    line[pos++] = s_hs[i].initials[1];
+    line[pos++] = s_hs[i].initials[2];
+    line[pos++] = ' ';
+    line[pos++] = ' ';
 
-        int v = s_hs[i].score;
-        if (v < 0) v = 0;
+    int v = s_hs[i].score;
+    if (v < 0) v = 0;
 
-        char digits[16];
-        int n = 0;
-        if (v == 0) digits[n++] = '0';
-        else
+    char digits[16];
+    int n = 0;
+    if (v == 0) digits[n++] = '0';
+    else
+    {
+        while (v > 0 && n < (int)sizeof(digits))
         {
-            while (v > 0 && n < (int)sizeof(digits))
-            {
-                digits[n++] = (char)('0' + (v % 10));
-                v /= 10;
-            }
+            digits[n++] = (char)('0' + (v % 10));
+            v /= 10;
         }
+    }
+
+    int pad = maxDigits - n;
+    while (pad-- > 0 && pos < lineSize - 1)
+        line[pos++] = ' ';
+
+    while (n > 0 && pos < lineSize - 1)
+        line[pos++] = digits[--n];
+
+    line[pos] = 0;
+}
 
-        int pad = maxDigits - n;
-        while (pad-- > 0 && pos < (int)sizeof(line) - 1)
-            line[pos++] = ' ';
+void ScoreHS_RenderTable(float x, float y, float scale, DWORD color)
+{
+    ScoreHS_Init();
+
+    // Rows are only re-formatted when the table (or placement) changes
+    int maxDigits = 0;
+
+    for (int i = 0; i < SCORE_HS_MAX; ++i)
+    {
+        const float rowY = y + (float)i * (12.0f * scale);
 
-        while (n > 0 && pos < (int)sizeof(line) - 1)
-            line[pos++] = digits[--n];
+        if (TextCache_Draw(s_rowCache[i], s_hsRevision, x, rowY, scale, color))
+            continue;
 
-        line[pos] = 0;
+        if (maxDigits == 0)
+            maxDigits = HS_MaxDigits();
+
+        char line[64];
+        HS_FormatRow(line, (int)sizeof(line), i, maxDigits);
 
-        float w = (float)strlen(line) * (6.0f * scale);
-        float drawX = x - (w * 0.5f);
+        float w = Font_TextWidth(line, scale);
 
-        DrawText(drawX, y + (float)i * (12.0f * scale), line, scale, color);
+        TextCache_Store(s_rowCache[i], s_hsRevision, x, rowY, scale, color, line, -(w * 0.5f));
     }
 }
@@ -0,0 +1,84 @@
+// simclock.cpp
+#include "simclock.h"
+
+#include <xtl.h>
+
+// Elapsed counts are kept multiplied by SIM_TICK_HZ, so one tick is exactly
+// `freq` units and nothing drifts from rounding the tick length.
+static LONGLONG s_freq = 0;
+
+static LONGLONG Freq()
+{
+    if (s_freq == 0)
+    {
+        LARGE_INTEGER f;
+        QueryPerformanceFrequency(&f);
+        s_freq = (f.QuadPart > 0) ? f.QuadPart : 1;
+    }
+    return s_freq;
+}
+
+LONGLONG SimClock_Now()
+{
+    LARGE_INTEGER t;
+    QueryPerformanceCounter(&t);
+    return t.QuadPart;
+}
+
+float SimClock_TicksSince(LONGLONG stamp)
+{
+    const LONGLONG elapsed = SimClock_Now() - stamp;
+    if (elapsed <= 0) return 0.0f;
+
+    return (float)((double)elapsed * SIM_TICK_HZ / (double)Freq());
+}
+
+DWORD SimClock_MicrosSince(LONGLONG stamp)
+{
+    const LONGLONG elapsed = SimClock_Now() - stamp;
+    if (elapsed <= 0) return 0;
+
+    return (DWORD)(elapsed * 1000000 / Freq());
+}
+
+void SimClock_Reset(SimClock& c)
+{
+    Freq();
+
+    c.last = SimClock_Now();
+    c.accum = 0;
+}
+
+int SimClock_Advance(SimClock& c)
+{
+    const LONGLONG freq = Freq();
+    const LONGLONG now = SimClock_Now();
+
+    LONGLONG elapsed = now - c.last;
+    c.last = now;
+
+    if (elapsed < 0) elapsed = 0;
+
+    c.accum += elapsed * SIM_TICK_HZ;
+
+    int ticks = (int)(c.accum / freq);
+    c.accum -= (LONGLONG)ticks * freq;
+
+    if (ticks > SIM_MAX_TICKS)
+        ticks = SIM_MAX_TICKS;
+
+    return ticks;
+}
+
+float SimClock_Alpha(const SimClock& c)
+{
+    return (float)((double)c.accum / (double)Freq());
+}
+
+DWORD SimClock_TickMs(DWORD& carry)
+{
+    carry += 1000;
+    const DWORD ms = carry / SIM_TICK_HZ;
+    carry -= ms * SIM_TICK_HZ;
+    return ms;
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include <xtl.h>
+
+// -----------------------------------------------------------------------------
+// Fixed-step simulation clock.
+//
+// Game and attract logic count time in ticks of exactly 1/SIM_TICK_HZ s,
+// whatever the display runs at (60 Hz NTSC, 50 Hz PAL, a missed vsync). Each
+// presented frame, main.cpp asks how many ticks are due from the real time
+// that passed (QueryPerformanceCounter), runs that many updates, then renders
+// with SimClock_Alpha() saying how far it is into the next tick. A sim thread
+// (game.h, GAME_SIM_THREAD) keeps a clock of its own.
+//
+// Usage:
+//   SimClock clock;
+//   SimClock_Reset(clock);                 // after loading, so it isn't caught up
+//   int ticks = SimClock_Advance(clock);   // once per frame
+//   for (...ticks...) Game_Update();
+//   Game_Render(SimClock_Alpha(clock));
+// -----------------------------------------------------------------------------
+
+#define SIM_TICK_HZ 60
+
+// A frame never runs more ticks than this; time beyond it is dropped (the
+// game slows down instead of stalling further to catch up).
+#define SIM_MAX_TICKS 4
+
+struct SimClock
+{
+    LONGLONG last;      // QPC at the last Advance
+    LONGLONG accum;     // QPC counts * SIM_TICK_HZ not yet turned into ticks
+};
+
+void  SimClock_Reset(SimClock& c);
+int   SimClock_Advance(SimClock& c);
+
+// Time left over after the ticks Advance returned, as a fraction of a tick
+// in [0, 1).
+float SimClock_Alpha(const SimClock& c);
+
+// QPC timestamp, and ticks (fractional) elapsed since one.
+LONGLONG SimClock_Now();
+float    SimClock_TicksSince(LONGLONG stamp);
+
+// Microseconds elapsed since a SimClock_Now() stamp, for profiling.
+DWORD    SimClock_MicrosSince(LONGLONG stamp);
+
+// Milliseconds to advance animators by on this tick: 16 or 17, adding up to
+// exactly 1000 per SIM_TICK_HZ ticks. `carry` is the caller's remainder.
+DWORD SimClock_TickMs(DWORD& carry);
@@ -1,15 +1,29 @@
 #pragma once
 #include <stdint.h>
+#include <stddef.h>
+
+// Solid block of one palette index, in sprite pixels (see Sprite4::rects).
+struct SpriteRect
+{
+    uint8_t x, y;
+    uint8_t w, h;
+    uint8_t color;         // palette index, never 0
+};
 
 // 4bpp paletted sprite:
 // - index 0 = transparent
 // - pixels are packed: high nibble = left pixel, low nibble = right pixel
 // - row-major, no padding
+// - rects: the same pixels as a list of same-colour rectangles, built at
+//   compile time (SPRITE4_RECTS below) so untextured renderers can draw a
+//   sprite with a few rects instead of one per pixel
 struct Sprite4
 {
     uint16_t        w;
     uint16_t        h;
     const uint8_t* data;   // size = (w*h)/2 bytes for even w
+    const SpriteRect* rects;
+    uint16_t        rectCount;
 };
 
 enum SpriteId : uint32_t
@@ -67,4 +81,93 @@ enum AnimId : uint32_t
     ANIM_INVADER_C,
 
     ANIM_COUNT
-};
\ No newline at end of file
+};
+// -----------------------------------------------------------------------------
+// Compile-time rect decomposition
+//
+// Greedy: scan rows top to bottom; each uncovered lit pixel starts a maximal
+// horizontal run of its colour, which is then extended downwards while the
+// rows below hold exactly the same run (same x, width and colour, bounded by
+// other colours/edges). Never produces more rects than there are row runs.
+// -----------------------------------------------------------------------------
+template <uint16_t W, uint16_t H>
+constexpr uint8_t Sprite4_IndexAt(const uint8_t* data, int x, int y)
+{
+    // packed: high nibble = left pixel, low nibble = right pixel
+    return (uint8_t)((((y * W + x) & 1) == 0) ? (data[(y * W + x) >> 1] >> 4)
+                                              : (data[(y * W + x) >> 1] & 0x0F));
+}
+
+// True if row y holds a maximal run of colour c covering exactly [x, x+w).
+template <uint16_t W, uint16_t H>
+constexpr bool Sprite4_RowHasRun(const uint8_t* data, int x, int y, int w, uint8_t c)
+{
+    for (int i = 0; i < w; ++i)
+        if (Sprite4_IndexAt<W, H>(data, x + i, y) != c) return false;
+
+    if (x > 0 && Sprite4_IndexAt<W, H>(data, x - 1, y) == c) return false;
+    if (x + w < W && Sprite4_IndexAt<W, H>(data, x + w, y) == c) return false;
+    return true;
+}
+
+// Runs the decomposition; writes into out (if non-null) and returns the count.
+template <uint16_t W, uint16_t H>
+constexpr int Sprite4_Decompose(const uint8_t* data, SpriteRect* out)
+{
+    bool covered[H][W] = {};
+    int n = 0;
+
+    for (int y = 0; y < H; ++y)
+    {
+        int x = 0;
+        while (x < W)
+        {
+            const uint8_t c = Sprite4_IndexAt<W, H>(data, x, y);
+            if (c == 0 || covered[y][x]) { ++x; continue; }
+
+            int w = 1;
+            while (x + w < W && Sprite4_IndexAt<W, H>(data, x + w, y) == c) ++w;
+
+            int h = 1;
+            while (y + h < H && !covered[y + h][x] && Sprite4_RowHasRun<W, H>(data, x, y + h, w, c)) ++h;
+
+            for (int yy = y; yy < y + h; ++yy)
+                for (int xx = x; xx < x + w; ++xx)
+                    covered[yy][xx] = true;
+
+            if (out)
+            {
+                out[n].x = (uint8_t)x;
+                out[n].y = (uint8_t)y;
+                out[n].w = (uint8_t)w;
+                out[n].h = (uint8_t)h;
+                out[n].color = c;
+            }
+            ++n;
+            x += w;
+        }
+    }
+
+    return n;
+}
+
+template <int N>
+struct SpriteRectTable
+{
+    SpriteRect rects[N > 0 ? N : 1];
+    uint16_t count;
+};
+
+template <uint16_t W, uint16_t H, int N, size_t Bytes>
+constexpr SpriteRectTable<N> Sprite4_BuildRects(const uint8_t (&data)[Bytes])
+{
+    static_assert(Bytes * 2 == (size_t)W * H, "Sprite4 data size must be w*h/2");
+
+    SpriteRectTable<N> t = {};
+    t.count = (uint16_t)Sprite4_Decompose<W, H>(data, t.rects);
+    return t;
+}
+
+// Declares `name` as the exact-size rect table for a W x H sprite's data.
+#define SPRITE4_RECTS(name, W, H, data) \
+    static constexpr auto name = Sprite4_BuildRects<W, H, Sprite4_Decompose<W, H>(data, nullptr)>(data)
@@ -27,7 +27,7 @@ static const uint32_t g_paletteClassic[16] =
 // -----------------------------------------------------------------------------
 // SPR_PLAYER (16x8) - uses index 1 (white)
 // -----------------------------------------------------------------------------
-static const uint8_t g_spr_player[] =
+static constexpr uint8_t g_spr_player[] =
 {
     0x00, 0x00, 0x01, 0x11, 0x11, 0x10, 0x00, 0x00,
     0x00, 0x00, 0x11, 0x11, 0x11, 0x11, 0x10, 0x00,
@@ -38,22 +38,24 @@ static const uint8_t g_spr_player[] =
     0x11, 0x11, 0x10, 0x01, 0x10, 0x00, 0x11, 0x11,
     0x00, 0x11, 0x00, 0x01, 0x10, 0x00, 0x11, 0x00,
 };
+SPRITE4_RECTS(g_rects_player, 16, 8, g_spr_player);
 
 // -----------------------------------------------------------------------------
 // SPR_PLAYER_BULLET (2x4) - uses index 1 (white)
 // -----------------------------------------------------------------------------
-static const uint8_t g_spr_playerBullet[] =
+static constexpr uint8_t g_spr_playerBullet[] =
 {
     0x11,
     0x11,
     0x11,
     0x11,
 };
+SPRITE4_RECTS(g_rects_playerBullet, 2, 4, g_spr_playerBullet);
 
 // -----------------------------------------------------------------------------
 // SPR_INVADER_A (12x8) Frame 1 - uses index 2 (green)
 // -----------------------------------------------------------------------------
-static const uint8_t g_spr_invA[] =
+static constexpr uint8_t g_spr_invA[] =
 {
     0x00, 0x22, 0x00, 0x22, 0x00, 0x00,
     0x02, 0x22, 0x22, 0x22, 0x20, 0x00,
@@ -64,11 +66,12 @@ static const uint8_t g_spr_invA[] =
     0x20, 0x00, 0x22, 0x00, 0x02, 0x00,
     0x02, 0x00, 0x00, 0x00, 0x20, 0x00,
 };
+SPRITE4_RECTS(g_rects_invA, 12, 8, g_spr_invA);
 
 // -----------------------------------------------------------------------------
 // SPR_INVADER_A2 (12x8) Frame 2 - "arms" raised
 // -----------------------------------------------------------------------------
-static const uint8_t g_spr_invA2[] =
+static constexpr uint8_t g_spr_invA2[] =
 {
     0x00, 0x22, 0x00, 0x22, 0x00, 0x00,
     0x00, 0x02, 0x20, 0x22, 0x00, 0x00,
@@ -79,11 +82,12 @@ static const uint8_t g_spr_invA2[] =
     0x02, 0x00, 0x20, 0x02, 0x00, 0x20,
     0x00, 0x02, 0x00, 0x00, 0x20, 0x00,
 };
+SPRITE4_RECTS(g_rects_invA2, 12, 8, g_spr_invA2);
 
 // -----------------------------------------------------------------------------
 // SPR_INVADER_B (12x8) Frame 1 - uses index 3 (cyan)
 // -----------------------------------------------------------------------------
-static const uint8_t g_spr_invB[] =
+static constexpr uint8_t g_spr_invB[] =
 {
     0x00, 0x33, 0x00, 0x00, 0x33, 0x00,
     0x00, 0x03, 0x30, 0x03, 0x30, 0x00,
@@ -94,11 +98,12 @@ static const uint8_t g_spr_invB[] =
     0x03, 0x03, 0x00, 0x00, 0x30, 0x33,
     0x00, 0x30, 0x00, 0x00, 0x30, 0x00,
 };
+SPRITE4_RECTS(g_rects_invB, 12, 8, g_spr_invB);
 
 // -----------------------------------------------------------------------------
 // SPR_INVADER_B2 (12x8) Frame 2 - "legs" bent
 // -----------------------------------------------------------------------------
-static const uint8_t g_spr_invB2[] =
+static constexpr uint8_t g_spr_invB2[] =
 {
     0x00, 0x33, 0x00, 0x00, 0x33, 0x00,
     0x03, 0x03, 0x30, 0x03, 0x30, 0x33,
@@ -109,11 +114,12 @@ static const uint8_t g_spr_invB2[] =
     0x00, 0x30, 0x00, 0x00, 0x03, 0x00,
     0x03, 0x00, 0x00, 0x00, 0x00, 0x30,
 };
+SPRITE4_RECTS(g_rects_invB2, 12, 8, g_spr_invB2);
 
 // -----------------------------------------------------------------------------
 // SPR_INVADER_C (12x8) Frame 1 - uses index 4 (magenta)
 // -----------------------------------------------------------------------------
-static const uint8_t g_spr_invC[] =
+static constexpr uint8_t g_spr_invC[] =
 {
     0x00, 0x44, 0x44, 0x44, 0x00, 0x00,
     0x00, 0x44, 0x44, 0x44, 0x40, 0x00,
@@ -124,11 +130,12 @@ static const uint8_t g_spr_invC[] =
     0x00, 0x40, 0x00, 0x00, 0x04, 0x00,
     0x04, 0x00, 0x00, 0x00, 0x00, 0x40,
 };
+SPRITE4_RECTS(g_rects_invC, 12, 8, g_spr_invC);
 
 // -----------------------------------------------------------------------------
 // SPR_INVADER_C2 (12x8) Frame 2 - "tentacles" up
 // -----------------------------------------------------------------------------
-static const uint8_t g_spr_invC2[] =
+static constexpr uint8_t g_spr_invC2[] =
 {
     0x00, 0x44, 0x44, 0x44, 0x00, 0x00,
     0x04, 0x44, 0x44, 0x44, 0x44, 0x00,
@@ -139,11 +146,12 @@ static const uint8_t g_spr_invC2[] =
     0x04, 0x00, 0x00, 0x00, 0x00, 0x40,
     0x00, 0x04, 0x00, 0x00, 0x40, 0x00,
 };
+SPRITE4_RECTS(g_rects_invC2, 12, 8, g_spr_invC2);
 
 // -----------------------------------------------------------------------------
 // Enemy bullets (4x8) - uses index 1 (white)
 // -----------------------------------------------------------------------------
-static const uint8_t g_spr_eZig[] =
+static constexpr uint8_t g_spr_eZig[] =
 {
     0x01, 0x01,
     0x10, 0x10,
@@ -154,8 +162,9 @@ static const uint8_t g_spr_eZig[] =
     0x01, 0x01,
     0x10, 0x10,
 };
+SPRITE4_RECTS(g_rects_eZig, 4, 8, g_spr_eZig);
 
-static const uint8_t g_spr_ePlunger[] =
+static constexpr uint8_t g_spr_ePlunger[] =
 {
     0x01, 0x10,
     0x01, 0x10,
@@ -166,8 +175,9 @@ static const uint8_t g_spr_ePlunger[] =
     0x01, 0x10,
     0x01, 0x10,
 };
+SPRITE4_RECTS(g_rects_ePlunger, 4, 8, g_spr_ePlunger);
 
-static const uint8_t g_spr_eRoll[] =
+static constexpr uint8_t g_spr_eRoll[] =
 {
     0x01, 0x10,
     0x11, 0x11,
@@ -178,11 +188,12 @@ static const uint8_t g_spr_eRoll[] =
     0x11, 0x11,
     0x01, 0x10,
 };
+SPRITE4_RECTS(g_rects_eRoll, 4, 8, g_spr_eRoll);
 
 // -----------------------------------------------------------------------------
 // SPR_UFO (16x7) - uses index 5 (red)
 // -----------------------------------------------------------------------------
-static const uint8_t g_spr_ufo[] =
+static constexpr uint8_t g_spr_ufo[] =
 {
     0x00, 0x00, 0x05, 0x55, 0x55, 0x00, 0x00, 0x00,
     0x00, 0x05, 0x55, 0x55, 0x55, 0x55, 0x00, 0x00,
@@ -192,11 +203,12 @@ static const uint8_t g_spr_ufo[] =
     0x00, 0x55, 0x00, 0x55, 0x55, 0x00, 0x55, 0x00,
     0x00, 0x05, 0x00, 0x00, 0x00, 0x00, 0x05, 0x00,
 };
+SPRITE4_RECTS(g_rects_ufo, 16, 7, g_spr_ufo);
 
 // -----------------------------------------------------------------------------
 // SPR_BARRIER_TILE (8x8) - uses index 7 (dark green)
 // -----------------------------------------------------------------------------
-static const uint8_t g_spr_barrierTile[] =
+static constexpr uint8_t g_spr_barrierTile[] =
 {
     0x00, 0x77, 0x77, 0x00,
     0x07, 0x77, 0x77, 0x70,
@@ -207,29 +219,30 @@ static const uint8_t g_spr_barrierTile[] =
     0x77, 0x00, 0x00, 0x77,
     0x70, 0x00, 0x00, 0x07,
 };
+SPRITE4_RECTS(g_rects_barrierTile, 8, 8, g_spr_barrierTile);
 
 // -----------------------------------------------------------------------------
 // Sprite table (SPR_COUNT entries)
 // -----------------------------------------------------------------------------
 static const Sprite4 g_spritesClassic[SPR_COUNT] =
 {
-    { 16,  8, g_spr_player       }, // SPR_PLAYER
-    {  2,  4, g_spr_playerBullet }, // SPR_PLAYER_BULLET
+    { 16,  8, g_spr_player,       g_rects_player.rects,       g_rects_player.count }, // SPR_PLAYER
+    {  2,  4, g_spr_playerBullet, g_rects_playerBullet.rects, g_rects_playerBullet.count }, // SPR_PLAYER_BULLET
 
-    { 12,  8, g_spr_invA         }, // SPR_INVADER_A
-    { 12,  8, g_spr_invA2        }, // SPR_INVADER_A2
-    { 12,  8, g_spr_invB         }, // SPR_INVADER_B
-    { 12,  8, g_spr_invB2        }, // SPR_INVADER_B2
-    { 12,  8, g_spr_invC         }, // SPR_INVADER_C
-    { 12,  8, g_spr_invC2        }, // SPR_INVADER_C2
+    { 12,  8, g_spr_invA,         g_rects_invA.rects,         g_rects_invA.count }, // SPR_INVADER_A
+    { 12,  8, g_spr_invA2,        g_rects_invA2.rects,        g_rects_invA2.count }, // SPR_INVADER_A2
+    { 12,  8, g_spr_invB,         g_rects_invB.rects,         g_rects_invB.count }, // SPR_INVADER_B
+    { 12,  8, g_spr_invB2,        g_rects_invB2.rects,        g_rects_invB2.count }, // SPR_INVADER_B2
+    { 12,  8, g_spr_invC,         g_rects_invC.rects,         g_rects_invC.count }, // SPR_INVADER_C
+    { 12,  8, g_spr_invC2,        g_rects_invC2.rects,        g_rects_invC2.count }, // SPR_INVADER_C2
 
-    {  4,  8, g_spr_eZig         }, // SPR_EBULLET_ZIG
-    {  4,  8, g_spr_ePlunger     }, // SPR_EBULLET_PLUNGER
-    {  4,  8, g_spr_eRoll        }, // SPR_EBULLET_ROLL
+    {  4,  8, g_spr_eZig,         g_rects_eZig.rects,         g_rects_eZig.count }, // SPR_EBULLET_ZIG
+    {  4,  8, g_spr_ePlunger,     g_rects_ePlunger.rects,     g_rects_ePlunger.count }, // SPR_EBULLET_PLUNGER
+    {  4,  8, g_spr_eRoll,        g_rects_eRoll.rects,        g_rects_eRoll.count }, // SPR_EBULLET_ROLL
 
-    { 16,  7, g_spr_ufo          }, // SPR_UFO
+    { 16,  7, g_spr_ufo,          g_rects_ufo.rects,          g_rects_ufo.count }, // SPR_UFO
 
-    {  8,  8, g_spr_barrierTile  }, // SPR_BARRIER_TILE
+    {  8,  8, g_spr_barrierTile,  g_rects_barrierTile.rects,  g_rects_barrierTile.count }, // SPR_BARRIER_TILE
 };
 
 // -----------------------------------------------------------------------------
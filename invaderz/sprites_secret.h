@@ -27,7 +27,7 @@ static const uint32_t g_paletteSecret[16] =
 // -----------------------------------------------------------------------------
 // SPR_PLAYER (16x8) - Xbox controller inspired
 // -----------------------------------------------------------------------------
-static const uint8_t g_spr_player_xbox[] =
+static constexpr uint8_t g_spr_player_xbox[] =
 {
     0x00, 0x00, 0x02, 0x22, 0x22, 0x20, 0x00, 0x00,
     0x00, 0x02, 0x22, 0x11, 0x11, 0x22, 0x20, 0x00,
@@ -38,22 +38,24 @@ static const uint8_t g_spr_player_xbox[] =
     0x22, 0x20, 0x02, 0x02, 0x20, 0x02, 0x02, 0x22,
     0x00, 0x20, 0x00, 0x02, 0x20, 0x00, 0x02, 0x00,
 };
+SPRITE4_RECTS(g_rects_player_xbox, 16, 8, g_spr_player_xbox);
 
 // -----------------------------------------------------------------------------
 // SPR_PLAYER_BULLET (2x4) - bright lime energy
 // -----------------------------------------------------------------------------
-static const uint8_t g_spr_playerBullet_secret[] =
+static constexpr uint8_t g_spr_playerBullet_secret[] =
 {
     0x77,
     0x77,
     0x77,
     0x77,
 };
+SPRITE4_RECTS(g_rects_playerBullet_secret, 2, 4, g_spr_playerBullet_secret);
 
 // -----------------------------------------------------------------------------
 // Xbox X invaders Frame 1
 // -----------------------------------------------------------------------------
-static const uint8_t g_spr_xboxA[] =
+static constexpr uint8_t g_spr_xboxA[] =
 {
     0x00, 0x40, 0x00, 0x00, 0x04, 0x00,
     0x04, 0x24, 0x00, 0x00, 0x42, 0x40,
@@ -64,11 +66,12 @@ static const uint8_t g_spr_xboxA[] =
     0x04, 0x24, 0x00, 0x00, 0x42, 0x40,
     0x00, 0x40, 0x00, 0x00, 0x04, 0x00,
 };
+SPRITE4_RECTS(g_rects_xboxA, 12, 8, g_spr_xboxA);
 
 // -----------------------------------------------------------------------------
 // Xbox X Frame 2 - X glows
 // -----------------------------------------------------------------------------
-static const uint8_t g_spr_xboxA2[] =
+static constexpr uint8_t g_spr_xboxA2[] =
 {
     0x07, 0x40, 0x00, 0x00, 0x04, 0x70,
     0x04, 0x24, 0x00, 0x00, 0x42, 0x40,
@@ -79,11 +82,12 @@ static const uint8_t g_spr_xboxA2[] =
     0x04, 0x24, 0x00, 0x00, 0x42, 0x40,
     0x07, 0x40, 0x00, 0x00, 0x04, 0x70,
 };
+SPRITE4_RECTS(g_rects_xboxA2, 12, 8, g_spr_xboxA2);
 
 // -----------------------------------------------------------------------------
 // Xbox Orb Frame 1
 // -----------------------------------------------------------------------------
-static const uint8_t g_spr_xboxB[] =
+static constexpr uint8_t g_spr_xboxB[] =
 {
     0x00, 0x44, 0x44, 0x44, 0x40, 0x00,
     0x04, 0x42, 0x22, 0x22, 0x44, 0x00,
@@ -94,11 +98,12 @@ static const uint8_t g_spr_xboxB[] =
     0x04, 0x42, 0x22, 0x22, 0x44, 0x00,
     0x00, 0x44, 0x44, 0x44, 0x40, 0x00,
 };
+SPRITE4_RECTS(g_rects_xboxB, 12, 8, g_spr_xboxB);
 
 // -----------------------------------------------------------------------------
 // Xbox Orb Frame 2 - energy tendrils
 // -----------------------------------------------------------------------------
-static const uint8_t g_spr_xboxB2[] =
+static constexpr uint8_t g_spr_xboxB2[] =
 {
     0x07, 0x44, 0x44, 0x44, 0x40, 0x70,
     0x04, 0x42, 0x22, 0x22, 0x44, 0x00,
@@ -109,11 +114,12 @@ static const uint8_t g_spr_xboxB2[] =
     0x04, 0x42, 0x22, 0x22, 0x44, 0x00,
     0x07, 0x44, 0x44, 0x44, 0x40, 0x70,
 };
+SPRITE4_RECTS(g_rects_xboxB2, 12, 8, g_spr_xboxB2);
 
 // -----------------------------------------------------------------------------
 // Xbox Portal Frame 1
 // -----------------------------------------------------------------------------
-static const uint8_t g_spr_xboxC[] =
+static constexpr uint8_t g_spr_xboxC[] =
 {
     0x00, 0x22, 0x22, 0x22, 0x00, 0x00,
     0x02, 0x24, 0x44, 0x44, 0x20, 0x00,
@@ -124,11 +130,12 @@ static const uint8_t g_spr_xboxC[] =
     0x02, 0x24, 0x44, 0x44, 0x20, 0x00,
     0x00, 0x22, 0x22, 0x22, 0x00, 0x00,
 };
+SPRITE4_RECTS(g_rects_xboxC, 12, 8, g_spr_xboxC);
 
 // -----------------------------------------------------------------------------
 // Xbox Portal Frame 2 - portal pulses
 // -----------------------------------------------------------------------------
-static const uint8_t g_spr_xboxC2[] =
+static constexpr uint8_t g_spr_xboxC2[] =
 {
     0x00, 0x22, 0x22, 0x22, 0x00, 0x00,
     0x02, 0x27, 0x44, 0x74, 0x20, 0x00,
@@ -139,11 +146,12 @@ static const uint8_t g_spr_xboxC2[] =
     0x02, 0x27, 0x44, 0x74, 0x20, 0x00,
     0x00, 0x22, 0x22, 0x22, 0x00, 0x00,
 };
+SPRITE4_RECTS(g_rects_xboxC2, 12, 8, g_spr_xboxC2);
 
 // -----------------------------------------------------------------------------
 // Enemy bullets (4x8) - green energy
 // -----------------------------------------------------------------------------
-static const uint8_t g_spr_eZig_secret[] =
+static constexpr uint8_t g_spr_eZig_secret[] =
 {
     0x02, 0x07,
     0x70, 0x20,
@@ -154,8 +162,9 @@ static const uint8_t g_spr_eZig_secret[] =
     0x02, 0x07,
     0x70, 0x20,
 };
+SPRITE4_RECTS(g_rects_eZig_secret, 4, 8, g_spr_eZig_secret);
 
-static const uint8_t g_spr_ePlunger_secret[] =
+static constexpr uint8_t g_spr_ePlunger_secret[] =
 {
     0x07, 0x70,
     0x02, 0x20,
@@ -166,8 +175,9 @@ static const uint8_t g_spr_ePlunger_secret[] =
     0x02, 0x20,
     0x07, 0x70,
 };
+SPRITE4_RECTS(g_rects_ePlunger_secret, 4, 8, g_spr_ePlunger_secret);
 
-static const uint8_t g_spr_eRoll_secret[] =
+static constexpr uint8_t g_spr_eRoll_secret[] =
 {
     0x02, 0x27,
     0x27, 0x72,
@@ -178,11 +188,12 @@ static const uint8_t g_spr_eRoll_secret[] =
     0x27, 0x72,
     0x72, 0x22,
 };
+SPRITE4_RECTS(g_rects_eRoll_secret, 4, 8, g_spr_eRoll_secret);
 
 // -----------------------------------------------------------------------------
 // SPR_UFO (16x7) - Xbox jewel
 // -----------------------------------------------------------------------------
-static const uint8_t g_spr_xboxJewel[] =
+static constexpr uint8_t g_spr_xboxJewel[] =
 {
     0x00, 0x00, 0x44, 0x44, 0x44, 0x40, 0x00, 0x00,
     0x00, 0x44, 0x42, 0x22, 0x22, 0x44, 0x40, 0x00,
@@ -192,11 +203,12 @@ static const uint8_t g_spr_xboxJewel[] =
     0x05, 0x55, 0x05, 0x55, 0x55, 0x05, 0x55, 0x00,
     0x00, 0x05, 0x00, 0x05, 0x50, 0x00, 0x05, 0x00,
 };
+SPRITE4_RECTS(g_rects_xboxJewel, 16, 7, g_spr_xboxJewel);
 
 // -----------------------------------------------------------------------------
 // SPR_BARRIER_TILE (8x8) - tech panel
 // -----------------------------------------------------------------------------
-static const uint8_t g_spr_barrierTile_secret[] =
+static constexpr uint8_t g_spr_barrierTile_secret[] =
 {
     0x82, 0x22, 0x22, 0x28,
     0x22, 0x88, 0x88, 0x22,
@@ -207,29 +219,30 @@ static const uint8_t g_spr_barrierTile_secret[] =
     0x22, 0x88, 0x88, 0x22,
     0x82, 0x22, 0x22, 0x28,
 };
+SPRITE4_RECTS(g_rects_barrierTile_secret, 8, 8, g_spr_barrierTile_secret);
 
 // -----------------------------------------------------------------------------
 // Sprite table (SPR_COUNT entries)
 // -----------------------------------------------------------------------------
 static const Sprite4 g_spritesSecret[SPR_COUNT] =
 {
-    { 16,  8, g_spr_player_xbox         }, // SPR_PLAYER
-    {  2,  4, g_spr_playerBullet_secret }, // SPR_PLAYER_BULLET
+    { 16,  8, g_spr_player_xbox,         g_rects_player_xbox.rects,         g_rects_player_xbox.count }, // SPR_PLAYER
+    {  2,  4, g_spr_playerBullet_secret, g_rects_playerBullet_secret.rects, g_rects_playerBullet_secret.count }, // SPR_PLAYER_BULLET
 
-    { 12,  8, g_spr_xboxA               }, // SPR_INVADER_A
-    { 12,  8, g_spr_xboxA2              }, // SPR_INVADER_A2
-    { 12,  8, g_spr_xboxB               }, // SPR_INVADER_B
-    { 12,  8, g_spr_xboxB2              }, // SPR_INVADER_B2
-    { 12,  8, g_spr_xboxC               }, // SPR_INVADER_C
-    { 12,  8, g_spr_xboxC2              }, // SPR_INVADER_C2
+    { 12,  8, g_spr_xboxA,               g_rects_xboxA.rects,               g_rects_xboxA.count }, // SPR_INVADER_A
+    { 12,  8, g_spr_xboxA2,              g_rects_xboxA2.rects,              g_rects_xboxA2.count }, // SPR_INVADER_A2
+    { 12,  8, g_spr_xboxB,               g_rects_xboxB.rects,               g_rects_xboxB.count }, // SPR_INVADER_B
+    { 12,  8, g_spr_xboxB2,              g_rects_xboxB2.rects,              g_rects_xboxB2.count }, // SPR_INVADER_B2
+    { 12,  8, g_spr_xboxC,               g_rects_xboxC.rects,               g_rects_xboxC.count }, // SPR_INVADER_C
+    { 12,  8, g_spr_xboxC2,              g_rects_xboxC2.rects,              g_rects_xboxC2.count }, // SPR_INVADER_C2
 
-    {  4,  8, g_spr_eZig_secret         }, // SPR_EBULLET_ZIG
-    {  4,  8, g_spr_ePlunger_secret     }, // SPR_EBULLET_PLUNGER
-    {  4,  8, g_spr_eRoll_secret        }, // SPR_EBULLET_ROLL
+    {  4,  8, g_spr_eZig_secret,         g_rects_eZig_secret.rects,         g_rects_eZig_secret.count }, // SPR_EBULLET_ZIG
+    {  4,  8, g_spr_ePlunger_secret,     g_rects_ePlunger_secret.rects,     g_rects_ePlunger_secret.count }, // SPR_EBULLET_PLUNGER
+    {  4,  8, g_spr_eRoll_secret,        g_rects_eRoll_secret.rects,        g_rects_eRoll_secret.count }, // SPR_EBULLET_ROLL
 
-    { 16,  7, g_spr_xboxJewel           }, // SPR_UFO
+    { 16,  7, g_spr_xboxJewel,           g_rects_xboxJewel.rects,           g_rects_xboxJewel.count }, // SPR_UFO
 
-    {  8,  8, g_spr_barrierTile_secret  }, // SPR_BARRIER_TILE
+    {  8,  8, g_spr_barrierTile_secret,  g_rects_barrierTile_secret.rects,  g_rects_barrierTile_secret.count }, // SPR_BARRIER_TILE
 };
 
 // -----------------------------------------------------------------------------
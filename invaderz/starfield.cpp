@@ -0,0 +1,212 @@
+// starfield.cpp
+#include "starfield.h"
+
+#include <xtl.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include "batch.h"
+
+#if defined(_M_IX86) || defined(__SSE__)
+#include <xmmintrin.h>
+#define STARFIELD_SSE 1
+#else
+#define STARFIELD_SSE 0
+#endif
+
+// Speed of layer L is L + 1 px per frame
+static const float kLayerSpeed[STARFIELD_LAYERS] = { 1.0f, 2.0f, 3.0f };
+
+static __forceinline DWORD SfRngNext(StarfieldState& sf)
+{
+    sf.rng = sf.rng * 1664525u + 1013904223u;
+    return sf.rng;
+}
+
+static __forceinline int SfRngRange(StarfieldState& sf, int lo, int hi)
+{
+    DWORD r = SfRngNext(sf);
+    int span = (hi - lo) + 1;
+    if (span <= 0) return lo;
+    return lo + (int)((r >> 8) % (DWORD)span);
+}
+
+static __forceinline int RoundUp4(int v) { return (v + 3) & ~3; }
+
+// ------------------------------
+// Init / shutdown
+// ------------------------------
+bool Starfield_Init(StarfieldState& sf, int count, StarfieldStyle style, int width, int height, DWORD seed)
+{
+    Starfield_Shutdown(sf);
+
+    if (count < STARFIELD_LAYERS) count = STARFIELD_LAYERS;
+    if (count > STARFIELD_MAX) count = STARFIELD_MAX;
+
+    const int perLayer = RoundUp4((count + STARFIELD_LAYERS - 1) / STARFIELD_LAYERS);
+    const int total = perLayer * STARFIELD_LAYERS;
+
+    // x, y (floats) + bright, shape (bytes), each array 16-byte aligned
+    const size_t fBytes = (size_t)total * sizeof(float);
+    const size_t bBytes = (size_t)RoundUp4(total);
+    void* block = malloc(fBytes * 2 + bBytes * 2 + 16);
+    if (!block)
+        return false;
+
+    BYTE* p = (BYTE*)(((size_t)block + 15) & ~(size_t)15);
+    sf.x = (float*)p;            p += fBytes;
+    sf.y = (float*)p;            p += fBytes;
+    sf.bright = p;               p += bBytes;
+    sf.shape = p;
+
+    sf.block = block;
+    sf.count = total;
+    sf.style = style;
+    sf.width = width;
+    sf.height = height;
+    sf.rng = seed ? seed : 0x13579BDFu;
+    sf.anim = 0;
+    sf.density = 100;
+
+    for (int l = 0; l <= STARFIELD_LAYERS; ++l)
+        sf.layerStart[l] = l * perLayer;
+
+    for (int i = 0; i < total; ++i)
+    {
+        sf.x[i] = (float)SfRngRange(sf, 0, width - 1);
+        sf.y[i] = (float)SfRngRange(sf, 0, height - 1);
+        sf.bright[i] = (BYTE)SfRngRange(sf, 90, 220);
+
+        // same index pattern the old game starfield used
+        sf.shape[i] = ((i & 23) == 0) ? 2 : ((i & 15) == 0) ? 1 : 0;
+    }
+
+    return true;
+}
+
+void Starfield_Shutdown(StarfieldState& sf)
+{
+    if (sf.block) free(sf.block);
+    memset(&sf, 0, sizeof(sf));
+}
+
+// ------------------------------
+// Update
+// ------------------------------
+void Starfield_Update(StarfieldState& sf)
+{
+    if (!sf.block) return;
+
+    const float h = (float)sf.height;
+    sf.anim++;
+
+    for (int l = 0; l < STARFIELD_LAYERS; ++l)
+    {
+        const int begin = sf.layerStart[l];
+        const int end = sf.layerStart[l + 1];
+        float* y = sf.y;
+
+#if STARFIELD_SSE
+        const __m128 spd = _mm_set1_ps(kLayerSpeed[l]);
+        const __m128 hh = _mm_set1_ps(h);
+
+        for (int i = begin; i < end; i += 4)
+        {
+            __m128 v = _mm_add_ps(_mm_load_ps(&y[i]), spd);
+            __m128 wrap = _mm_cmpge_ps(v, hh);
+
+            // y -= height where wrapped (branch-free), then fix X for those lanes
+            v = _mm_sub_ps(v, _mm_and_ps(wrap, hh));
+            _mm_store_ps(&y[i], v);
+
+            int m = _mm_movemask_ps(wrap);
+            while (m)
+            {
+                const int lane = (m & 1) ? 0 : (m & 2) ? 1 : (m & 4) ? 2 : 3;
+                sf.x[i + lane] = (float)SfRngRange(sf, 0, sf.width - 1);
+                m &= m - 1;
+            }
+        }
+#else
+        const float spd = kLayerSpeed[l];
+        for (int i = begin; i < end; ++i)
+        {
+            float v = y[i] + spd;
+            if (v >= h)
+            {
+                v -= h;
+                sf.x[i] = (float)SfRngRange(sf, 0, sf.width - 1);
+            }
+            y[i] = v;
+        }
+#endif
+    }
+}
+
+// ------------------------------
+// Render
+// ------------------------------
+void Starfield_SetDensity(StarfieldState& sf, int percent)
+{
+    if (percent < 1) percent = 1;
+    if (percent > 100) percent = 100;
+    sf.density = percent;
+}
+
+static __forceinline DWORD Grey(int b)
+{
+    return D3DCOLOR_XRGB(b, b, b);
+}
+
+void Starfield_Render(StarfieldState& sf, bool secret)
+{
+    if (!sf.block) return;
+
+    for (int l = 0; l < STARFIELD_LAYERS; ++l)
+    {
+        // Attract style: one colour per layer
+        DWORD layerCol = secret ? D3DCOLOR_XRGB(120, 120, 160) : D3DCOLOR_XRGB(120, 120, 120);
+        if (l == STARFIELD_LAYERS - 1)
+            layerCol = secret ? D3DCOLOR_XRGB(180, 180, 220) : D3DCOLOR_XRGB(200, 200, 200);
+
+        int i = sf.layerStart[l];
+        const int end = i + ((sf.layerStart[l + 1] - i) * sf.density + 99) / 100;
+
+        while (i < end)
+        {
+            int got = 0;
+            BatchVertex* v = Batch_AllocQuads(NULL, end - i, got);
+
+            for (int k = 0; k < got; ++k, ++i, v += 4)
+            {
+                const float x = (float)(int)sf.x[i];
+                const float y = (float)(int)sf.y[i];
+
+                if (sf.style == STARFIELD_ATTRACT)
+                {
+                    Batch_MakeRect(v, x, y, 1.0f, 1.0f, layerCol);
+                    continue;
+                }
+
+                int bb = (int)sf.bright[i];
+
+                // tiny twinkle on a subset (no RNG)
+                if ((i & 7) == 0)
+                {
+                    int t = (sf.anim + i * 13) & 31;       // 0..31
+                    int wobble = (t < 16) ? t : (31 - t);  // 0..15 triangle wave
+                    bb += wobble * 2;
+                    if (bb > 255) bb = 255;
+                }
+
+                switch (sf.shape[i])
+                {
+                default:
+                case 0: Batch_MakeRect(v, x, y, 1.0f, 1.0f, Grey(bb)); break;
+                case 1: Batch_MakeRect(v, x, y, 2.0f, 1.0f, Grey(bb)); break;
+                case 2: Batch_MakeRect(v, x - 1.0f, y - 1.0f, 3.0f, 3.0f, Grey(bb)); break;  // "dust"
+                }
+            }
+        }
+    }
+}
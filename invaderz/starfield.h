@@ -0,0 +1,56 @@
+#pragma once
+#include <xtl.h>
+
+// -----------------------------------------------------------------------------
+// Shared scrolling starfield (game + attract).
+//
+// Stars live in structure-of-arrays form, grouped into three speed layers
+// (1, 2, 3 px per frame). Each layer is updated four stars at a time with SSE
+// and submitted as one run of quads through the 2D batch (batch.h).
+//
+// Count is rounded up so every layer is a multiple of 4; anything up to
+// STARFIELD_MAX is fine.
+// -----------------------------------------------------------------------------
+
+#define STARFIELD_MAX    8192
+#define STARFIELD_LAYERS 3
+
+enum StarfieldStyle
+{
+    STARFIELD_GAME = 0,     // per-star brightness, twinkle, a few 2x1 / 3x3 stars
+    STARFIELD_ATTRACT,      // flat grey, fastest layer brighter
+};
+
+struct StarfieldState
+{
+    // SoA, 16-byte aligned, carved out of one allocation
+    float* x;
+    float* y;
+    BYTE*  bright;      // base brightness (game style)
+    BYTE*  shape;       // 0 = 1x1, 1 = 2x1, 2 = 3x3 (game style)
+
+    int layerStart[STARFIELD_LAYERS + 1];
+    int count;
+
+    StarfieldStyle style;
+    int   width, height;
+    DWORD rng;
+    int   anim;         // twinkle phase
+    int   density;      // percent of each layer drawn (Starfield_SetDensity)
+
+    void* block;
+};
+
+bool Starfield_Init(StarfieldState& sf, int count, StarfieldStyle style, int width, int height, DWORD seed);
+void Starfield_Shutdown(StarfieldState& sf);
+
+// Scroll one frame (wrap at the bottom, new random X).
+void Starfield_Update(StarfieldState& sf);
+
+// Queue all stars (one batch run per layer). secret tints attract-style stars.
+void Starfield_Render(StarfieldState& sf, bool secret);
+
+// Draw only `percent` (1..100) of every layer; all of them keep moving, so
+// raising it again brings stars back where they would have been. Used by the
+// quality governor (quality.h).
+void Starfield_SetDensity(StarfieldState& sf, int percent);
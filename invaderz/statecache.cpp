@@ -0,0 +1,66 @@
+// statecache.cpp
+#include "statecache.h"
+
+#include <string.h>
+
+void StateCache_Reset(StateCache& c)
+{
+    memset(c.rsKnown, 0, sizeof(c.rsKnown));
+    memset(c.tssKnown, 0, sizeof(c.tssKnown));
+    memset(c.texKnown, 0, sizeof(c.texKnown));
+    c.vsKnown = 0;
+}
+
+// Shared compare-and-record for one tracked slot.
+template <typename T>
+static inline bool Track(StateCache& c, T& slot, uint8_t& known, T value)
+{
+    if (known && slot == value)
+    {
+        c.filtered++;
+        return false;
+    }
+
+    slot = value;
+    known = 1;
+    c.issued++;
+    return true;
+}
+
+bool StateCache_RenderState(StateCache& c, uint32_t state, uint32_t value)
+{
+    if (state >= SC_MAX_RENDER_STATES)
+    {
+        c.issued++;
+        return true;
+    }
+
+    return Track(c, c.rs[state], c.rsKnown[state], value);
+}
+
+bool StateCache_StageState(StateCache& c, uint32_t stage, uint32_t state, uint32_t value)
+{
+    if (stage >= SC_MAX_STAGES || state >= SC_MAX_STAGE_STATES)
+    {
+        c.issued++;
+        return true;
+    }
+
+    return Track(c, c.tss[stage][state], c.tssKnown[stage][state], value);
+}
+
+bool StateCache_Texture(StateCache& c, uint32_t stage, uintptr_t tex)
+{
+    if (stage >= SC_MAX_STAGES)
+    {
+        c.issued++;
+        return true;
+    }
+
+    return Track(c, c.tex[stage], c.texKnown[stage], tex);
+}
+
+bool StateCache_VertexShader(StateCache& c, uint32_t handle)
+{
+    return Track(c, c.vs, c.vsKnown, handle);
+}
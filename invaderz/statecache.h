@@ -0,0 +1,46 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+// -----------------------------------------------------------------------------
+// Render-state shadow (portable core of rstate.h).
+//
+// Remembers the last value sent for each render state, texture stage state,
+// bound texture and vertex shader, and tells the caller whether a new set
+// actually changes anything. No D3D types, so it can be driven on a PC with a
+// recording or null "device" (see tools/hostbench.cpp).
+//
+// Every StateCache_* setter returns true if the call must reach the device
+// (and records the new value), false if it is redundant.
+// Anything outside the tracked ranges is always passed through.
+// -----------------------------------------------------------------------------
+
+#define SC_MAX_RENDER_STATES 256
+#define SC_MAX_STAGES        4
+#define SC_MAX_STAGE_STATES  64
+
+struct StateCache
+{
+    uint32_t  rs[SC_MAX_RENDER_STATES];
+    uint8_t   rsKnown[SC_MAX_RENDER_STATES];
+
+    uint32_t  tss[SC_MAX_STAGES][SC_MAX_STAGE_STATES];
+    uint8_t   tssKnown[SC_MAX_STAGES][SC_MAX_STAGE_STATES];
+
+    uintptr_t tex[SC_MAX_STAGES];
+    uint8_t   texKnown[SC_MAX_STAGES];
+
+    uint32_t  vs;
+    uint8_t   vsKnown;
+
+    uint32_t  issued;      // calls that went through
+    uint32_t  filtered;    // calls dropped as redundant
+};
+
+// Forgets all tracked values (next set of anything is issued). Keeps counters.
+void StateCache_Reset(StateCache& c);
+
+bool StateCache_RenderState(StateCache& c, uint32_t state, uint32_t value);
+bool StateCache_StageState(StateCache& c, uint32_t stage, uint32_t state, uint32_t value);
+bool StateCache_Texture(StateCache& c, uint32_t stage, uintptr_t tex);
+bool StateCache_VertexShader(StateCache& c, uint32_t handle);
@@ -0,0 +1,35 @@
+// strfmt.cpp
+#include "strfmt.h"
+
+char* StrFmt_Append(char* dst, const char* s)
+{
+    while (*s) *dst++ = *s++;
+    *dst = 0;
+    return dst;
+}
+
+char* StrFmt_AppendN(char* dst, const char* s, int maxChars)
+{
+    int n = 0;
+    while (*s && n++ < maxChars) *dst++ = *s++;
+    *dst = 0;
+    return dst;
+}
+
+char* StrFmt_AppendUInt(char* dst, uint32_t v)
+{
+    char tmp[16];
+    int n = 0;
+
+    do
+    {
+        tmp[n++] = (char)('0' + (v % 10));
+        v /= 10;
+    } while (v > 0 && n < (int)sizeof(tmp));
+
+    while (n > 0)
+        *dst++ = tmp[--n];
+
+    *dst = 0;
+    return dst;
+}
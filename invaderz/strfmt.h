@@ -0,0 +1,21 @@
+#pragma once
+#include <stdint.h>
+
+// -----------------------------------------------------------------------------
+// Tiny text formatting helpers (no sprintf / no stdio) for the debug log
+// lines and overlays (perf.cpp, quality.cpp, texload.cpp).
+//
+// Each call writes at `dst`, NUL-terminates, and returns the new end, so
+// calls chain:
+//   char line[64];
+//   char* p = StrFmt_Append(line, "draws=");
+//   p = StrFmt_AppendUInt(p, n);
+// The caller's buffer must be big enough.
+// -----------------------------------------------------------------------------
+
+char* StrFmt_Append(char* dst, const char* s);
+
+// At most `maxChars` of `s` (for paths and other text from outside).
+char* StrFmt_AppendN(char* dst, const char* s, int maxChars);
+
+char* StrFmt_AppendUInt(char* dst, uint32_t v);
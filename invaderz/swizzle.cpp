@@ -0,0 +1,408 @@
+// swizzle.cpp
+#include "swizzle.h"
+
+#include <string.h>
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__SSE__)
+#include <xmmintrin.h>
+#define SWIZZLE_HAVE_SSE 1
+#else
+#define SWIZZLE_HAVE_SSE 0
+#endif
+
+#if defined(__BMI2__)
+#include <immintrin.h>
+#define SWIZZLE_HAVE_PDEP 1
+#else
+#define SWIZZLE_HAVE_PDEP 0
+#endif
+
+// In-place swizzle works on 8x8 tiles through one strip of 8 rows
+static const int SWIZZLE_TILE = 8;
+static const int SWIZZLE_MAX_DIM = 1024;
+static const int SWIZZLE_MAX_TILES = (SWIZZLE_MAX_DIM / SWIZZLE_TILE) * (SWIZZLE_MAX_DIM / SWIZZLE_TILE);
+
+static uint32_t s_strip[SWIZZLE_TILE * SWIZZLE_MAX_DIM];                // 32KB
+static uint32_t s_tileA[SWIZZLE_TILE * SWIZZLE_TILE];
+static uint32_t s_tileB[SWIZZLE_TILE * SWIZZLE_TILE];
+static uint8_t s_tileDone[SWIZZLE_MAX_TILES / 8];
+
+// ------------------------------
+// Bit helpers
+// ------------------------------
+
+// Offset bits taken by x and by y in a w x h texture.
+static void Masks(int w, int h, uint32_t& mx, uint32_t& my)
+{
+    mx = 0;
+    my = 0;
+
+    uint32_t bit = 1;
+    for (int sx = 1, sy = 1; sx < w || sy < h; )
+    {
+        if (sx < w) { mx |= bit; bit <<= 1; sx <<= 1; }
+        if (sy < h) { my |= bit; bit <<= 1; sy <<= 1; }
+    }
+}
+
+// Spreads the low bits of v over the set bits of mask (a portable PDEP).
+static inline uint32_t Deposit(uint32_t v, uint32_t mask)
+{
+    uint32_t out = 0;
+    for (uint32_t bit = 1; mask; bit <<= 1)
+    {
+        const uint32_t low = mask & (0u - mask);
+        if (v & bit) out |= low;
+        mask &= mask - 1;
+    }
+    return out;
+}
+
+// (sx + inc) within the bits of mask
+static inline uint32_t MaskedAdd(uint32_t sx, uint32_t inc, uint32_t mask)
+{
+    return ((sx | ~mask) + inc) & mask;
+}
+
+uint32_t Swizzle_Offset(int x, int y, int w, int h)
+{
+    uint32_t off = 0;
+    uint32_t bit = 1;
+    int i = 0;
+
+    for (int sx = 1, sy = 1; sx < w || sy < h; ++i)
+    {
+        if (sx < w)
+        {
+            if ((x >> i) & 1) off |= bit;
+            bit <<= 1;
+            sx <<= 1;
+        }
+        if (sy < h)
+        {
+            if ((y >> i) & 1) off |= bit;
+            bit <<= 1;
+            sy <<= 1;
+        }
+    }
+    return off;
+}
+
+// ------------------------------
+// Kernels
+// ------------------------------
+struct SwizzleJob
+{
+    const uint8_t* lin;     // linear side, row y0
+    int pitch;              // bytes between linear rows
+    uint32_t* swz;          // swizzled texture
+    int w, h, y0, rows;
+    uint32_t mx, my;
+};
+
+static void Rows_Scalar(const SwizzleJob& j)
+{
+    for (int r = 0; r < j.rows; ++r)
+    {
+        const uint32_t* s = (const uint32_t*)(j.lin + r * j.pitch);
+        for (int x = 0; x < j.w; ++x)
+            j.swz[Swizzle_Offset(x, j.y0 + r, j.w, j.h)] = s[x];
+    }
+}
+
+static void Unrows_Scalar(const SwizzleJob& j)
+{
+    for (int r = 0; r < j.rows; ++r)
+    {
+        uint32_t* d = (uint32_t*)(j.lin + r * j.pitch);
+        for (int x = 0; x < j.w; ++x)
+            d[x] = j.swz[Swizzle_Offset(x, j.y0 + r, j.w, j.h)];
+    }
+}
+
+static void Rows_Step(const SwizzleJob& j)
+{
+    for (int r = 0; r < j.rows; ++r)
+    {
+        const uint32_t* s = (const uint32_t*)(j.lin + r * j.pitch);
+        uint32_t* d = j.swz + Deposit((uint32_t)(j.y0 + r), j.my);
+
+        uint32_t sx = 0;
+        for (int x = 0; x < j.w; ++x)
+        {
+            d[sx] = s[x];
+            sx = (sx - j.mx) & j.mx;
+        }
+    }
+}
+
+static void Unrows_Step(const SwizzleJob& j)
+{
+    for (int r = 0; r < j.rows; ++r)
+    {
+        uint32_t* d = (uint32_t*)(j.lin + r * j.pitch);
+        const uint32_t* s = j.swz + Deposit((uint32_t)(j.y0 + r), j.my);
+
+        uint32_t sx = 0;
+        for (int x = 0; x < j.w; ++x)
+        {
+            d[x] = s[sx];
+            sx = (sx - j.mx) & j.mx;
+        }
+    }
+}
+
+#if SWIZZLE_HAVE_SSE
+// With w >= 4 and h >= 2 the low offset bits are x0, y0, x1: texels x..x+3 of
+// an even row and the row under it are 8 consecutive swizzled texels, as two
+// 2x2 quads. Pure moves (movlhps / movhlps), so the float type is harmless.
+static bool SseFits(const SwizzleJob& j)
+{
+    return j.w >= 4 && j.h >= 2 && ((j.y0 | j.rows) & 1) == 0 &&
+           ((size_t)j.swz & 15) == 0;
+}
+
+static void Rows_SSE(const SwizzleJob& j)
+{
+    if (!SseFits(j))
+    {
+        Rows_Step(j);
+        return;
+    }
+
+    const uint32_t inc4 = Deposit(4, j.mx);
+
+    for (int r = 0; r < j.rows; r += 2)
+    {
+        const float* s0 = (const float*)(j.lin + r * j.pitch);
+        const float* s1 = (const float*)(j.lin + (r + 1) * j.pitch);
+        float* d = (float*)(j.swz + Deposit((uint32_t)(j.y0 + r), j.my));
+
+        uint32_t sx = 0;
+        for (int x = 0; x < j.w; x += 4)
+        {
+            const __m128 a = _mm_loadu_ps(s0 + x);
+            const __m128 b = _mm_loadu_ps(s1 + x);
+
+            _mm_store_ps(d + sx, _mm_movelh_ps(a, b));          // a0 a1 b0 b1
+            _mm_store_ps(d + sx + 4, _mm_movehl_ps(b, a));      // a2 a3 b2 b3
+
+            sx = MaskedAdd(sx, inc4, j.mx);
+        }
+    }
+}
+
+static void Unrows_SSE(const SwizzleJob& j)
+{
+    if (!SseFits(j))
+    {
+        Unrows_Step(j);
+        return;
+    }
+
+    const uint32_t inc4 = Deposit(4, j.mx);
+
+    for (int r = 0; r < j.rows; r += 2)
+    {
+        float* d0 = (float*)(j.lin + r * j.pitch);
+        float* d1 = (float*)(j.lin + (r + 1) * j.pitch);
+        const float* s = (const float*)(j.swz + Deposit((uint32_t)(j.y0 + r), j.my));
+
+        uint32_t sx = 0;
+        for (int x = 0; x < j.w; x += 4)
+        {
+            const __m128 q0 = _mm_load_ps(s + sx);
+            const __m128 q1 = _mm_load_ps(s + sx + 4);
+
+            _mm_storeu_ps(d0 + x, _mm_movelh_ps(q0, q1));
+            _mm_storeu_ps(d1 + x, _mm_movehl_ps(q1, q0));
+
+            sx = MaskedAdd(sx, inc4, j.mx);
+        }
+    }
+}
+#endif
+
+#if SWIZZLE_HAVE_PDEP
+static void Rows_Pdep(const SwizzleJob& j)
+{
+    for (int r = 0; r < j.rows; ++r)
+    {
+        const uint32_t* s = (const uint32_t*)(j.lin + r * j.pitch);
+        uint32_t* d = j.swz + _pdep_u32((uint32_t)(j.y0 + r), j.my);
+
+        for (int x = 0; x < j.w; ++x)
+            d[_pdep_u32((uint32_t)x, j.mx)] = s[x];
+    }
+}
+
+static void Unrows_Pdep(const SwizzleJob& j)
+{
+    for (int r = 0; r < j.rows; ++r)
+    {
+        uint32_t* d = (uint32_t*)(j.lin + r * j.pitch);
+        const uint32_t* s = j.swz + _pdep_u32((uint32_t)(j.y0 + r), j.my);
+
+        for (int x = 0; x < j.w; ++x)
+            d[x] = s[_pdep_u32((uint32_t)x, j.mx)];
+    }
+}
+#endif
+
+struct SwizzleKernels
+{
+    void (*rows)(const SwizzleJob&);
+    void (*unrows)(const SwizzleJob&);
+};
+
+static const SwizzleKernels kKernels[SWIZZLE_KERNEL_COUNT] =
+{
+    { Rows_Scalar, Unrows_Scalar },
+    { Rows_Step, Unrows_Step },
+#if SWIZZLE_HAVE_SSE
+    { Rows_SSE, Unrows_SSE },
+#else
+    { NULL, NULL },
+#endif
+#if SWIZZLE_HAVE_PDEP
+    { Rows_Pdep, Unrows_Pdep },
+#else
+    { NULL, NULL },
+#endif
+};
+
+static const char* const kKernelNames[SWIZZLE_KERNEL_COUNT] = { "scalar", "step", "sse", "pdep" };
+
+static Swizzle_Kernel s_kernel = SWIZZLE_HAVE_SSE ? SWIZZLE_KERNEL_SSE : SWIZZLE_KERNEL_STEP;
+
+static void MakeJob(SwizzleJob& j, const void* lin, int pitch, void* swz, int w, int h, int y0, int rows)
+{
+    j.lin = (const uint8_t*)lin;
+    j.pitch = pitch;
+    j.swz = (uint32_t*)swz;
+    j.w = w;
+    j.h = h;
+    j.y0 = y0;
+    j.rows = rows;
+    Masks(w, h, j.mx, j.my);
+}
+
+// ------------------------------
+// Public API
+// ------------------------------
+void Swizzle_Rows32(const void* src, int srcPitch, void* dst, int w, int h, int y0, int rows)
+{
+    if (!src || !dst || w <= 0 || h <= 0 || y0 < 0 || rows <= 0 || y0 + rows > h) return;
+
+    SwizzleJob j;
+    MakeJob(j, src, srcPitch, dst, w, h, y0, rows);
+    kKernels[s_kernel].rows(j);
+}
+
+void Swizzle_Rect32(const void* src, int srcPitch, void* dst, int w, int h)
+{
+    Swizzle_Rows32(src, srcPitch, dst, w, h, 0, h);
+}
+
+void Swizzle_Unrect32(const void* src, int w, int h, void* dst, int dstPitch)
+{
+    if (!src || !dst || w <= 0 || h <= 0) return;
+
+    SwizzleJob j;
+    MakeJob(j, dst, dstPitch, (void*)src, w, h, 0, h);
+    kKernels[s_kernel].unrows(j);
+}
+
+bool Swizzle_InPlace32(void* texels, int w, int h)
+{
+    if (!texels || w <= 0 || h <= 0 || w > SWIZZLE_MAX_DIM || h > SWIZZLE_MAX_DIM)
+        return false;
+    if ((w & (w - 1)) != 0 || (h & (h - 1)) != 0)
+        return false;
+
+    uint32_t* t = (uint32_t*)texels;
+    const int T = SWIZZLE_TILE;
+
+    // Small enough to copy out whole
+    if (w * h <= (int)(sizeof(s_strip) / sizeof(s_strip[0])))
+    {
+        memcpy(s_strip, t, (size_t)(w * h) * sizeof(uint32_t));
+        Swizzle_Rect32(s_strip, w * 4, t, w, h);
+        return true;
+    }
+
+    // Both sides are >= 8 here. The swizzled layout is 8x8 tiles, each
+    // swizzled on its own (the low 6 offset bits), laid out in the swizzled
+    // order of the tile grid (the rest). First swizzle every tile where it
+    // lies, turning each 8-row strip into a row of 64-texel tiles...
+    for (int y = 0; y < h; y += T)
+    {
+        uint32_t* strip = t + y * w;
+        memcpy(s_strip, strip, (size_t)(T * w) * sizeof(uint32_t));
+
+        for (int x = 0; x < w; x += T)
+            Swizzle_Rect32(s_strip + x, w * 4, strip + x * T, T, T);
+    }
+
+    // ...then move the tiles to their swizzled slots, one permutation cycle
+    // at a time.
+    const int tw = w / T;
+    const int tiles = tw * (h / T);
+    int twShift = 0;
+    while ((1 << twShift) < tw) ++twShift;
+
+    uint32_t tmx, tmy;
+    Masks(tw, h / T, tmx, tmy);
+
+    memset(s_tileDone, 0, (size_t)(tiles + 7) / 8);
+
+    const size_t tileBytes = (size_t)(T * T) * sizeof(uint32_t);
+    for (int i = 0; i < tiles; ++i)
+    {
+        if (s_tileDone[i >> 3] & (1 << (i & 7))) continue;
+
+        uint32_t* carry = s_tileA;
+        uint32_t* spare = s_tileB;
+        memcpy(carry, t + i * T * T, tileBytes);
+
+        int at = i;
+        do
+        {
+            const int to = (int)(Deposit((uint32_t)(at & (tw - 1)), tmx) |
+                                 Deposit((uint32_t)(at >> twShift), tmy));
+
+            memcpy(spare, t + to * T * T, tileBytes);
+            memcpy(t + to * T * T, carry, tileBytes);
+            s_tileDone[to >> 3] |= (uint8_t)(1 << (to & 7));
+
+            uint32_t* swap = carry;
+            carry = spare;
+            spare = swap;
+            at = to;
+        } while (at != i);
+    }
+
+    return true;
+}
+
+bool Swizzle_KernelAvailable(Swizzle_Kernel k)
+{
+    return (unsigned)k < (unsigned)SWIZZLE_KERNEL_COUNT && kKernels[k].rows != NULL;
+}
+
+bool Swizzle_SetKernel(Swizzle_Kernel k)
+{
+    if (!Swizzle_KernelAvailable(k)) return false;
+    s_kernel = k;
+    return true;
+}
+
+Swizzle_Kernel Swizzle_GetKernel()
+{
+    return s_kernel;
+}
+
+const char* Swizzle_KernelName(Swizzle_Kernel k)
+{
+    return ((unsigned)k < (unsigned)SWIZZLE_KERNEL_COUNT) ? kKernelNames[k] : "?";
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include <stdint.h>
+
+// -----------------------------------------------------------------------------
+// Xbox swizzled texture layout (32bpp, power-of-two sizes).
+//
+// A swizzled texel's offset interleaves the bits of its coordinates, x first:
+//   bit 0 = x0, bit 1 = y0, bit 2 = x1, bit 3 = y1, ...
+// until the smaller dimension runs out of bits; the larger one's remaining
+// bits follow in order. This is the layout XGSwizzleRect produces. Having our
+// own lets the loaders swizzle without a staging copy (Swizzle_Rows32,
+// Swizzle_InPlace32) and lets the host tools run and time the same code.
+//
+// Kernels (same output, picked at build time; Swizzle_SetKernel for tests):
+//   scalar  per-texel offsets from the bit loop in Swizzle_Offset (reference)
+//   step    per-texel masked increment of the swizzled x offset
+//   sse     2 rows x 4 texels at a time (SSE1 movlhps/movhlps, so it runs on
+//           the Pentium III); needs w >= 4 and h >= 2
+//   pdep    BMI2 bit deposit per texel (host builds with -mbmi2 only)
+// -----------------------------------------------------------------------------
+
+enum Swizzle_Kernel
+{
+    SWIZZLE_KERNEL_SCALAR = 0,
+    SWIZZLE_KERNEL_STEP,
+    SWIZZLE_KERNEL_SSE,
+    SWIZZLE_KERNEL_PDEP,
+
+    SWIZZLE_KERNEL_COUNT
+};
+
+// Offset in texels of (x, y) in a swizzled w x h texture.
+uint32_t Swizzle_Offset(int x, int y, int w, int h);
+
+// Swizzles `rows` linear rows (`srcPitch` bytes apart) into texture rows
+// y0..y0+rows-1 of the swizzled w x h texture at `dst`. Lets a loader fill a
+// locked texture strip by strip from a small buffer.
+void Swizzle_Rows32(const void* src, int srcPitch, void* dst, int w, int h, int y0, int rows);
+
+// Whole texture, linear -> swizzled and back.
+void Swizzle_Rect32(const void* src, int srcPitch, void* dst, int w, int h);
+void Swizzle_Unrect32(const void* src, int w, int h, void* dst, int dstPitch);
+
+// Linear (rows packed) -> swizzled in the same memory, e.g. a locked texture
+// the file was read straight into. Works through a fixed 32KB scratch strip
+// (not thread-safe), so w and h are limited to 1024; false (texels untouched)
+// if the size isn't supported.
+bool Swizzle_InPlace32(void* texels, int w, int h);
+
+bool Swizzle_KernelAvailable(Swizzle_Kernel k);
+bool Swizzle_SetKernel(Swizzle_Kernel k);
+Swizzle_Kernel Swizzle_GetKernel();
+const char* Swizzle_KernelName(Swizzle_Kernel k);
@@ -0,0 +1,229 @@
+// texfmt.cpp
+#include "texfmt.h"
+
+#include <string.h>
+
+// ------------------------------
+// Formats
+// ------------------------------
+TexFmt TexFmt_FromDDS(uint32_t flags, uint32_t fourCC, uint32_t rgbBitCount,
+                      uint32_t rMask, uint32_t gMask, uint32_t bMask, uint32_t aMask)
+{
+    if (flags & DDPF_FOURCC)
+    {
+        if (fourCC == FOURCC_DXT1) return TEXFMT_DXT1;
+        if (fourCC == FOURCC_DXT4) return TEXFMT_DXT4;
+        if (fourCC == FOURCC_DXT5) return TEXFMT_DXT5;
+        return TEXFMT_UNKNOWN;
+    }
+
+    if (flags & DDPF_PALETTEINDEXED8)
+        return (rgbBitCount == 8) ? TEXFMT_P8 : TEXFMT_UNKNOWN;
+
+    if (rgbBitCount == 32 &&
+        (flags & (DDPF_RGB | DDPF_ALPHAPIXELS)) == (DDPF_RGB | DDPF_ALPHAPIXELS) &&
+        rMask == 0x00FF0000 && gMask == 0x0000FF00 &&
+        bMask == 0x000000FF && aMask == 0xFF000000)
+    {
+        return TEXFMT_A8R8G8B8;
+    }
+
+    return TEXFMT_UNKNOWN;
+}
+
+const char* TexFmt_Name(TexFmt fmt)
+{
+    switch (fmt)
+    {
+    case TEXFMT_A8R8G8B8: return "A8R8G8B8";
+    case TEXFMT_DXT1:     return "DXT1";
+    case TEXFMT_DXT4:     return "DXT4";
+    case TEXFMT_DXT5:     return "DXT5";
+    case TEXFMT_P8:       return "P8";
+    default:              return "unknown";
+    }
+}
+
+uint32_t TexFmt_DataBytes(TexFmt fmt, int w, int h)
+{
+    if (w <= 0 || h <= 0) return 0;
+
+    const uint32_t blocks = (uint32_t)((w + 3) / 4) * (uint32_t)((h + 3) / 4);
+
+    switch (fmt)
+    {
+    case TEXFMT_A8R8G8B8: return (uint32_t)w * (uint32_t)h * 4;
+    case TEXFMT_DXT1:     return blocks * 8;
+    case TEXFMT_DXT4:
+    case TEXFMT_DXT5:     return blocks * 16;
+    case TEXFMT_P8:       return 256 * 4 + (uint32_t)w * (uint32_t)h;
+    default:              return 0;
+    }
+}
+
+uint32_t TexFmt_RowBytes(TexFmt fmt, int w)
+{
+    if (w <= 0) return 0;
+
+    switch (fmt)
+    {
+    case TEXFMT_A8R8G8B8: return (uint32_t)w * 4;
+    case TEXFMT_DXT1:     return (uint32_t)((w + 3) / 4) * 8;
+    case TEXFMT_DXT4:
+    case TEXFMT_DXT5:     return (uint32_t)((w + 3) / 4) * 16;
+    case TEXFMT_P8:       return (uint32_t)w;
+    default:              return 0;
+    }
+}
+
+// ------------------------------
+// DXT
+// ------------------------------
+bool TexFmt_IsBlock(TexFmt fmt)
+{
+    return fmt == TEXFMT_DXT1 || fmt == TEXFMT_DXT4 || fmt == TEXFMT_DXT5;
+}
+
+static inline uint32_t Expand565(uint32_t c)
+{
+    const uint32_t r = (c >> 11) & 31;
+    const uint32_t g = (c >> 5) & 63;
+    const uint32_t b = c & 31;
+
+    return ((r << 3 | r >> 2) << 16) | ((g << 2 | g >> 4) << 8) | (b << 3 | b >> 2);
+}
+
+// Weighted mix of two 0x00RRGGBB colours, (a*wa + b*wb) / div per channel.
+static inline uint32_t Mix(uint32_t a, uint32_t b, uint32_t wa, uint32_t wb, uint32_t div)
+{
+    uint32_t out = 0;
+    for (int s = 0; s < 24; s += 8)
+    {
+        const uint32_t ca = (a >> s) & 0xFF;
+        const uint32_t cb = (b >> s) & 0xFF;
+        out |= ((ca * wa + cb * wb) / div) << s;
+    }
+    return out;
+}
+
+// Colour half of a block. `opaqueOnly` is set for DXT4/5, whose colour block
+// always uses the four-colour mode.
+static void DecodeColor(const uint8_t* b, bool opaqueOnly, uint32_t out[16])
+{
+    const uint32_t c0 = (uint32_t)b[0] | ((uint32_t)b[1] << 8);
+    const uint32_t c1 = (uint32_t)b[2] | ((uint32_t)b[3] << 8);
+
+    uint32_t pal[4];
+    pal[0] = Expand565(c0) | 0xFF000000;
+    pal[1] = Expand565(c1) | 0xFF000000;
+
+    if (c0 > c1 || opaqueOnly)
+    {
+        pal[2] = Mix(pal[0], pal[1], 2, 1, 3) | 0xFF000000;
+        pal[3] = Mix(pal[0], pal[1], 1, 2, 3) | 0xFF000000;
+    }
+    else
+    {
+        pal[2] = Mix(pal[0], pal[1], 1, 1, 2) | 0xFF000000;
+        pal[3] = 0;                                     // transparent black
+    }
+
+    uint32_t bits = (uint32_t)b[4] | ((uint32_t)b[5] << 8) |
+                    ((uint32_t)b[6] << 16) | ((uint32_t)b[7] << 24);
+
+    for (int i = 0; i < 16; ++i, bits >>= 2)
+        out[i] = pal[bits & 3];
+}
+
+static void DecodeAlpha(const uint8_t* b, uint32_t out[16])
+{
+    const uint32_t a0 = b[0];
+    const uint32_t a1 = b[1];
+
+    uint32_t pal[8];
+    pal[0] = a0;
+    pal[1] = a1;
+
+    if (a0 > a1)
+    {
+        for (uint32_t i = 1; i < 7; ++i)
+            pal[i + 1] = ((7 - i) * a0 + i * a1) / 7;
+    }
+    else
+    {
+        for (uint32_t i = 1; i < 5; ++i)
+            pal[i + 1] = ((5 - i) * a0 + i * a1) / 5;
+        pal[6] = 0;
+        pal[7] = 255;
+    }
+
+    // 16 3-bit indices, little-endian across the remaining 6 bytes
+    uint64_t bits = 0;
+    for (int i = 5; i >= 0; --i)
+        bits = (bits << 8) | b[2 + i];
+
+    for (int i = 0; i < 16; ++i, bits >>= 3)
+        out[i] = (out[i] & 0x00FFFFFF) | (pal[bits & 7] << 24);
+}
+
+void TexFmt_DecodeBlock(TexFmt fmt, const uint8_t* block, uint32_t out[16])
+{
+    if (fmt == TEXFMT_DXT4 || fmt == TEXFMT_DXT5)
+    {
+        DecodeColor(block + 8, true, out);
+        DecodeAlpha(block, out);
+    }
+    else
+    {
+        DecodeColor(block, false, out);
+    }
+}
+
+void TexFmt_DecodeDXT(TexFmt fmt, const void* src, int srcPitch, int w, int h,
+                      uint32_t* dst, int dstPitch)
+{
+    if (!TexFmt_IsBlock(fmt)) return;
+
+    const int blockBytes = (fmt == TEXFMT_DXT1) ? 8 : 16;
+
+    for (int by = 0; by < h; by += 4)
+    {
+        const uint8_t* row = (const uint8_t*)src + (by / 4) * srcPitch;
+        const int rows = (h - by < 4) ? h - by : 4;
+
+        for (int bx = 0; bx < w; bx += 4, row += blockBytes)
+        {
+            uint32_t texels[16];
+            TexFmt_DecodeBlock(fmt, row, texels);
+
+            const int cols = (w - bx < 4) ? w - bx : 4;
+            for (int y = 0; y < rows; ++y)
+            {
+                uint32_t* d = (uint32_t*)((uint8_t*)dst + (by + y) * dstPitch) + bx;
+                memcpy(d, texels + y * 4, (size_t)cols * sizeof(uint32_t));
+            }
+        }
+    }
+}
+
+// ------------------------------
+// P8
+// ------------------------------
+void TexFmt_P8Palette(const void* entries, uint32_t pal[256])
+{
+    const uint8_t* p = (const uint8_t*)entries;
+
+    for (int i = 0; i < 256; ++i, p += 4)
+        pal[i] = ((uint32_t)p[3] << 24) | ((uint32_t)p[0] << 16) | ((uint32_t)p[1] << 8) | p[2];
+}
+
+void TexFmt_ExpandP8(const void* data, int w, int h, uint32_t* dst)
+{
+    uint32_t pal[256];
+    TexFmt_P8Palette(data, pal);
+
+    const uint8_t* p = (const uint8_t*)data + 256 * 4;
+    const int count = w * h;
+    for (int i = 0; i < count; ++i)
+        dst[i] = pal[p[i]];
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include <stdint.h>
+
+// -----------------------------------------------------------------------------
+// Texture asset formats and their software decoders.
+//
+// The DDS loaders (title.cpp, game.cpp, attract.cpp, through texload.h) take
+// raw A8R8G8B8, the block-compressed DXT1/DXT4/DXT5 and 8-bit paletted P8. This
+// file knows how each is laid out in a .dds and how to turn it back into
+// A8R8G8B8; it has no Xbox dependencies so the host tools (tools/texcook.cpp)
+// and the draw stream recorder share it.
+//
+// Level 0 only; mip chains after it are ignored. Data layout after the header:
+//   A8R8G8B8  w*h DWORDs, 0xAARRGGBB
+//   DXT1      (w/4)*(h/4) 8-byte blocks, rows of blocks top to bottom
+//   DXT5      (w/4)*(h/4) 16-byte blocks (8 bytes alpha, then a DXT1 block)
+//   DXT4      DXT5 layout, colour already multiplied by alpha
+//   P8        256 palette entries (R, G, B, A bytes), then w*h indices
+//
+// Decoded texels are 0xAARRGGBB like the raw format.
+// -----------------------------------------------------------------------------
+
+#define DDS_MAGIC            0x20534444u     // "DDS "
+
+// DDS_PIXELFORMAT flags
+#define DDPF_ALPHAPIXELS     0x00000001u
+#define DDPF_FOURCC          0x00000004u
+#define DDPF_PALETTEINDEXED8 0x00000020u
+#define DDPF_RGB             0x00000040u
+#define DDPF_ALPHAPREMULT    0x00008000u     // colour already multiplied by alpha (texcook)
+
+#define FOURCC_DXT1          0x31545844u     // "DXT1"
+#define FOURCC_DXT4          0x34545844u     // "DXT4"
+#define FOURCC_DXT5          0x35545844u     // "DXT5"
+
+enum TexFmt
+{
+    TEXFMT_UNKNOWN = 0,
+    TEXFMT_A8R8G8B8,
+    TEXFMT_DXT1,
+    TEXFMT_DXT4,            // premultiplied DXT5
+    TEXFMT_DXT5,
+    TEXFMT_P8,
+};
+
+// Format described by a DDS_PIXELFORMAT, or TEXFMT_UNKNOWN.
+TexFmt TexFmt_FromDDS(uint32_t flags, uint32_t fourCC, uint32_t rgbBitCount,
+                      uint32_t rMask, uint32_t gMask, uint32_t bMask, uint32_t aMask);
+
+const char* TexFmt_Name(TexFmt fmt);
+
+// Bytes of level 0 data following the header (P8 includes its palette).
+uint32_t TexFmt_DataBytes(TexFmt fmt, int w, int h);
+
+// Bytes per row of level 0: a row of 4x4 blocks for DXT, of texels otherwise
+// (P8 rows start after the palette).
+uint32_t TexFmt_RowBytes(TexFmt fmt, int w);
+
+// Decodes one 4x4 block to 16 texels, row-major.
+void TexFmt_DecodeBlock(TexFmt fmt, const uint8_t* block, uint32_t out[16]);
+
+// True for the DXT formats (block data, kept compressed in texture memory).
+bool TexFmt_IsBlock(TexFmt fmt);
+
+// Decodes a DXT1/DXT4/DXT5 image. `srcPitch` is bytes per row of blocks and
+// `dstPitch` bytes per row of texels. Sizes that aren't a multiple of 4 are
+// clipped.
+void TexFmt_DecodeDXT(TexFmt fmt, const void* src, int srcPitch, int w, int h,
+                      uint32_t* dst, int dstPitch);
+
+// Expands P8 data as stored in the file (palette + indices) to w*h texels.
+void TexFmt_ExpandP8(const void* data, int w, int h, uint32_t* dst);
+
+// The 1024-byte palette as stored in the file, as 256 texels; for expanding
+// the indices a few rows at a time.
+void TexFmt_P8Palette(const void* entries, uint32_t pal[256]);
@@ -0,0 +1,419 @@
+// texload.cpp
+#include "texload.h"
+
+#include <xgraphics.h>
+#include <string.h>
+
+#include "colorkey.h"
+#include "swizzle.h"
+#include "strfmt.h"
+
+#if defined(_DEBUG)
+#define TEXLOAD_LOG 1
+#else
+#define TEXLOAD_LOG 0
+#endif
+
+extern LPDIRECT3DDEVICE8 g_pDevice;
+
+#pragma pack(push, 1)
+struct DDS_PIXELFORMAT
+{
+    DWORD size;
+    DWORD flags;
+    DWORD fourCC;
+    DWORD rgbBitCount;
+    DWORD rMask;
+    DWORD gMask;
+    DWORD bMask;
+    DWORD aMask;
+};
+
+struct DDS_HEADER
+{
+    DWORD           size;
+    DWORD           flags;
+    DWORD           height;
+    DWORD           width;
+    DWORD           pitchOrLinearSize;
+    DWORD           depth;
+    DWORD           mipMapCount;
+    DWORD           reserved1[11];
+    DDS_PIXELFORMAT ddspf;
+    DWORD           caps;
+    DWORD           caps2;
+    DWORD           caps3;
+    DWORD           caps4;
+    DWORD           reserved2;
+};
+#pragma pack(pop)
+
+// Everything between the file and the texture goes through here
+static const int TEXLOAD_SCRATCH_TEXELS = 8192;                          // 32KB
+static DWORD s_scratch[TEXLOAD_SCRATCH_TEXELS];
+
+#if TEXLOAD_LOG
+// Free physical memory at TexLoad_BeginMemSpan and the lowest seen since
+static DWORD s_memStart = 0;
+static DWORD s_memLow = 0;
+#endif
+
+#if TEXLOAD_LOG
+// Compares swizzle.cpp with XGSwizzleRect once, on a few shapes (in the
+// scratch buffer, before the first load uses it)
+static void CheckSwizzle()
+{
+    static bool s_checked = false;
+    if (s_checked) return;
+    s_checked = true;
+
+    static const int kSizes[][2] = { { 64, 32 }, { 32, 64 }, { 16, 16 }, { 4, 2 } };
+    const int maxTexels = 64 * 32;
+
+    DWORD* lin = s_scratch;
+    DWORD* ours = lin + maxTexels;
+    DWORD* ref = ours + maxTexels;
+
+    for (int i = 0; i < maxTexels; ++i)
+        lin[i] = (DWORD)i * 2654435761u;
+
+    bool same = true;
+    for (int i = 0; i < (int)(sizeof(kSizes) / sizeof(kSizes[0])); ++i)
+    {
+        const int w = kSizes[i][0];
+        const int h = kSizes[i][1];
+
+        Swizzle_Rect32(lin, w * 4, ours, w, h);
+        XGSwizzleRect(lin, w * 4, NULL, ref, w, h, NULL, 4);
+        if (memcmp(ours, ref, (size_t)(w * h) * sizeof(DWORD)) != 0) same = false;
+    }
+
+    char line[96];
+    char* p = StrFmt_Append(line, "texload: swizzle (");
+    p = StrFmt_Append(p, Swizzle_KernelName(Swizzle_GetKernel()));
+    p = StrFmt_Append(p, same ? ") matches XGSwizzleRect\n" : ") DIFFERS from XGSwizzleRect\n");
+    OutputDebugStringA(line);
+}
+#endif
+
+// ------------------------------
+// Streaming
+// ------------------------------
+static bool ReadExact(HANDLE f, void* dst, DWORD bytes)
+{
+    DWORD got = 0;
+    return ReadFile(f, dst, bytes, &got, NULL) && got == bytes;
+}
+
+static void NoteMemLow()
+{
+#if TEXLOAD_LOG
+    if (s_memStart == 0) return;
+
+    MEMORYSTATUS ms;
+    GlobalMemoryStatus(&ms);
+    if ((DWORD)ms.dwAvailPhys < s_memLow)
+        s_memLow = (DWORD)ms.dwAvailPhys;
+#endif
+}
+
+static LPDIRECT3DTEXTURE8 CreateLocked(D3DFORMAT fmt, int w, int h, D3DLOCKED_RECT& lr)
+{
+    LPDIRECT3DTEXTURE8 tex = NULL;
+    if (FAILED(g_pDevice->CreateTexture((UINT)w, (UINT)h, 1, 0, fmt, 0, &tex)))
+        return NULL;
+
+    if (FAILED(tex->LockRect(0, &lr, NULL, 0)))
+    {
+        tex->Release();
+        return NULL;
+    }
+
+    NoteMemLow();
+    return tex;
+}
+
+// Rows of `w` texels that fit in the scratch buffer alongside `extraPerRow`
+// bytes of file data per row; even so the SSE swizzle kernel can take them.
+static int StripRows(int w, int h, int extraPerRow)
+{
+    int rows = (int)sizeof(s_scratch) / (w * 4 + extraPerRow);
+    if (rows > h) rows = h;
+    if (rows > 1) rows &= ~1;
+    return rows;
+}
+
+// A8R8G8B8: read a strip, key it, swizzle it in
+static bool StreamArgb(HANDLE f, int w, int h, int keyTol, void* swz)
+{
+    const int rows = StripRows(w, h, 0);
+    if (rows <= 0) return false;
+
+    DWORD key = 0;
+    for (int y = 0; y < h; y += rows)
+    {
+        const int n = (h - y < rows) ? h - y : rows;
+        if (!ReadExact(f, s_scratch, (DWORD)(n * w * 4))) return false;
+
+        if (keyTol >= 0)
+        {
+            if (y == 0) key = s_scratch[0];
+            ColorKey_Apply((uint32_t*)s_scratch, (uint32_t)(n * w), (uint32_t)key, keyTol);
+        }
+
+        Swizzle_Rows32(s_scratch, w * 4, swz, w, h, y, n);
+    }
+    return true;
+}
+
+// P8: palette first, then strips of indices behind the texels they expand to
+static bool StreamP8(HANDLE f, int w, int h, void* swz)
+{
+    const int rows = StripRows(w, h, w);
+    if (rows <= 0) return false;
+
+    uint32_t pal[256];
+    if (!ReadExact(f, s_scratch, 256 * 4)) return false;
+    TexFmt_P8Palette(s_scratch, pal);
+
+    for (int y = 0; y < h; y += rows)
+    {
+        const int n = (h - y < rows) ? h - y : rows;
+        BYTE* idx = (BYTE*)(s_scratch + rows * w);
+        if (!ReadExact(f, idx, (DWORD)(n * w))) return false;
+
+        for (int i = 0; i < n * w; ++i)
+            s_scratch[i] = pal[idx[i]];
+
+        Swizzle_Rows32(s_scratch, w * 4, swz, w, h, y, n);
+    }
+    return true;
+}
+
+// DXT kept compressed: block rows go straight into the texture. Block data
+// isn't swizzled, only laid out at the locked pitch.
+static bool StreamBlocks(HANDLE f, TexFmt fmt, int w, int h, const D3DLOCKED_RECT& lr)
+{
+    const int rowBytes = (int)TexFmt_RowBytes(fmt, w);
+    const int blockRows = (h + 3) / 4;
+
+    if (lr.Pitch == rowBytes)
+        return ReadExact(f, lr.pBits, (DWORD)(rowBytes * blockRows));
+
+    for (int y = 0; y < blockRows; ++y)
+    {
+        if (!ReadExact(f, (BYTE*)lr.pBits + y * lr.Pitch, (DWORD)rowBytes))
+            return false;
+    }
+    return true;
+}
+
+// DXT the device refused: decode a row of blocks at a time to A8R8G8B8
+static bool StreamDecodedBlocks(HANDLE f, TexFmt fmt, int w, int h, void* swz)
+{
+    const int rowBytes = (int)TexFmt_RowBytes(fmt, w);
+    if (w * 16 + rowBytes > (int)sizeof(s_scratch)) return false;
+
+    BYTE* blocks = (BYTE*)(s_scratch + w * 4);
+
+    for (int y = 0; y < h; y += 4)
+    {
+        const int n = (h - y < 4) ? h - y : 4;
+        if (!ReadExact(f, blocks, (DWORD)rowBytes)) return false;
+
+        TexFmt_DecodeDXT(fmt, blocks, rowBytes, w, n, (uint32_t*)s_scratch, w * 4);
+        Swizzle_Rows32(s_scratch, w * 4, swz, w, h, y, n);
+    }
+    return true;
+}
+
+static __forceinline int IsPow2(int v) { return (v > 0) && ((v & (v - 1)) == 0); }
+
+static LPDIRECT3DTEXTURE8 LoadFromFile(HANDLE f, TexLoad_Info& info, int keyTol)
+{
+    DWORD magic = 0;
+    DDS_HEADER hdr;
+
+    if (!ReadExact(f, &magic, sizeof(magic)) || magic != DDS_MAGIC ||
+        !ReadExact(f, &hdr, sizeof(hdr)) ||
+        hdr.size != 124 || hdr.ddspf.size != 32)
+    {
+        return NULL;
+    }
+
+    const TexFmt fmt = TexFmt_FromDDS(hdr.ddspf.flags, hdr.ddspf.fourCC, hdr.ddspf.rgbBitCount,
+        hdr.ddspf.rMask, hdr.ddspf.gMask, hdr.ddspf.bMask, hdr.ddspf.aMask);
+
+    const int w = (int)hdr.width;
+    const int h = (int)hdr.height;
+
+    if (fmt == TEXFMT_UNKNOWN || !IsPow2(w) || !IsPow2(h))
+        return NULL;
+
+    if (fmt != TEXFMT_A8R8G8B8 || (hdr.ddspf.flags & DDPF_ALPHAPREMULT))
+        keyTol = TEXLOAD_NO_KEY;
+
+    D3DLOCKED_RECT lr;
+    LPDIRECT3DTEXTURE8 tex = NULL;
+    bool ok = false;
+
+    if (TexFmt_IsBlock(fmt))
+    {
+        const D3DFORMAT d3dFmt = (fmt == TEXFMT_DXT1) ? D3DFMT_DXT1 :
+                                 (fmt == TEXFMT_DXT4) ? D3DFMT_DXT4 : D3DFMT_DXT5;
+
+        tex = CreateLocked(d3dFmt, w, h, lr);
+        if (tex)
+        {
+            ok = StreamBlocks(f, fmt, w, h, lr);
+        }
+        else
+        {
+            tex = CreateLocked(D3DFMT_A8R8G8B8, w, h, lr);
+            if (tex) ok = StreamDecodedBlocks(f, fmt, w, h, lr.pBits);
+        }
+    }
+    else
+    {
+        tex = CreateLocked(D3DFMT_A8R8G8B8, w, h, lr);
+        if (tex)
+        {
+            ok = (fmt == TEXFMT_P8) ? StreamP8(f, w, h, lr.pBits)
+                                    : StreamArgb(f, w, h, keyTol, lr.pBits);
+        }
+    }
+
+    if (!tex)
+        return NULL;
+
+    tex->UnlockRect(0);
+
+    if (!ok)
+    {
+        tex->Release();
+        return NULL;
+    }
+
+    info.w = w;
+    info.h = h;
+    info.fmt = fmt;
+    return tex;
+}
+
+static void LogLoad(const char* path, const TexLoad_Info& info, LONGLONG start)
+{
+#if TEXLOAD_LOG
+    LARGE_INTEGER now, freq;
+    QueryPerformanceCounter(&now);
+    QueryPerformanceFrequency(&freq);
+
+    const DWORD us = (freq.QuadPart > 0)
+        ? (DWORD)((now.QuadPart - start) * 1000000 / freq.QuadPart)
+        : 0;
+
+    char line[320];
+    char* p = StrFmt_Append(line, "texload: ");
+    p = StrFmt_AppendN(p, path, 200);      // paths are short; clip anything silly
+    p = StrFmt_Append(p, " ");
+    p = StrFmt_Append(p, TexFmt_Name(info.fmt));
+    p = StrFmt_Append(p, " ");
+    p = StrFmt_AppendUInt(p, (DWORD)info.w);
+    p = StrFmt_Append(p, "x");
+    p = StrFmt_AppendUInt(p, (DWORD)info.h);
+    p = StrFmt_Append(p, " file=");
+    p = StrFmt_AppendUInt(p, (DWORD)(4 + sizeof(DDS_HEADER) + TexFmt_DataBytes(info.fmt, info.w, info.h)));
+    p = StrFmt_Append(p, " tex=");
+    p = StrFmt_AppendUInt(p, TexLoad_TextureBytes(info.fmt, info.w, info.h));
+    p = StrFmt_Append(p, " us=");
+    p = StrFmt_AppendUInt(p, us);
+    StrFmt_Append(p, "\n");
+    OutputDebugStringA(line);
+#else
+    (void)path; (void)info; (void)start;
+#endif
+}
+
+// ------------------------------
+// Public API
+// ------------------------------
+LPDIRECT3DTEXTURE8 TexLoad_FromDDS(const char* path, TexLoad_Info& info, int keyTol)
+{
+    info.w = 0;
+    info.h = 0;
+    info.fmt = TEXFMT_UNKNOWN;
+
+    if (!g_pDevice || !path || !path[0])
+        return NULL;
+
+#if TEXLOAD_LOG
+    CheckSwizzle();
+#endif
+
+    LARGE_INTEGER start;
+    QueryPerformanceCounter(&start);
+
+    HANDLE f = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+
+    if (f == INVALID_HANDLE_VALUE)
+        return NULL;
+
+    LPDIRECT3DTEXTURE8 tex = LoadFromFile(f, info, keyTol);
+    CloseHandle(f);
+
+    if (!tex)
+        return NULL;
+
+    LogLoad(path, info, start.QuadPart);
+    return tex;
+}
+
+DWORD TexLoad_TextureBytes(TexFmt fmt, int w, int h)
+{
+    if (TexFmt_IsBlock(fmt))
+        return (DWORD)TexFmt_DataBytes(fmt, w, h);
+
+    return (DWORD)(w * h * 4);
+}
+
+void TexLoad_BeginMemSpan()
+{
+#if TEXLOAD_LOG
+    MEMORYSTATUS ms;
+    GlobalMemoryStatus(&ms);
+    s_memStart = (DWORD)ms.dwAvailPhys;
+    s_memLow = s_memStart;
+#endif
+}
+
+void TexLoad_EndMemSpan(const char* what)
+{
+#if TEXLOAD_LOG
+    if (s_memStart == 0) return;
+
+    NoteMemLow();
+
+    MEMORYSTATUS ms;
+    GlobalMemoryStatus(&ms);
+    const DWORD end = (DWORD)ms.dwAvailPhys;
+
+    const DWORD peak = s_memStart - s_memLow;
+    const DWORD held = (end < s_memStart) ? s_memStart - end : 0;
+
+    char line[160];
+    char* p = StrFmt_Append(line, "texload: ");
+    p = StrFmt_Append(p, what ? what : "?");
+    p = StrFmt_Append(p, " peak=");
+    p = StrFmt_AppendUInt(p, peak);
+    p = StrFmt_Append(p, " held=");
+    p = StrFmt_AppendUInt(p, held);
+    p = StrFmt_Append(p, " transient=");
+    p = StrFmt_AppendUInt(p, (peak > held) ? peak - held : 0);
+    StrFmt_Append(p, "\n");
+    OutputDebugStringA(line);
+
+    s_memStart = 0;
+#else
+    (void)what;
+#endif
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include <xtl.h>
+
+#include "texfmt.h"
+
+// -----------------------------------------------------------------------------
+// DDS texture loader shared by title, game and attract.
+//
+// Reads the header, creates and locks the texture, then streams level 0 from
+// the file straight into texture memory; nothing the size of the image is
+// ever allocated:
+//   A8R8G8B8   read a strip of rows at a time into a fixed 32KB scratch
+//              buffer, colour-keyed there if asked (colorkey.h), swizzled
+//              into the texture (Swizzle_Rows32)
+//   P8         same, expanding the indices through the palette
+//   DXT1/4/5   read directly into the locked blocks (an eighth / a quarter of
+//              the memory of A8R8G8B8). If the device won't create the
+//              format, decoded a row of blocks at a time into A8R8G8B8.
+//              DXT4 is premultiplied; the hardware filters it like DXT5.
+// Sizes must be powers of two. Compressed textures sample with normalized
+// UVs, like the swizzled ones.
+//
+// The scratch buffer is static: load from one thread at a time.
+//
+// tools/texloadcheck.cpp builds this file on a PC against stub file and device
+// calls and checks every path against whole-image decode, key and swizzle.
+//
+// Debug builds log each load: format, size, file and texture bytes, and the
+// time taken.
+// -----------------------------------------------------------------------------
+
+#define TEXLOAD_NO_KEY  (-1)
+
+struct TexLoad_Info
+{
+    int     w;
+    int     h;
+    TexFmt  fmt;            // format of the file
+};
+
+// Loads `path`. With keyTol >= 0, raw A8R8G8B8 data gets the title's colour
+// key (top-left texel, per-channel tolerance keyTol) unless the file is
+// marked DDPF_ALPHAPREMULT (already keyed by texcook). NULL on failure, with
+// `info` zeroed.
+LPDIRECT3DTEXTURE8 TexLoad_FromDDS(const char* path, TexLoad_Info& info, int keyTol);
+
+// Bytes of texture memory a w x h texture of `fmt` takes at level 0.
+DWORD TexLoad_TextureBytes(TexFmt fmt, int w, int h);
+
+// Debug builds: memory use across a span of work that loads textures (e.g.
+// Title_Init). Free physical memory is sampled at the start, whenever a load
+// has its texture locked (its high point), and at the end; End logs
+//   texload: <what> peak=<most in use> held=<still in use> transient=<freed>
+// in bytes. No-ops in release builds.
+void TexLoad_BeginMemSpan();
+void TexLoad_EndMemSpan(const char* what);
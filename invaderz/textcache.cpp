@@ -0,0 +1,57 @@
+// textcache.cpp
+#include "textcache.h"
+
+#include <xtl.h>
+
+#include "font.h"
+#include "perf.h"
+
+bool TextCache_Draw(TextCacheEntry& e, DWORD key, float x, float y, float scale, DWORD color)
+{
+    if (!e.valid ||
+        e.key != key ||
+        e.x != x || e.y != y ||
+        e.scale != scale ||
+        e.color != color)
+    {
+        Perf_Add(PERF_TEXT_MISSES, 1);
+        return false;
+    }
+
+    Perf_Add(PERF_TEXT_HITS, 1);
+
+    if (e.quads > 0)
+        Batch_PushQuads(Font_Texture(), e.verts, e.quads);
+
+    return true;
+}
+
+void TextCache_Store(TextCacheEntry& e, DWORD key, float x, float y, float scale, DWORD color,
+                     const char* text, float offsetX)
+{
+    const int n = Font_BuildText(e.verts, TEXTCACHE_MAX_CHARS, x + offsetX, y, text, scale, color);
+
+    if (n < 0)
+    {
+        // No glyph atlas: nothing to retain, draw the slow way every frame
+        e.valid = false;
+        DrawText(x + offsetX, y, text, scale, color);
+        return;
+    }
+
+    e.valid = true;
+    e.key = key;
+    e.x = x;
+    e.y = y;
+    e.scale = scale;
+    e.color = color;
+    e.quads = n;
+
+    if (n > 0)
+        Batch_PushQuads(Font_Texture(), e.verts, n);
+}
+
+void TextCache_Invalidate(TextCacheEntry& e)
+{
+    e.valid = false;
+}
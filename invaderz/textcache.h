@@ -0,0 +1,47 @@
+#pragma once
+#include <xtl.h>
+#include "batch.h"
+
+// -----------------------------------------------------------------------------
+// Retained text.
+//
+// A TextCacheEntry keeps the glyph quads of one line of text together with the
+// key it was built from: a caller-chosen content key (the value the string is
+// formatted from, a table revision, ...) plus anchor position, scale and
+// colour. While those match, TextCache_Draw replays the stored vertices into
+// the batch, so the caller skips formatting and glyph lookup entirely.
+//
+//   if (!TextCache_Draw(e, value, x, y, scale, color))
+//   {
+//       MakeLabel(line, value);                               // only on change
+//       TextCache_Store(e, value, x, y, scale, color, line);
+//   }
+//
+// Entries are plain structs owned by the caller (usually file statics).
+// Hits and misses are counted in perf.h (PERF_TEXT_HITS / PERF_TEXT_MISSES).
+// -----------------------------------------------------------------------------
+
+#define TEXTCACHE_MAX_CHARS 32
+
+struct TextCacheEntry
+{
+    bool  valid;
+    DWORD key;
+    float x, y, scale;
+    DWORD color;
+
+    int quads;
+    BatchVertex verts[TEXTCACHE_MAX_CHARS * 4];
+};
+
+// Replays the entry if it was stored with the same key/x/y/scale/color.
+// Returns false (draws nothing) on a miss.
+bool TextCache_Draw(TextCacheEntry& e, DWORD key, float x, float y, float scale, DWORD color);
+
+// Rebuilds the entry from text and draws it. The text starts at
+// (x + offsetX, y); the offset lets e.g. centred text key on its anchor.
+void TextCache_Store(TextCacheEntry& e, DWORD key, float x, float y, float scale, DWORD color,
+                     const char* text, float offsetX = 0.0f);
+
+// Forces the next TextCache_Draw on this entry to miss.
+void TextCache_Invalidate(TextCacheEntry& e);
@@ -1,6 +1,5 @@
 #include "title.h"
 
-#include <xgraphics.h>   // XGSwizzleRect
 #include <string.h>
 #include <stdlib.h>
 
@@ -8,6 +7,12 @@
 #include "input.h"
 #include "music.h"
 #include "attract.h"
+#include "batch.h"
+#include "perf.h"
+#include "rstate.h"
+#include "drawrec.h"
+#include "simclock.h"
+#include "texload.h"
 
 // Device provided by main.cpp
 extern LPDIRECT3DDEVICE8 g_pDevice;
@@ -25,38 +30,6 @@ struct TitleVertex
 #define TITLE_FVF (D3DFVF_XYZRHW | D3DFVF_DIFFUSE | D3DFVF_TEX1)
 #define TEXT_FVF  (D3DFVF_XYZRHW | D3DFVF_DIFFUSE)
 
-#pragma pack(push, 1)
-struct DDS_PIXELFORMAT
-{
-    DWORD size;
-    DWORD flags;
-    DWORD fourCC;
-    DWORD rgbBitCount;
-    DWORD rMask;
-    DWORD gMask;
-    DWORD bMask;
-    DWORD aMask;
-};
-
-struct DDS_HEADER
-{
-    DWORD           size;
-    DWORD           flags;
-    DWORD           height;
-    DWORD           width;
-    DWORD           pitchOrLinearSize;
-    DWORD           depth;
-    DWORD           mipMapCount;
-    DWORD           reserved1[11];
-    DDS_PIXELFORMAT ddspf;
-    DWORD           caps;
-    DWORD           caps2;
-    DWORD           caps3;
-    DWORD           caps4;
-    DWORD           reserved2;
-};
-#pragma pack(pop)
-
 // -----------------------------------------------------------------------------
 // Defaults
 // -----------------------------------------------------------------------------
@@ -94,7 +67,7 @@ static TitleMode s_mode = MODE_TITLE;
 static int  s_idleFrames = 0;
 
 // 60fps assumptions
-static const int kIdleToAttractFrames = 15 * 60;
+static const int kIdleToAttractFrames = 15 * SIM_TICK_HZ;
 
 // Konami sequence
 static const WORD s_konamiSeq[] =
@@ -115,185 +88,22 @@ static int  s_konamiPos = 0;
 // -----------------------------------------------------------------------------
 // Helpers
 // -----------------------------------------------------------------------------
-static __forceinline int IsPow2(int v) { return (v > 0) && ((v & (v - 1)) == 0); }
-static __forceinline int AbsI(int v) { return (v < 0) ? -v : v; }
-
 static void PrepareForText2D()
 {
     if (!g_pDevice) return;
 
-    g_pDevice->SetTexture(0, NULL);
-
-    g_pDevice->SetRenderState(D3DRS_ALPHABLENDENABLE, FALSE);
-    g_pDevice->SetRenderState(D3DRS_ALPHATESTENABLE, FALSE);
-    g_pDevice->SetRenderState(D3DRS_ZENABLE, D3DZB_FALSE);
-    g_pDevice->SetRenderState(D3DRS_CULLMODE, D3DCULL_NONE);
-    g_pDevice->SetRenderState(D3DRS_LIGHTING, FALSE);
-
-    g_pDevice->SetTextureStageState(0, D3DTSS_COLOROP, D3DTOP_DISABLE);
-    g_pDevice->SetTextureStageState(0, D3DTSS_ALPHAOP, D3DTOP_DISABLE);
-
-    g_pDevice->SetVertexShader(TEXT_FVF);
-}
-
-// Strict DDS loader for OG Xbox swizzled textures.
-// Supports: uncompressed A8R8G8B8 only, power-of-two dimensions.
-//
-// NOTE: We apply a simple COLOR-KEY on load to kill the "grey box":
-//   - key color is sampled from the top-left pixel
-//   - any pixel within tolerance of that key gets alpha=0
-static LPDIRECT3DTEXTURE8 LoadTextureFromDDS_Rect_ColorKey(const char* path, int& outW, int& outH, int tol)
-{
-    outW = 0;
-    outH = 0;
-
-    if (!g_pDevice || !path || !path[0])
-        return NULL;
-
-    HANDLE hFile = CreateFileA(
-        path, GENERIC_READ, FILE_SHARE_READ, NULL,
-        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
-
-    if (hFile == INVALID_HANDLE_VALUE)
-        return NULL;
-
-    DWORD bytesRead = 0;
-
-    DWORD magic = 0;
-    if (!ReadFile(hFile, &magic, sizeof(DWORD), &bytesRead, NULL) ||
-        bytesRead != sizeof(DWORD) ||
-        magic != 0x20534444)
-    {
-        CloseHandle(hFile);
-        return NULL;
-    }
-
-    DDS_HEADER hdr;
-    if (!ReadFile(hFile, &hdr, sizeof(DDS_HEADER), &bytesRead, NULL) ||
-        bytesRead != sizeof(DDS_HEADER))
-    {
-        CloseHandle(hFile);
-        return NULL;
-    }
-
-    if (hdr.size != 124 || hdr.ddspf.size != 32)
-    {
-        CloseHandle(hFile);
-        return NULL;
-    }
-
-    const DWORD DDPF_FOURCC = 0x4;
-    const DWORD DDPF_RGB = 0x40;
-    const DWORD DDPF_ALPHAPIXELS = 0x1;
-
-    if (hdr.ddspf.flags & DDPF_FOURCC)
-    {
-        CloseHandle(hFile);
-        return NULL;
-    }
-
-    if (hdr.ddspf.rgbBitCount != 32 ||
-        (hdr.ddspf.flags & (DDPF_RGB | DDPF_ALPHAPIXELS)) != (DDPF_RGB | DDPF_ALPHAPIXELS) ||
-        hdr.ddspf.rMask != 0x00FF0000 ||
-        hdr.ddspf.gMask != 0x0000FF00 ||
-        hdr.ddspf.bMask != 0x000000FF ||
-        hdr.ddspf.aMask != 0xFF000000)
-    {
-        CloseHandle(hFile);
-        return NULL;
-    }
-
-    int w = (int)hdr.width;
-    int h = (int)hdr.height;
-
-    if (!IsPow2(w) || !IsPow2(h))
-    {
-        CloseHandle(hFile);
-        return NULL;
-    }
-
-    DWORD pixelBytes = (DWORD)(w * h * 4);
-
-    BYTE* pixels = (BYTE*)malloc(pixelBytes);
-    if (!pixels)
-    {
-        CloseHandle(hFile);
-        return NULL;
-    }
-
-    if (!ReadFile(hFile, pixels, pixelBytes, &bytesRead, NULL) ||
-        bytesRead != pixelBytes)
-    {
-        free(pixels);
-        CloseHandle(hFile);
-        return NULL;
-    }
-
-    CloseHandle(hFile);
-
-    // -------------------------------------------------------------
-    // Color-key punchout: sample the top-left pixel as the "background"
-    // -------------------------------------------------------------
-    if (tol < 0) tol = 0;
-    if (tol > 255) tol = 255;
-
-    // DDS data is A8R8G8B8 in memory as 0xAARRGGBB (little-endian bytes: BB GG RR AA)
-    const BYTE keyB = pixels[0];
-    const BYTE keyG = pixels[1];
-    const BYTE keyR = pixels[2];
-
-    BYTE* p = pixels;
-    DWORD count = (DWORD)(w * h);
-    for (DWORD i = 0; i < count; ++i, p += 4)
-    {
-        const int b = (int)p[0];
-        const int g = (int)p[1];
-        const int r = (int)p[2];
-
-        if (AbsI(b - (int)keyB) <= tol &&
-            AbsI(g - (int)keyG) <= tol &&
-            AbsI(r - (int)keyR) <= tol)
-        {
-            // set alpha=0
-            p[3] = 0;
-        }
-        else
-        {
-            // force solid alpha for foreground so it reads crisp
-            p[3] = 255;
-        }
-    }
-
-    // Create swizzled texture and upload
-    LPDIRECT3DTEXTURE8 tex = NULL;
-    if (FAILED(g_pDevice->CreateTexture(
-        (UINT)w, (UINT)h,
-        1,
-        0,
-        D3DFMT_A8R8G8B8,
-        0,
-        &tex)))
-    {
-        free(pixels);
-        return NULL;
-    }
-
-    D3DLOCKED_RECT lr;
-    if (FAILED(tex->LockRect(0, &lr, NULL, 0)))
-    {
-        tex->Release();
-        free(pixels);
-        return NULL;
-    }
+    RS_SetTexture(0, NULL);
 
-    XGSwizzleRect(pixels, w * 4, NULL, lr.pBits, w, h, NULL, 4);
+    RS_SetRenderState(D3DRS_ALPHABLENDENABLE, FALSE);
+    RS_SetRenderState(D3DRS_ALPHATESTENABLE, FALSE);
+    RS_SetRenderState(D3DRS_ZENABLE, D3DZB_FALSE);
+    RS_SetRenderState(D3DRS_CULLMODE, D3DCULL_NONE);
+    RS_SetRenderState(D3DRS_LIGHTING, FALSE);
 
-    tex->UnlockRect(0);
-    free(pixels);
+    RS_SetTextureStageState(0, D3DTSS_COLOROP, D3DTOP_DISABLE);
+    RS_SetTextureStageState(0, D3DTSS_ALPHAOP, D3DTOP_DISABLE);
 
-    outW = w;
-    outH = h;
-    return tex;
+    RS_SetVertexShader(TEXT_FVF);
 }
 
 static void DrawCenteredText(const char* s, float y, float scale, DWORD color)
@@ -330,26 +140,30 @@ static void DrawTextureTopCenteredFit(LPDIRECT3DTEXTURE8 tex, int tw, int th,
     v[2].x = x0; v[2].y = y1; v[2].z = 0.0f; v[2].rhw = 1.0f; v[2].color = 0xFFFFFFFF; v[2].u = 0.0f; v[2].v = 1.0f;
     v[3].x = x1; v[3].y = y1; v[3].z = 0.0f; v[3].rhw = 1.0f; v[3].color = 0xFFFFFFFF; v[3].u = 1.0f; v[3].v = 1.0f;
 
-    g_pDevice->SetRenderState(D3DRS_ALPHABLENDENABLE, TRUE);
-    g_pDevice->SetRenderState(D3DRS_ALPHATESTENABLE, FALSE);
-    g_pDevice->SetRenderState(D3DRS_SRCBLEND, D3DBLEND_SRCALPHA);
-    g_pDevice->SetRenderState(D3DRS_DESTBLEND, D3DBLEND_INVSRCALPHA);
-    g_pDevice->SetRenderState(D3DRS_ZENABLE, D3DZB_FALSE);
-    g_pDevice->SetRenderState(D3DRS_CULLMODE, D3DCULL_NONE);
-    g_pDevice->SetRenderState(D3DRS_LIGHTING, FALSE);
-
-    g_pDevice->SetTextureStageState(0, D3DTSS_COLOROP, D3DTOP_SELECTARG1);
-    g_pDevice->SetTextureStageState(0, D3DTSS_COLORARG1, D3DTA_TEXTURE);
-    g_pDevice->SetTextureStageState(0, D3DTSS_ALPHAOP, D3DTOP_SELECTARG1);
-    g_pDevice->SetTextureStageState(0, D3DTSS_ALPHAARG1, D3DTA_TEXTURE);
-
-    g_pDevice->SetTextureStageState(0, D3DTSS_MAGFILTER, D3DTEXF_POINT);
-    g_pDevice->SetTextureStageState(0, D3DTSS_MINFILTER, D3DTEXF_POINT);
-    g_pDevice->SetTextureStageState(0, D3DTSS_MIPFILTER, D3DTEXF_NONE);
-
-    g_pDevice->SetTexture(0, tex);
-    g_pDevice->SetVertexShader(TITLE_FVF);
-    g_pDevice->DrawPrimitiveUP(D3DPT_TRIANGLESTRIP, 2, v, sizeof(TitleVertex));
+    // Anything queued before the logo must land underneath it.
+    Batch_Flush();
+
+    RS_SetRenderState(D3DRS_ALPHABLENDENABLE, TRUE);
+    RS_SetRenderState(D3DRS_ALPHATESTENABLE, FALSE);
+    RS_SetRenderState(D3DRS_SRCBLEND, D3DBLEND_ONE);          // logos are premultiplied
+    RS_SetRenderState(D3DRS_DESTBLEND, D3DBLEND_INVSRCALPHA);
+    RS_SetRenderState(D3DRS_ZENABLE, D3DZB_FALSE);
+    RS_SetRenderState(D3DRS_CULLMODE, D3DCULL_NONE);
+    RS_SetRenderState(D3DRS_LIGHTING, FALSE);
+
+    RS_SetTextureStageState(0, D3DTSS_COLOROP, D3DTOP_SELECTARG1);
+    RS_SetTextureStageState(0, D3DTSS_COLORARG1, D3DTA_TEXTURE);
+    RS_SetTextureStageState(0, D3DTSS_ALPHAOP, D3DTOP_SELECTARG1);
+    RS_SetTextureStageState(0, D3DTSS_ALPHAARG1, D3DTA_TEXTURE);
+
+    RS_SetTextureStageState(0, D3DTSS_MAGFILTER, D3DTEXF_POINT);
+    RS_SetTextureStageState(0, D3DTSS_MINFILTER, D3DTEXF_POINT);
+    RS_SetTextureStageState(0, D3DTSS_MIPFILTER, D3DTEXF_NONE);
+
+    RS_SetTexture(0, tex);
+    RS_SetVertexShader(TITLE_FVF);
+    DrawRec_DrawPrimitiveUP(D3DPT_TRIANGLESTRIP, 2, v, sizeof(TitleVertex));
+    Perf_Add(PERF_DRAW_CALLS, 1);
 }
 
 static __forceinline WORD EdgePressed(WORD now, WORD prev, WORD bit)
@@ -390,6 +204,7 @@ static void EnterAttract()
 
     s_mode = MODE_ATTRACT;
     Attract_Init(s_secret);
+    DrawRec_ForgetTextures();   // attract textures may reuse freed addresses
 
     // prevent instant edge-trigger behavior when returning
     s_prevButtons = GetButtons();
@@ -431,16 +246,30 @@ void Title_Init(const char* normalTitleDDS, const char* secretTitleDDS)
     if (!normalTitleDDS || !normalTitleDDS[0]) normalTitleDDS = kDefaultNormalTex;
     if (!secretTitleDDS || !secretTitleDDS[0]) secretTitleDDS = kDefaultSecretTex;
 
+    // Raw A8R8G8B8 art gets a COLOR-KEY on load to kill the "grey box": the
+    // top-left texel is the key, anything within tolerance of it becomes
+    // transparent black (premultiplied; see DrawTextureTopCenteredFit).
+    // Cooked logos (tools/texcook.cpp --key) already carry that alpha.
     const int kKeyTol = 16;
 
-    s_texNormal = LoadTextureFromDDS_Rect_ColorKey(normalTitleDDS, s_texNormalW, s_texNormalH, kKeyTol);
-    s_texSecret = LoadTextureFromDDS_Rect_ColorKey(secretTitleDDS, s_texSecretW, s_texSecretH, kKeyTol);
+    TexLoad_BeginMemSpan();
+
+    TexLoad_Info info;
+    s_texNormal = TexLoad_FromDDS(normalTitleDDS, info, kKeyTol);
+    s_texNormalW = info.w;
+    s_texNormalH = info.h;
+
+    s_texSecret = TexLoad_FromDDS(secretTitleDDS, info, kKeyTol);
+    s_texSecretW = info.w;
+    s_texSecretH = info.h;
 
     // Load player death sound for Konami code completion
     Sfx_Load(SFX_KONAMI, kSfxPath_PlayerDead);
 
     // Start title music (Music_Init starts immediately; no Music_Play)
     Music_Init(kDefaultTitleTrm);
+
+    TexLoad_EndMemSpan("Title_Init");
 }
 
 void Title_Shutdown()
@@ -0,0 +1,452 @@
+// drawreplay.cpp
+//
+// Replays a draw stream recorded on the Xbox (drawrec.h, format in
+// drawstream.h) through the software rasterizer and prints per-frame costs:
+// draw calls, primitives, vertices, state changes, texture binds, render
+// target switches, and pixels written / overdraw on the back buffer area.
+// Not part of the Xbox project; build it by hand with any C++17 compiler:
+//
+//   g++ -std=c++17 -O2 -o drawreplay tools/drawreplay.cpp tools/softrast.cpp      (from invaderz/)
+//   cl /std:c++17 /O2 /EHsc tools\drawreplay.cpp tools\softrast.cpp
+//
+// Usage: drawreplay stream.ds [--quiet] [--ppm FRAME out.ppm]
+//
+// Every draw in the game is a screen-aligned quad (quad lists from the batch,
+// 4-vertex strips from the cloud and title passes), so each one is replayed
+// as an SR_Quad. Only texture stage 0 is rasterized; the cloud pass's second
+// stage counts as state but isn't drawn. Textures whose contents weren't in
+// the stream sample white, and render-target textures sample whatever the
+// replay drew into them.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <map>
+#include <vector>
+
+#include "../drawstream.h"
+#include "softrast.h"
+
+struct ReplayTexture
+{
+    uint32_t w, h;
+    std::vector<uint32_t> texels;
+};
+
+struct FrameStats
+{
+    uint64_t draws, prims, verts;
+    uint64_t rs, tss, tex, shaders, targets, clears, uploads;
+    uint64_t pixels;            // written by draws, all targets
+};
+
+struct Replay
+{
+    std::map<uint32_t, SR_Target> targets;      // 0 = back buffer
+    std::map<uint32_t, ReplayTexture> textures;
+    uint32_t cur;                               // target being drawn to
+
+    // Stage 0 as last set
+    uint32_t texId, texW, texH, texLinear;
+    bool colorOff;
+    SR_Address address;
+
+    // Blend as last set
+    bool blendOn;
+    uint16_t srcFactor, dstFactor;
+
+    FrameStats frame;
+};
+
+static const uint32_t kWhite = 0xFFFFFFFFu;
+static const SR_Texture kWhiteTex = { &kWhite, 1, 1 };
+
+static SR_Target* Target(Replay& r, uint32_t id, uint32_t w, uint32_t h)
+{
+    std::map<uint32_t, SR_Target>::iterator it = r.targets.find(id);
+    if (it != r.targets.end() && it->second.w == (int)w && it->second.h == (int)h)
+        return &it->second;
+
+    if (it != r.targets.end())
+        SR_DestroyTarget(it->second);
+
+    SR_Target t;
+    if (!SR_CreateTarget(t, (int)w, (int)h)) return NULL;
+    SR_Clear(t, 0xFF000000u);
+    r.targets[id] = t;
+    return &r.targets[id];
+}
+
+static SR_Blend CurrentBlend(const Replay& r)
+{
+    if (!r.blendOn) return SR_BLEND_NONE;
+
+    if (r.srcFactor == DS_FACTOR_SRC_ALPHA && r.dstFactor == DS_FACTOR_INV_SRC_ALPHA) return SR_BLEND_ALPHA;
+    if (r.srcFactor == DS_FACTOR_ONE && r.dstFactor == DS_FACTOR_INV_SRC_ALPHA) return SR_BLEND_PREMUL;
+    if (r.dstFactor == DS_FACTOR_ONE) return SR_BLEND_ADD;
+    return SR_BLEND_ALPHA;
+}
+
+static float ReadF(const uint8_t* p, int off)
+{
+    float f;
+    memcpy(&f, p + off, 4);
+    return f;
+}
+
+static uint32_t ReadU(const uint8_t* p, int off)
+{
+    uint32_t u;
+    memcpy(&u, p + off, 4);
+    return u;
+}
+
+// Four vertices -> one screen-aligned quad (UVs taken at the corners)
+static SR_Quad QuadFrom(const uint8_t* v, uint32_t stride, float uScale, float vScale)
+{
+    SR_Quad q;
+    int tl = 0, br = 0;
+    q.x0 = q.x1 = ReadF(v, 0);
+    q.y0 = q.y1 = ReadF(v, 4);
+
+    for (int i = 1; i < 4; ++i)
+    {
+        const float x = ReadF(v + i * stride, 0);
+        const float y = ReadF(v + i * stride, 4);
+        if (x < q.x0) q.x0 = x;
+        if (x > q.x1) q.x1 = x;
+        if (y < q.y0) q.y0 = y;
+        if (y > q.y1) q.y1 = y;
+    }
+
+    for (int i = 0; i < 4; ++i)
+    {
+        const float x = ReadF(v + i * stride, 0);
+        const float y = ReadF(v + i * stride, 4);
+        if (x == q.x0 && y == q.y0) tl = i;
+        if (x == q.x1 && y == q.y1) br = i;
+    }
+
+    q.color = ReadU(v, 16);
+    q.u0 = q.v0 = q.u1 = q.v1 = 0.0f;
+
+    if (stride >= 28)
+    {
+        q.u0 = ReadF(v + tl * stride, 20) * uScale;
+        q.v0 = ReadF(v + tl * stride, 24) * vScale;
+        q.u1 = ReadF(v + br * stride, 20) * uScale;
+        q.v1 = ReadF(v + br * stride, 24) * vScale;
+    }
+    return q;
+}
+
+static void Draw(Replay& r, const DS_Draw& d, const uint8_t* verts)
+{
+    r.frame.draws++;
+    r.frame.prims += d.primCount;
+    r.frame.verts += d.vertexCount;
+
+    std::map<uint32_t, SR_Target>::iterator cur = r.targets.find(r.cur);
+    if (cur == r.targets.end() || d.stride < 20) return;
+
+    SR_Target& t = cur->second;
+
+    // Source texture: a replayed target, recorded texels, or white
+    SR_Texture src = kWhiteTex;
+    bool textured = (r.texId != 0) && !r.colorOff && d.stride >= 28;
+    float uScale = 1.0f, vScale = 1.0f;
+
+    if (textured)
+    {
+        std::map<uint32_t, SR_Target>::iterator rt = r.targets.find(r.texId);
+        std::map<uint32_t, ReplayTexture>::iterator tx = r.textures.find(r.texId);
+
+        if (rt != r.targets.end() && rt->first != r.cur)
+        {
+            src.texels = rt->second.pixels;
+            src.w = rt->second.w;
+            src.h = rt->second.h;
+        }
+        else if (tx != r.textures.end())
+        {
+            src.texels = tx->second.texels.data();
+            src.w = (int)tx->second.w;
+            src.h = (int)tx->second.h;
+        }
+
+        // Linear textures are addressed in texels on the Xbox
+        if (r.texLinear && r.texW && r.texH)
+        {
+            uScale = 1.0f / (float)r.texW;
+            vScale = 1.0f / (float)r.texH;
+        }
+    }
+
+    SR_State st;
+    st.tex = textured ? &src : NULL;
+    st.blend = CurrentBlend(r);
+    st.address = r.address;
+
+    std::vector<SR_Quad> quads;
+    if (d.prim == DS_PRIM_QUADLIST)
+    {
+        for (uint32_t i = 0; i + 4 <= d.vertexCount; i += 4)
+            quads.push_back(QuadFrom(verts + i * d.stride, d.stride, uScale, vScale));
+    }
+    else if (d.prim == DS_PRIM_TRIANGLESTRIP && d.vertexCount == 4)
+    {
+        quads.push_back(QuadFrom(verts, d.stride, uScale, vScale));
+    }
+
+    SR_ResetStats(t);
+    SR_DrawQuads(t, st, quads.data(), (int)quads.size());
+    r.frame.pixels += t.pixelsWritten;
+}
+
+static void StateChange(Replay& r, const DS_StateChange& c, bool stage)
+{
+    if (stage) r.frame.tss++;
+    else       r.frame.rs++;
+
+    switch (c.known)
+    {
+    case DS_KNOWN_BLEND_ENABLE: r.blendOn = c.knownValue != 0; break;
+    case DS_KNOWN_SRC_BLEND:    r.srcFactor = c.knownValue; break;
+    case DS_KNOWN_DEST_BLEND:   r.dstFactor = c.knownValue; break;
+    case DS_KNOWN_COLOR_OP:     if (c.stage == 0) r.colorOff = (c.knownValue == DS_COLOROP_DISABLE); break;
+    case DS_KNOWN_ADDRESS_U:
+        if (c.stage == 0) r.address = (c.knownValue == DS_ADDRESS_WRAP) ? SR_ADDRESS_WRAP : SR_ADDRESS_CLAMP;
+        break;
+    default: break;
+    }
+}
+
+static void PrintHeader()
+{
+    printf("%6s %6s %7s %8s %5s %5s %5s %4s %4s %4s %4s %10s %8s\n",
+        "frame", "draws", "prims", "verts", "rs", "tss", "tex", "vs", "rt", "clr", "upl", "pixels", "overdraw");
+}
+
+static void PrintRow(const char* label, const FrameStats& s, double area)
+{
+    printf("%6s %6llu %7llu %8llu %5llu %5llu %5llu %4llu %4llu %4llu %4llu %10llu %8.2f\n", label,
+        (unsigned long long)s.draws, (unsigned long long)s.prims, (unsigned long long)s.verts,
+        (unsigned long long)s.rs, (unsigned long long)s.tss, (unsigned long long)s.tex,
+        (unsigned long long)s.shaders, (unsigned long long)s.targets, (unsigned long long)s.clears,
+        (unsigned long long)s.uploads, (unsigned long long)s.pixels, (double)s.pixels / area);
+}
+
+static void Accumulate(FrameStats& sum, FrameStats& max, const FrameStats& f)
+{
+    const uint64_t* src = (const uint64_t*)&f;
+    uint64_t* s = (uint64_t*)&sum;
+    uint64_t* m = (uint64_t*)&max;
+    for (size_t i = 0; i < sizeof(FrameStats) / sizeof(uint64_t); ++i)
+    {
+        s[i] += src[i];
+        if (src[i] > m[i]) m[i] = src[i];
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const char* path = NULL;
+    const char* ppmPath = NULL;
+    long ppmFrame = -1;
+    bool quiet = false;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--quiet") == 0)
+            quiet = true;
+        else if (strcmp(argv[i], "--ppm") == 0 && i + 2 < argc)
+        {
+            ppmFrame = atol(argv[++i]);
+            ppmPath = argv[++i];
+        }
+        else
+            path = argv[i];
+    }
+
+    if (!path)
+    {
+        fprintf(stderr, "usage: drawreplay stream.ds [--quiet] [--ppm FRAME out.ppm]\n");
+        return 2;
+    }
+
+    FILE* f = fopen(path, "rb");
+    if (!f)
+    {
+        fprintf(stderr, "drawreplay: can't open %s\n", path);
+        return 1;
+    }
+
+    DS_FileHeader hdr;
+    if (fread(&hdr, sizeof(hdr), 1, f) != 1 || hdr.magic != DS_MAGIC || hdr.version != DS_VERSION)
+    {
+        fprintf(stderr, "drawreplay: %s is not a version %u draw stream\n", path, DS_VERSION);
+        fclose(f);
+        return 1;
+    }
+
+    Replay r;
+    r.cur = 0;
+    r.texId = r.texW = r.texH = r.texLinear = 0;
+    r.colorOff = false;
+    r.address = SR_ADDRESS_CLAMP;
+    r.blendOn = false;
+    r.srcFactor = DS_FACTOR_ONE;
+    r.dstFactor = DS_FACTOR_ZERO;
+    memset(&r.frame, 0, sizeof(r.frame));
+
+    FrameStats sum, max;
+    memset(&sum, 0, sizeof(sum));
+    memset(&max, 0, sizeof(max));
+
+    double area = 640.0 * 480.0;
+    uint32_t frameNo = 0;
+    uint32_t frames = 0;
+    bool ok = true;
+
+    std::vector<uint8_t> payload;
+    DS_Record rec;
+
+    if (!quiet) PrintHeader();
+
+    while (fread(&rec, sizeof(rec), 1, f) == 1)
+    {
+        payload.resize(rec.size);
+        if (rec.size && fread(payload.data(), 1, rec.size, f) != rec.size)
+        {
+            fprintf(stderr, "drawreplay: truncated record at frame %u\n", frameNo);
+            ok = false;
+            break;
+        }
+
+        const uint8_t* p = payload.data();
+
+        switch (rec.type)
+        {
+        case DS_REC_FRAME_BEGIN:
+            memcpy(&frameNo, p, sizeof(frameNo));
+            memset(&r.frame, 0, sizeof(r.frame));
+            break;
+
+        case DS_REC_FRAME_END:
+        {
+            char label[16];
+            snprintf(label, sizeof(label), "%u", frameNo);
+            if (!quiet) PrintRow(label, r.frame, area);
+            Accumulate(sum, max, r.frame);
+            frames++;
+
+            if (ppmPath && (long)frameNo == ppmFrame && r.targets.count(0))
+            {
+                if (!SR_WritePPM(r.targets[0], ppmPath))
+                {
+                    fprintf(stderr, "drawreplay: can't write %s\n", ppmPath);
+                    ok = false;
+                }
+            }
+            break;
+        }
+
+        case DS_REC_RENDER_STATE:
+        case DS_REC_STAGE_STATE:
+        {
+            DS_StateChange c;
+            memcpy(&c, p, sizeof(c));
+            StateChange(r, c, rec.type == DS_REC_STAGE_STATE);
+            break;
+        }
+
+        case DS_REC_TEXTURE:
+        {
+            DS_TextureBind b;
+            memcpy(&b, p, sizeof(b));
+            r.frame.tex++;
+            if (b.stage == 0)
+            {
+                r.texId = b.id;
+                r.texW = b.w;
+                r.texH = b.h;
+                r.texLinear = b.linear;
+            }
+            break;
+        }
+
+        case DS_REC_TEXTURE_DATA:
+        {
+            DS_TextureData d;
+            memcpy(&d, p, sizeof(d));
+            const size_t n = (size_t)d.w * d.h;
+            if (rec.size < sizeof(d) + n * 4) break;
+
+            ReplayTexture& t = r.textures[d.id];
+            t.w = d.w;
+            t.h = d.h;
+            t.texels.resize(n);
+            memcpy(t.texels.data(), p + sizeof(d), n * 4);
+            r.frame.uploads++;
+            break;
+        }
+
+        case DS_REC_SHADER:
+            r.frame.shaders++;
+            break;
+
+        case DS_REC_TARGET:
+        {
+            DS_Target t;
+            memcpy(&t, p, sizeof(t));
+            r.frame.targets++;
+            r.cur = t.id;
+            Target(r, t.id, t.w, t.h);
+            if (t.id == 0) area = (double)t.w * (double)t.h;
+            break;
+        }
+
+        case DS_REC_CLEAR:
+        {
+            DS_Clear c;
+            memcpy(&c, p, sizeof(c));
+            r.frame.clears++;
+            if (r.targets.count(r.cur))
+                SR_Clear(r.targets[r.cur], c.color);
+            break;
+        }
+
+        case DS_REC_DRAW:
+        {
+            DS_Draw d;
+            memcpy(&d, p, sizeof(d));
+            if (rec.size < sizeof(d) + (size_t)d.vertexCount * d.stride) break;
+            Draw(r, d, p + sizeof(d));
+            break;
+        }
+
+        default:
+            break;  // newer record type: skip
+        }
+    }
+
+    fclose(f);
+
+    if (frames > 0)
+    {
+        FrameStats avg = sum;
+        uint64_t* a = (uint64_t*)&avg;
+        for (size_t i = 0; i < sizeof(FrameStats) / sizeof(uint64_t); ++i)
+            a[i] = (a[i] + frames / 2) / frames;
+
+        printf("\n%u frames\n", frames);
+        PrintHeader();
+        PrintRow("avg", avg, area);
+        PrintRow("max", max, area);
+    }
+
+    for (std::map<uint32_t, SR_Target>::iterator it = r.targets.begin(); it != r.targets.end(); ++it)
+        SR_DestroyTarget(it->second);
+
+    return ok ? 0 : 1;
+}
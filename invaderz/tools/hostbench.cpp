@@ -0,0 +1,1088 @@
+// hostbench.cpp
+//
+// Host-side (PC) checks and measurements for the portable parts of the game.
+// Not part of the Xbox project; build it by hand with any C++17 compiler:
+//
+//   g++ -std=c++17 -O2 -mavx2 -mbmi2 -o hostbench tools/hostbench.cpp tools/softrast.cpp tools/softbin.cpp statecache.cpp swizzle.cpp colorkey.cpp particles.cpp bitplane.cpp -pthread
+//   cl /std:c++17 /O2 /EHsc /arch:AVX2 tools\hostbench.cpp tools\softrast.cpp tools\softbin.cpp statecache.cpp swizzle.cpp colorkey.cpp particles.cpp bitplane.cpp
+//
+// (from invaderz/; leave out -mavx2 -mbmi2 / /arch:AVX2 on machines without AVX2)
+//
+// Usage: hostbench [--ppm frame.ppm] [--threads N]
+//
+// Sections:
+//   sprites    - quads per sprite: one per lit pixel (old DrawSprite4), row
+//                runs, and the compile-time rect tables from sprites.h. Also
+//                checks that the rects cover exactly the sprite's lit pixels.
+//   statecache - drives the render-state shadow (statecache.h) with a
+//                recording device through a few frames of the game's state
+//                sequence; checks the device ends up in the requested state
+//                and reports issued vs filtered calls.
+//   softrast   - renders a synthetic game frame (stars, both cloud layers,
+//                formation, shields) with the software rasterizer using every
+//                kernel compiled in; checks they agree bit for bit and reports
+//                raster time per frame. --ppm writes the last frame.
+//   softbin    - the same frames through the tile-binned renderer (softbin.h)
+//                on 1..N threads; checks every frame against the single-thread
+//                reference and reports scaling (N = cores unless --threads).
+//   swizzle      - every swizzle kernel (swizzle.h) against the bit-by-bit
+//                reference layout over a range of sizes: whole rects, strips,
+//                unswizzle and in-place. Reports MB/s at 256x256 and 1024x1024.
+//   colorkey   - every colour-key kernel (colorkey.h) against the scalar one
+//                on odd lengths and near-key texels, and the time to key a
+//                512x512 title logo next to the per-byte loop title.cpp used
+//                before (straight alpha, AbsI per channel).
+//   particles  - the explosion pool (particles.h): spawn/free bookkeeping
+//                (every particle dies on the tick its life runs out, or when
+//                it leaves the screen) and the time to update and build quads
+//                for a full pool of PARTICLES_MAX.
+//   bitplane   - 1bpp playfield (bitplane.h): every sprite blitted at every
+//                sub-word offset, clipped at all four edges, and erased again,
+//                against a per-pixel reference; fills and the 8-bit upload
+//                expansion likewise. Times a game frame (clear, ~80 sprites,
+//                expand) next to drawing the same sprites as rects.
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include "../sprites.h"
+#include "../sprites_classic.h"
+#include "../sprites_secret.h"
+#include "../statecache.h"
+#include "../swizzle.h"
+#include "../colorkey.h"
+#include "../particles.h"
+#include "../bitplane.h"
+#include "softrast.h"
+#include "softbin.h"
+#include <thread>
+
+static const char* const kSpriteNames[SPR_COUNT] =
+{
+    "player", "player_bullet",
+    "invader_a", "invader_a2", "invader_b", "invader_b2", "invader_c", "invader_c2",
+    "ebullet_zig", "ebullet_plunger", "ebullet_roll",
+    "ufo", "barrier_tile",
+};
+
+static int IndexAt(const Sprite4& spr, int x, int y)
+{
+    int idx = y * (int)spr.w + x;
+    uint8_t b = spr.data[idx >> 1];
+    return ((idx & 1) == 0) ? (b >> 4) : (b & 0x0F);
+}
+
+static int CountLit(const Sprite4& spr)
+{
+    int n = 0;
+    for (int y = 0; y < (int)spr.h; ++y)
+        for (int x = 0; x < (int)spr.w; ++x)
+            if (IndexAt(spr, x, y) != 0) ++n;
+    return n;
+}
+
+static int CountRowRuns(const Sprite4& spr)
+{
+    int n = 0;
+    for (int y = 0; y < (int)spr.h; ++y)
+    {
+        int prev = 0;
+        for (int x = 0; x < (int)spr.w; ++x)
+        {
+            int c = IndexAt(spr, x, y);
+            if (c != 0 && c != prev) ++n;
+            prev = c;
+        }
+    }
+    return n;
+}
+
+// Paints the rects and compares with the packed pixels (no overlaps allowed).
+static bool RectsMatch(const Sprite4& spr)
+{
+    uint8_t img[64 * 64];
+    if (spr.w > 64 || spr.h > 64) return false;
+    memset(img, 0, sizeof(img));
+
+    for (int i = 0; i < (int)spr.rectCount; ++i)
+    {
+        const SpriteRect& r = spr.rects[i];
+        for (int y = r.y; y < r.y + r.h; ++y)
+            for (int x = r.x; x < r.x + r.w; ++x)
+            {
+                if (x >= (int)spr.w || y >= (int)spr.h) return false;
+                if (img[y * 64 + x] != 0) return false;
+                img[y * 64 + x] = r.color;
+            }
+    }
+
+    for (int y = 0; y < (int)spr.h; ++y)
+        for (int x = 0; x < (int)spr.w; ++x)
+            if (img[y * 64 + x] != IndexAt(spr, x, y)) return false;
+
+    return true;
+}
+
+static bool BenchSprites(const char* packName, const SpritePack4& pack)
+{
+    bool ok = true;
+    int totPixels = 0, totRuns = 0, totRects = 0;
+
+    printf("sprites [%s]\n", packName);
+    printf("  %-16s %6s %6s %6s\n", "sprite", "pixels", "runs", "rects");
+
+    for (uint32_t i = 0; i < pack.spriteCount; ++i)
+    {
+        const Sprite4& spr = pack.sprites[i];
+        const int px = CountLit(spr);
+        const int runs = CountRowRuns(spr);
+        const bool match = RectsMatch(spr);
+
+        printf("  %-16s %6d %6d %6d%s\n", kSpriteNames[i], px, runs, (int)spr.rectCount,
+            match ? "" : "  MISMATCH");
+
+        totPixels += px;
+        totRuns += runs;
+        totRects += spr.rectCount;
+        if (!match) ok = false;
+    }
+
+    printf("  %-16s %6d %6d %6d\n\n", "total", totPixels, totRuns, totRects);
+    return ok;
+}
+
+// ------------------------------
+// statecache
+// ------------------------------
+
+// Recording "device": holds whatever actually got through the cache.
+struct RecDevice
+{
+    uint32_t rs[SC_MAX_RENDER_STATES];
+    uint32_t tss[SC_MAX_STAGES][SC_MAX_STAGE_STATES];
+    uintptr_t tex[SC_MAX_STAGES];
+    uint32_t vs;
+    uint32_t calls;
+};
+
+// Mirror of what the caller asked for, to compare against.
+static RecDevice s_want;
+static RecDevice s_dev;
+static StateCache s_sc;
+static uint32_t s_requested;
+
+static void SetRS(uint32_t st, uint32_t v)
+{
+    s_want.rs[st] = v;
+    s_requested++;
+    if (StateCache_RenderState(s_sc, st, v)) { s_dev.rs[st] = v; s_dev.calls++; }
+}
+
+static void SetTSS(uint32_t stage, uint32_t st, uint32_t v)
+{
+    s_want.tss[stage][st] = v;
+    s_requested++;
+    if (StateCache_StageState(s_sc, stage, st, v)) { s_dev.tss[stage][st] = v; s_dev.calls++; }
+}
+
+static void SetTex(uint32_t stage, uintptr_t t)
+{
+    s_want.tex[stage] = t;
+    s_requested++;
+    if (StateCache_Texture(s_sc, stage, t)) { s_dev.tex[stage] = t; s_dev.calls++; }
+}
+
+static void SetVS(uint32_t h)
+{
+    s_want.vs = h;
+    s_requested++;
+    if (StateCache_VertexShader(s_sc, h)) { s_dev.vs = h; s_dev.calls++; }
+}
+
+// Arbitrary ids standing in for the D3D enums; only distinctness matters.
+enum { RS_ZENABLE = 7, RS_CULL = 22, RS_LIGHTING = 137, RS_ABLEND = 27, RS_ATEST = 15, RS_SRCB = 19, RS_DSTB = 20 };
+enum { TSS_COLOROP = 1, TSS_ARG1 = 2, TSS_ARG2 = 3, TSS_ALPHAOP = 4, TSS_MAG = 16, TSS_MIN = 17, TSS_ADDRU = 13 };
+
+static void Prepare2D()
+{
+    SetTex(0, 0);
+    SetRS(RS_ZENABLE, 0); SetRS(RS_CULL, 1); SetRS(RS_LIGHTING, 0);
+    SetRS(RS_ABLEND, 0); SetRS(RS_ATEST, 0);
+    SetTSS(0, TSS_COLOROP, 1); SetTSS(0, TSS_ALPHAOP, 1);
+    SetVS(0x44);
+}
+
+static void Prepare2DTextured(uintptr_t tex, bool additive)
+{
+    SetTex(0, tex);
+    SetRS(RS_ZENABLE, 0); SetRS(RS_CULL, 1); SetRS(RS_LIGHTING, 0);
+    SetRS(RS_ATEST, 0); SetRS(RS_ABLEND, 1);
+    SetRS(RS_SRCB, 5); SetRS(RS_DSTB, additive ? 2 : 6);
+    SetTSS(0, TSS_COLOROP, 4); SetTSS(0, TSS_ARG1, 2); SetTSS(0, TSS_ARG2, 0);
+    SetTSS(0, TSS_ALPHAOP, 4);
+    SetTSS(0, TSS_MAG, 2); SetTSS(0, TSS_MIN, 2); SetTSS(0, TSS_ADDRU, 1);
+    SetVS(0x144);
+}
+
+static bool BenchStateCache()
+{
+    memset(&s_want, 0, sizeof(s_want));
+    memset(&s_dev, 0, sizeof(s_dev));
+    memset(&s_sc, 0, sizeof(s_sc));
+
+    const int frames = 60;
+    s_requested = 0;
+
+    for (int f = 0; f < frames; ++f)
+    {
+        if (f == frames / 2)
+            StateCache_Reset(s_sc);    // e.g. after talking to the device directly
+
+        Prepare2D();                   // stars
+        Prepare2DTextured(0x1000, false);
+        Prepare2DTextured(0x1000, true);
+        Prepare2D();                   // sprites / HUD
+    }
+
+    const bool same = memcmp(s_want.rs, s_dev.rs, sizeof(s_want.rs)) == 0 &&
+                      memcmp(s_want.tss, s_dev.tss, sizeof(s_want.tss)) == 0 &&
+                      memcmp(s_want.tex, s_dev.tex, sizeof(s_want.tex)) == 0 &&
+                      s_want.vs == s_dev.vs;
+
+    const bool counted = (s_sc.issued + s_sc.filtered == s_requested) && (s_sc.issued == s_dev.calls);
+
+    printf("statecache\n");
+    printf("  %d frames, %u requested, %u issued, %u filtered (%.1f per frame reach the device)\n",
+        frames, s_requested, s_sc.issued, s_sc.filtered, (double)s_sc.issued / frames);
+    printf("  device state %s, counters %s\n\n", same ? "matches" : "DIFFERS", counted ? "consistent" : "INCONSISTENT");
+
+    return same && counted;
+}
+
+// ------------------------------
+// softrast
+// ------------------------------
+static const int FRAME_W = 640;
+static const int FRAME_H = 480;
+static const int BENCH_STARS = 2000;
+static const int CLOUD_SIZE = 256;
+static const int SHEET_W = 128;
+
+struct SceneAssets
+{
+    uint32_t cloud[CLOUD_SIZE * CLOUD_SIZE];   // premultiplied, as clouds.cpp
+    uint32_t sheet[SHEET_W * 64];              // sprites side by side (atlas.cpp)
+    SR_Texture cloudTex;
+    SR_Texture sheetTex;
+    int sheetX[SPR_COUNT];
+    int starX[BENCH_STARS];
+    int starY[BENCH_STARS];
+    int starSize[BENCH_STARS];
+};
+
+static uint32_t s_rng = 0x12345678u;
+static uint32_t Rng()
+{
+    s_rng ^= s_rng << 13;
+    s_rng ^= s_rng >> 17;
+    s_rng ^= s_rng << 5;
+    return s_rng;
+}
+
+static void BuildScene(SceneAssets& a, const SpritePack4& pack)
+{
+    s_rng = 0x12345678u;
+
+    // Soft blobs of coverage, premultiplied
+    for (int y = 0; y < CLOUD_SIZE; ++y)
+        for (int x = 0; x < CLOUD_SIZE; ++x)
+        {
+            const uint32_t al = ((x * 7) ^ (y * 13) ^ ((x + y) >> 2)) & 0xFF;
+            const uint32_t c = (al * 200) / 255;
+            a.cloud[y * CLOUD_SIZE + x] = (al << 24) | (c << 16) | (c << 8) | c;
+        }
+    a.cloudTex.texels = a.cloud;
+    a.cloudTex.w = CLOUD_SIZE;
+    a.cloudTex.h = CLOUD_SIZE;
+
+    // Sprites in one row via the palette expansion kernel
+    memset(a.sheet, 0, sizeof(a.sheet));
+    uint32_t tmp[64 * 64];
+    int x = 0;
+    for (uint32_t i = 0; i < pack.spriteCount && i < (uint32_t)SPR_COUNT; ++i)
+    {
+        const Sprite4& spr = pack.sprites[i];
+        a.sheetX[i] = x;
+        if (x + (int)spr.w > SHEET_W || spr.h > 64) continue;
+
+        SR_ExpandPalette4(tmp, spr.data, (int)(spr.w * spr.h), pack.paletteARGB);
+        for (int yy = 0; yy < (int)spr.h; ++yy)
+            memcpy(&a.sheet[yy * SHEET_W + x], &tmp[yy * spr.w], spr.w * sizeof(uint32_t));
+
+        // Index 0 is transparent in game; make sure the sheet agrees
+        for (int yy = 0; yy < (int)spr.h; ++yy)
+            for (int xx = 0; xx < (int)spr.w; ++xx)
+                if (IndexAt(spr, xx, yy) == 0) a.sheet[yy * SHEET_W + x + xx] = 0;
+
+        x += (int)spr.w;
+    }
+    a.sheetTex.texels = a.sheet;
+    a.sheetTex.w = SHEET_W;
+    a.sheetTex.h = 64;
+
+    for (int i = 0; i < BENCH_STARS; ++i)
+    {
+        a.starX[i] = (int)(Rng() % FRAME_W);
+        a.starY[i] = (int)(Rng() % FRAME_H);
+        a.starSize[i] = 1 + (int)(Rng() % 3);
+    }
+}
+
+static SR_Quad SpriteQuad(const SceneAssets& a, const SpritePack4& pack, SpriteId id, float x, float y, float scale)
+{
+    const Sprite4& spr = pack.sprites[id];
+    SR_Quad q;
+    q.x0 = x - 0.25f;   // same bias as batch.cpp
+    q.y0 = y - 0.25f;
+    q.x1 = q.x0 + (float)spr.w * scale;
+    q.y1 = q.y0 + (float)spr.h * scale;
+    q.u0 = (float)a.sheetX[id] / (float)SHEET_W;
+    q.v0 = 0.0f;
+    q.u1 = (float)(a.sheetX[id] + spr.w) / (float)SHEET_W;
+    q.v1 = (float)spr.h / 64.0f;
+    q.color = 0xFFFFFFFFu;
+    return q;
+}
+
+// Records one frame of the synthetic scene
+static void RecordScene(SB_Frame& fr, const SceneAssets& a, const SpritePack4& pack, int frame)
+{
+    SB_Begin(fr, 0xFF000000u);
+
+    // Stars: tiny opaque rects scrolling down
+    for (int i = 0; i < BENCH_STARS; ++i)
+    {
+        const int y = (a.starY[i] + frame * a.starSize[i]) % FRAME_H;
+        const uint32_t g = 120 + (uint32_t)a.starSize[i] * 40;
+        SB_FillRect(fr, a.starX[i], y, a.starSize[i], a.starSize[i], 0xFF000000u | (g << 16) | (g << 8) | g);
+    }
+
+    // Clouds: haze (premultiplied over) and wisps (additive), wrapping
+    SR_Quad cq;
+    cq.x0 = 0.0f; cq.y0 = 0.0f; cq.x1 = (float)FRAME_W; cq.y1 = (float)FRAME_H;
+    cq.u0 = (float)frame / 512.0f;
+    cq.v0 = 0.0f;
+    cq.u1 = cq.u0 + (float)FRAME_W / (float)CLOUD_SIZE;
+    cq.v1 = (float)FRAME_H / (float)CLOUD_SIZE;
+    cq.color = 0x23234E6Eu;
+
+    SR_State st;
+    st.tex = &a.cloudTex;
+    st.address = SR_ADDRESS_WRAP;
+    st.blend = SR_BLEND_PREMUL;
+    SB_DrawQuads(fr, st, &cq, 1);
+
+    cq.u0 = -(float)frame / 256.0f;
+    cq.u1 = cq.u0 + (float)FRAME_W / (float)CLOUD_SIZE;
+    cq.color = 0x3C3CC878u;
+    st.blend = SR_BLEND_ADD;
+    SB_DrawQuads(fr, st, &cq, 1);
+
+    // Formation, shields, player: point-sampled sprites
+    SR_Quad quads[128];
+    int n = 0;
+    const int step = (frame & 1) ? 1 : 0;
+    for (int r = 0; r < 5; ++r)
+        for (int c = 0; c < 11; ++c)
+        {
+            const SpriteId id = (SpriteId)((r == 0 ? SPR_INVADER_A : r <= 2 ? SPR_INVADER_B : SPR_INVADER_C) + step);
+            quads[n++] = SpriteQuad(a, pack, id, 92.0f + c * 40.0f + (float)(frame % 64), 80.0f + r * 26.0f, 2.0f);
+        }
+    for (int s = 0; s < 4; ++s)
+        for (int ty = 0; ty < 3; ++ty)
+            for (int tx = 0; tx < 6; ++tx)
+                quads[n++] = SpriteQuad(a, pack, SPR_BARRIER_TILE, 92.0f + s * 138.0f + tx * 16.0f, 360.0f + ty * 16.0f, 2.0f);
+    quads[n++] = SpriteQuad(a, pack, SPR_PLAYER, 304.0f, 424.0f, 2.0f);
+
+    st.tex = &a.sheetTex;
+    st.address = SR_ADDRESS_CLAMP;
+    st.blend = SR_BLEND_ALPHA;
+    SB_DrawQuads(fr, st, quads, n);
+
+    // Ground line
+    SB_FillRect(fr, 0, FRAME_H - 60, FRAME_W, 1, 0xFF50FF50u);
+}
+
+static uint64_t HashFrame(const SR_Target& t)
+{
+    uint64_t h = 1469598103934665603ull;
+    for (int i = 0; i < t.w * t.h; ++i)
+    {
+        h ^= t.pixels[i];
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+static SceneAssets s_scene;
+static SB_Frame s_frames[8];      // recorded once, replayed by both sections
+
+static void RecordFrames()
+{
+    BuildScene(s_scene, g_packClassic);
+    for (int f = 0; f < 8; ++f)
+        RecordScene(s_frames[f], s_scene, g_packClassic, f);
+}
+
+static bool BenchSoftRast(const char* ppmPath)
+{
+    SR_Target t;
+    if (!SR_CreateTarget(t, FRAME_W, FRAME_H)) return false;
+
+    const int frames = 120;
+    const SR_Kernel best = SR_GetKernel();
+    bool ok = true;
+    bool haveRef = false;
+    uint64_t ref = 0;
+
+    printf("softrast (%dx%d, %d stars, 2 cloud layers, %d frames)\n", FRAME_W, FRAME_H, BENCH_STARS, frames);
+
+    for (int k = 0; k < SR_KERNEL_COUNT; ++k)
+    {
+        if (!SR_SetKernel((SR_Kernel)k)) continue;
+
+        SR_ResetStats(t);
+
+        uint64_t hash = 0;
+        double total = 0.0;
+        for (int f = 0; f < frames; ++f)
+        {
+            const auto t0 = std::chrono::steady_clock::now();
+            SB_RenderReference(t, s_frames[f % 8]);
+            total += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+
+            hash ^= HashFrame(t) + (uint64_t)f;
+        }
+
+        const double ms = total / frames;
+        const bool same = !haveRef || hash == ref;
+        if (!haveRef) { ref = hash; haveRef = true; }
+        ok &= same;
+
+        printf("  %-7s %7.3f ms/frame  %6.2f Mpix/frame  %llu quads/frame  %s\n",
+            SR_KernelName((SR_Kernel)k), ms,
+            (double)t.pixelsWritten / frames / 1e6, (unsigned long long)(t.quads / frames),
+            same ? "" : "MISMATCH vs scalar");
+    }
+
+    SR_SetKernel(best);
+
+    if (ppmPath)
+    {
+        const bool wrote = SR_WritePPM(t, ppmPath);
+        printf("  last frame -> %s%s\n", ppmPath, wrote ? "" : " (write FAILED)");
+        ok &= wrote;
+    }
+
+    printf("\n");
+    SR_DestroyTarget(t);
+    return ok;
+}
+
+// ------------------------------
+// softbin
+// ------------------------------
+static bool BenchSoftBin(int maxThreads)
+{
+    SR_Target ref, t;
+    if (!SR_CreateTarget(ref, FRAME_W, FRAME_H)) return false;
+    if (!SR_CreateTarget(t, FRAME_W, FRAME_H)) { SR_DestroyTarget(ref); return false; }
+
+    const int frames = 120;
+    const int cores = (int)std::thread::hardware_concurrency();
+    if (maxThreads < 1) maxThreads = cores;
+    if (maxThreads < 1) maxThreads = 1;
+
+    // Reference hashes per recorded frame
+    uint64_t refHash[8];
+    for (int f = 0; f < 8; ++f)
+    {
+        SB_RenderReference(ref, s_frames[f]);
+        refHash[f] = HashFrame(ref);
+    }
+
+    printf("softbin (%dx%d tiles, %s kernel, %d frames, %d cores)\n",
+        SB_TILE_W, SB_TILE_H, SR_KernelName(SR_GetKernel()), frames, cores);
+
+    bool ok = true;
+    double oneThread = 0.0;
+
+    for (int threads = 1; threads <= maxThreads; threads = (threads < maxThreads && threads * 2 > maxThreads) ? maxThreads : threads * 2)
+    {
+        SB_Pool* pool = SB_CreatePool(threads);
+        bool same = true;
+        double total = 0.0;
+
+        for (int f = 0; f < frames; ++f)
+        {
+            const auto t0 = std::chrono::steady_clock::now();
+            SB_RenderBinned(pool, t, s_frames[f % 8]);
+            total += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+
+            if (HashFrame(t) != refHash[f % 8]) same = false;
+        }
+
+        SB_DestroyPool(pool);
+
+        const double ms = total / frames;
+        if (threads == 1) oneThread = ms;
+
+        printf("  %2d threads %7.3f ms/frame  x%.2f  %s\n", threads, ms, oneThread / ms,
+            same ? "identical" : "DIFFERS from reference");
+        ok &= same;
+
+        if (threads == maxThreads) break;
+    }
+
+    printf("\n");
+    SR_DestroyTarget(t);
+    SR_DestroyTarget(ref);
+    return ok;
+}
+
+// ------------------------------
+// Swizzle
+// ------------------------------
+static bool CheckSwizzle(int w, int h)
+{
+    const int n = w * h;
+    std::vector<uint32_t> lin(n), ref(n), got(n), back(n);
+
+    for (int i = 0; i < n; ++i) lin[i] = Rng();
+    for (int y = 0; y < h; ++y)
+        for (int x = 0; x < w; ++x)
+            ref[Swizzle_Offset(x, y, w, h)] = lin[y * w + x];
+
+    bool ok = true;
+
+    Swizzle_Rect32(lin.data(), w * 4, got.data(), w, h);
+    ok &= got == ref;
+
+    Swizzle_Unrect32(ref.data(), w, h, back.data(), w * 4);
+    ok &= back == lin;
+
+    // Uneven strips, as a streaming loader would feed them
+    std::fill(got.begin(), got.end(), 0u);
+    for (int y = 0; y < h; y += 3)
+    {
+        const int rows = (h - y < 3) ? h - y : 3;
+        Swizzle_Rows32(lin.data() + y * w, w * 4, got.data(), w, h, y, rows);
+    }
+    ok &= got == ref;
+
+    got = lin;
+    if (Swizzle_InPlace32(got.data(), w, h))
+        ok &= got == ref;
+
+    return ok;
+}
+
+static double SwizzleMBs(int w, int h, int what)
+{
+    std::vector<uint32_t> a((size_t)w * h), b((size_t)w * h);
+    for (auto& v : a) v = Rng();
+
+    const int reps = (w * h >= 1024 * 1024) ? 20 : 400;
+    double best = 1e9;
+
+    for (int pass = 0; pass < 3; ++pass)
+    {
+        const auto t0 = std::chrono::steady_clock::now();
+        for (int r = 0; r < reps; ++r)
+        {
+            if (what == 0) Swizzle_Rect32(a.data(), w * 4, b.data(), w, h);
+            else if (what == 1) Swizzle_Unrect32(a.data(), w, h, b.data(), w * 4);
+            else if (what == 2) Swizzle_InPlace32(a.data(), w, h);
+            else memcpy(b.data(), a.data(), a.size() * 4);
+        }
+        const double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        if (s < best) best = s;
+    }
+
+    return (double)w * h * 4 * reps / best / (1024.0 * 1024.0);
+}
+
+static bool BenchSwizzle()
+{
+    static const int kSizes[][2] =
+    {
+        { 1, 1 }, { 2, 1 }, { 1, 4 }, { 4, 2 }, { 8, 8 }, { 16, 4 }, { 4, 16 },
+        { 64, 32 }, { 32, 64 }, { 128, 128 }, { 256, 256 }, { 512, 128 },
+        { 128, 512 }, { 1024, 256 }, { 1024, 1024 },
+    };
+    const int sizeCount = (int)(sizeof(kSizes) / sizeof(kSizes[0]));
+
+    printf("swizzle\n");
+
+    bool ok = true;
+    const Swizzle_Kernel def = Swizzle_GetKernel();
+
+    for (int k = 0; k < SWIZZLE_KERNEL_COUNT; ++k)
+    {
+        if (!Swizzle_SetKernel((Swizzle_Kernel)k)) continue;
+
+        int bad = 0;
+        for (int i = 0; i < sizeCount; ++i)
+        {
+            // The bit-loop kernel is too slow to be worth the big sizes
+            if (k == SWIZZLE_KERNEL_SCALAR && kSizes[i][0] * kSizes[i][1] > 256 * 256) continue;
+            if (!CheckSwizzle(kSizes[i][0], kSizes[i][1])) ++bad;
+        }
+        ok &= bad == 0;
+
+        printf("  %-6s  layout %s", Swizzle_KernelName((Swizzle_Kernel)k), bad ? "MISMATCH" : "ok    ");
+        for (int sz = 256; sz <= 1024; sz *= 4)
+        {
+            printf("  %4dx%-4d rect %6.0f  unrect %6.0f  in-place %6.0f MB/s", sz, sz,
+                   SwizzleMBs(sz, sz, 0), SwizzleMBs(sz, sz, 1), SwizzleMBs(sz, sz, 2));
+        }
+        printf("\n");
+    }
+
+    Swizzle_SetKernel(def);
+    printf("  memcpy  256x256 %.0f MB/s, 1024x1024 %.0f MB/s (for scale)\n\n",
+           SwizzleMBs(256, 256, 3), SwizzleMBs(1024, 1024, 3));
+
+    return ok;
+}
+
+// ------------------------------
+// Colour key
+// ------------------------------
+
+// The title loader's loop before colorkey.h, for comparison
+static void KeyTitleLoop(uint8_t* pixels, uint32_t count, int tol)
+{
+    const uint8_t keyB = pixels[0];
+    const uint8_t keyG = pixels[1];
+    const uint8_t keyR = pixels[2];
+
+    uint8_t* p = pixels;
+    for (uint32_t i = 0; i < count; ++i, p += 4)
+    {
+        const int b = p[0] - keyB;
+        const int g = p[1] - keyG;
+        const int r = p[2] - keyR;
+
+        if ((b < 0 ? -b : b) <= tol && (g < 0 ? -g : g) <= tol && (r < 0 ? -r : r) <= tol)
+            p[3] = 0;
+        else
+            p[3] = 255;
+    }
+}
+
+// Half the texels within +-24 of the key per channel, so both sides of a
+// tolerance of 16 get hit
+static void MakeKeyImage(std::vector<uint32_t>& img, uint32_t key)
+{
+    for (size_t i = 0; i < img.size(); ++i)
+    {
+        uint32_t t = Rng();
+        if (t & 0x100)
+        {
+            uint32_t near = 0;
+            for (int s = 0; s < 24; s += 8)
+            {
+                const int c = (int)((key >> s) & 0xFF) + (int)((Rng() >> 8) % 49) - 24;
+                near |= (uint32_t)(c < 0 ? 0 : c > 255 ? 255 : c) << s;
+            }
+            t = (t & 0xFF000000u) | near;
+        }
+        img[i] = t;
+    }
+    img[0] = key;
+}
+
+static double ColorKeyMs(int what, int tol)
+{
+    const int n = 512 * 512;
+    std::vector<uint32_t> src(n), work(n);
+    MakeKeyImage(src, 0xFF606060u);
+
+    const int reps = 50;
+    double best = 1e9;
+
+    for (int pass = 0; pass < 3; ++pass)
+    {
+        double total = 0.0;
+        for (int r = 0; r < reps; ++r)
+        {
+            work = src;                 // keying is destructive; time the key only
+            const auto t0 = std::chrono::steady_clock::now();
+            if (what == 0) KeyTitleLoop((uint8_t*)work.data(), (uint32_t)n, tol);
+            else ColorKey_Apply(work.data(), (uint32_t)n, work[0], tol);
+            total += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+        }
+        if (total / reps < best) best = total / reps;
+    }
+
+    return best;
+}
+
+static bool BenchColorKey()
+{
+    printf("colorkey\n");
+
+    bool ok = true;
+    const ColorKey_Kernel def = ColorKey_GetKernel();
+    const int tols[] = { 0, 16, 255 };
+
+    // Reference results from the scalar kernel
+    std::vector<uint32_t> src(1031), ref, got;
+    MakeKeyImage(src, 0xFF3080C0u);
+
+    // The old loop agrees with the scalar kernel wherever the texel stays
+    // visible (premultiplying only clears the colour of keyed ones)
+    ColorKey_SetKernel(COLORKEY_KERNEL_SCALAR);
+    for (int t = 0; t < 3; ++t)
+    {
+        ref = src;
+        got = src;
+        ColorKey_Apply(ref.data(), (uint32_t)ref.size(), ref[0], tols[t]);
+        KeyTitleLoop((uint8_t*)got.data(), (uint32_t)got.size(), tols[t]);
+        for (size_t i = 0; i < ref.size(); ++i)
+            ok &= (got[i] >> 24) == (ref[i] >> 24) && (ref[i] == 0 || got[i] == ref[i]);
+    }
+    if (!ok) printf("  scalar kernel disagrees with the old title loop\n");
+
+    for (int k = 0; k < COLORKEY_KERNEL_COUNT; ++k)
+    {
+        if (!ColorKey_SetKernel((ColorKey_Kernel)k)) continue;
+
+        int bad = 0;
+        for (int t = 0; t < 3; ++t)
+        {
+            for (uint32_t n = 1; n <= (uint32_t)src.size(); n += (n < 40) ? 1 : 331)
+            {
+                ref.assign(src.begin(), src.begin() + n);
+                got = ref;
+
+                ColorKey_SetKernel(COLORKEY_KERNEL_SCALAR);
+                ColorKey_Apply(ref.data(), n, src[0], tols[t]);
+                ColorKey_SetKernel((ColorKey_Kernel)k);
+                ColorKey_Apply(got.data(), n, src[0], tols[t]);
+
+                if (got != ref) ++bad;
+            }
+        }
+        ok &= bad == 0;
+
+        const double ms = ColorKeyMs(1, 16);
+        printf("  %-7s %s  512x512 %.3f ms (%.0f MB/s)\n", ColorKey_KernelName((ColorKey_Kernel)k),
+               bad ? "MISMATCH" : "ok    ", ms, 512.0 * 512 * 4 / (ms * 1000.0 * 1.048576));
+    }
+
+    ColorKey_SetKernel(def);
+
+    const double loopMs = ColorKeyMs(0, 16);
+    const double defMs = ColorKeyMs(1, 16);
+    printf("  old title loop  512x512 %.3f ms (%.0f MB/s); %s is %.1fx faster\n\n",
+           loopMs, 512.0 * 512 * 4 / (loopMs * 1000.0 * 1.048576),
+           ColorKey_KernelName(def), loopMs / defMs);
+
+    return ok;
+}
+
+// ------------------------------
+// Particles
+// ------------------------------
+static bool BenchParticles()
+{
+    printf("particles\n");
+
+    bool ok = true;
+    ParticlePool p;
+    memset(&p, 0, sizeof(p));
+    if (!Particles_Init(p, PARTICLES_MAX, FRAME_W, FRAME_H, 1))
+    {
+        printf("  init failed\n");
+        return false;
+    }
+
+    // Lives 1..50, no movement: after k ticks exactly those with life > k remain
+    p.gravity = 0.0f;
+    int alive[51] = {};
+    for (int i = 0; i < PARTICLES_MAX; ++i)
+    {
+        const int life = 1 + (i * 7) % 50;
+        ok &= Particles_Spawn(p, 100.0f, 100.0f, 0.0f, 0.0f, life, (uint32_t)life);
+        alive[life]++;
+    }
+    ok &= !Particles_Spawn(p, 0.0f, 0.0f, 0.0f, 0.0f, 10, 0);     // full
+
+    for (int k = 1; k <= 50 && ok; ++k)
+    {
+        Particles_Update(p);
+
+        int want = 0;
+        for (int l = k + 1; l <= 50; ++l) want += alive[l];
+        ok &= p.count == want;
+
+        // The survivors still carry their own colour (= starting life)
+        for (int i = 0; i < p.count; ++i)
+            ok &= (int)p.color[i] - k == (int)p.life[i];
+    }
+    if (!ok) printf("  lifetime bookkeeping wrong\n");
+
+    // Anything leaving the screen dies whatever its life
+    Particles_Clear(p);
+    Particles_Spawn(p, 1.0f, 100.0f, -2.0f, 0.0f, 100, 0);
+    Particles_Spawn(p, FRAME_W - 1.0f, 100.0f, 2.0f, 0.0f, 100, 0);
+    Particles_Spawn(p, 100.0f, 1.0f, 0.0f, -2.0f, 100, 0);
+    Particles_Spawn(p, 100.0f, FRAME_H - 1.0f, 0.0f, 2.0f, 100, 0);
+    Particles_Spawn(p, 100.0f, 100.0f, 0.0f, 0.0f, 100, 0x123456);
+    Particles_Update(p);
+    const bool edges = p.count == 1 && p.color[0] == 0x123456;
+    if (!edges) printf("  off-screen particles not freed\n");
+    ok &= edges;
+
+    // Timing: a full pool that stays alive and on screen
+    p.gravity = 0.06f;
+    ParticleStyle st = { 1.0f, 0.2f, 1000000, 1000000 };
+    Particles_Clear(p);
+    while (Particles_Sparks(p, FRAME_W * 0.5f, FRAME_H * 0.25f, 64, 0xFFFFFF, st) > 0) {}
+
+    std::vector<ParticleVertex> verts(PARTICLES_MAX * 4);
+    const int iters = 200;
+    double updMs = 1e9, buildMs = 1e9;
+
+    for (int rep = 0; rep < 5; ++rep)
+    {
+        auto t0 = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < iters; ++i)
+        {
+            Particles_Update(p);
+            p.gravity = -p.gravity;     // bob in place so nothing leaves
+        }
+        auto t1 = std::chrono::high_resolution_clock::now();
+        int quads = 0;
+        for (int i = 0; i < iters; ++i)
+            quads += Particles_BuildQuads(p, 0, verts.data(), PARTICLES_MAX, 2.0f, 1.0f);
+        auto t2 = std::chrono::high_resolution_clock::now();
+
+        ok &= quads == iters * p.count;
+        updMs = std::min(updMs, std::chrono::duration<double, std::milli>(t1 - t0).count() / iters);
+        buildMs = std::min(buildMs, std::chrono::duration<double, std::milli>(t2 - t1).count() / iters);
+    }
+
+    printf("  %s  %d live: update %.3f ms, build quads %.3f ms per frame\n\n",
+           ok ? "ok    " : "FAILED", p.count, updMs, buildMs);
+
+    Particles_Shutdown(p);
+    return ok;
+}
+
+// ------------------------------
+// Bitplane
+// ------------------------------
+struct PixelPlane
+{
+    uint8_t p[BITPLANE_H][BITPLANE_W];
+};
+
+static void RefBlit(PixelPlane& ref, const Sprite4& spr, int x, int y, uint8_t v)
+{
+    for (int sy = 0; sy < spr.h; ++sy)
+        for (int sx = 0; sx < spr.w; ++sx)
+        {
+            const int px = x + sx, py = y + sy;
+            if (px < 0 || py < 0 || px >= BITPLANE_W || py >= BITPLANE_H) continue;
+            if (IndexAt(spr, sx, sy)) ref.p[py][px] = v;
+        }
+}
+
+static bool PlaneMatches(const Bitplane& bp, const PixelPlane& ref)
+{
+    for (int y = 0; y < BITPLANE_H; ++y)
+        for (int x = 0; x < BITPLANE_W; ++x)
+            if (Bitplane_Get(bp, x, y) != (ref.p[y][x] != 0)) return false;
+    return true;
+}
+
+// Where a game frame puts things, in plane pixels
+static int PlaneFrame(Bitplane& bp, const BitSprite* bs, int frame)
+{
+    int blits = 0;
+    Bitplane_Clear(bp);
+
+    Bitplane_Blit(bp, bs[SPR_UFO], (frame * 2) % 360 - 40, 20); ++blits;
+    for (int r = 0; r < 5; ++r)
+        for (int c = 0; c < 11; ++c)
+        {
+            const SpriteId id = (SpriteId)(SPR_INVADER_A + ((r + 1) / 2) * 2 + (frame / 30) % 2);
+            Bitplane_Blit(bp, bs[id], 40 + c * 16 + (frame % 64), 40 + r * 13); ++blits;
+        }
+    for (int i = 0; i < 4; ++i)
+        for (int t = 0; t < 18; ++t, ++blits)
+            Bitplane_Blit(bp, bs[SPR_BARRIER_TILE], 40 + i * 70 + (t % 6) * 8, 180 + (t / 6) * 8);
+    Bitplane_Blit(bp, bs[SPR_PLAYER], 150, 212); ++blits;
+    for (int i = 0; i < 4; ++i, ++blits)
+        Bitplane_Blit(bp, bs[SPR_EBULLET_ZIG + i % 3], 60 + i * 60, (frame * 2 + i * 40) % 200);
+    Bitplane_Fill(bp, 0, 210, BITPLANE_W, 1);
+    return blits;
+}
+
+static bool BenchBitplane()
+{
+    printf("bitplane\n");
+
+    bool ok = true;
+    static Bitplane bp;
+    static PixelPlane ref;
+    BitSprite bs[SPR_COUNT];
+
+    const SpritePack4* packs[2] = { &g_packClassic, &g_packSecret };
+    for (int k = 0; k < 2; ++k)
+    {
+        for (uint32_t i = 0; i < (uint32_t)SPR_COUNT; ++i)
+        {
+            const Sprite4& spr = packs[k]->sprites[i];
+            ok &= BitSprite_FromSprite4(bs[i], spr);
+
+            // Every sub-word offset, and off each edge
+            const int xs[] = { -40, -15, -3, 0, 1, 5, 17, 31, 32, 33, 63, 150, 301, 305, 313, 319, 320 };
+            const int ys[] = { -10, -3, 0, 7, 100, 233, 236, 239, 240 };
+            for (int xi = 0; xi < (int)(sizeof(xs) / sizeof(xs[0])); ++xi)
+                for (int yi = 0; yi < (int)(sizeof(ys) / sizeof(ys[0])); ++yi)
+                {
+                    Bitplane_Clear(bp);
+                    memset(&ref, 0, sizeof(ref));
+
+                    // Something underneath that the erase must not touch
+                    Bitplane_Fill(bp, 0, 0, BITPLANE_W, 2);
+                    for (int x = 0; x < BITPLANE_W; ++x) ref.p[0][x] = ref.p[1][x] = 1;
+
+                    Bitplane_Blit(bp, bs[i], xs[xi], ys[yi]);
+                    RefBlit(ref, spr, xs[xi], ys[yi], 1);
+                    ok &= PlaneMatches(bp, ref);
+
+                    Bitplane_Erase(bp, bs[i], xs[xi], ys[yi]);
+                    RefBlit(ref, spr, xs[xi], ys[yi], 0);
+                    ok &= PlaneMatches(bp, ref);
+                }
+        }
+    }
+    if (!ok) printf("  blit/erase mismatch\n");
+
+    // Fills across word boundaries
+    bool fills = true;
+    const int fx[][2] = { { 0, 1 }, { 31, 2 }, { 5, 20 }, { 30, 70 }, { -5, 400 }, { 310, 20 }, { 64, 32 } };
+    for (int f = 0; f < (int)(sizeof(fx) / sizeof(fx[0])); ++f)
+    {
+        Bitplane_Clear(bp);
+        Bitplane_Fill(bp, fx[f][0], 3, fx[f][1], 2);
+        for (int y = 0; y < 8; ++y)
+            for (int x = 0; x < BITPLANE_W; ++x)
+                fills &= Bitplane_Get(bp, x, y) == (y >= 3 && y < 5 && x >= fx[f][0] && x < fx[f][0] + fx[f][1]);
+    }
+    if (!fills) printf("  fill mismatch\n");
+    ok &= fills;
+
+    for (uint32_t i = 0; i < (uint32_t)SPR_COUNT; ++i)
+        BitSprite_FromSprite4(bs[i], g_packClassic.sprites[i]);
+
+    // Expansion to one byte per pixel, into a padded pitch
+    const int pitch = 384;
+    std::vector<uint8_t> tex((size_t)pitch * BITPLANE_H, 0x5A);
+    int blits = PlaneFrame(bp, bs, 17);
+    Bitplane_Expand8(bp, 0, BITPLANE_H, tex.data(), pitch);
+    bool expand = true;
+    for (int y = 0; y < BITPLANE_H; ++y)
+    {
+        for (int x = 0; x < BITPLANE_W; ++x)
+            expand &= tex[(size_t)y * pitch + x] == (Bitplane_Get(bp, x, y) ? 0xFF : 0x00);
+        for (int x = BITPLANE_W; x < pitch; ++x)
+            expand &= tex[(size_t)y * pitch + x] == 0x5A;
+    }
+    if (!expand) printf("  expand mismatch\n");
+    ok &= expand;
+
+    // Timing: the whole frame, and just the upload
+    const int iters = 2000;
+    double frameUs = 1e9, expandUs = 1e9, rectUs = 1e9;
+    volatile uint32_t sink = 0;
+
+    for (int rep = 0; rep < 5; ++rep)
+    {
+        auto t0 = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < iters; ++i)
+        {
+            PlaneFrame(bp, bs, i);
+            Bitplane_Expand8(bp, 0, BITPLANE_H, tex.data(), pitch);
+        }
+        auto t1 = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < iters; ++i)
+            Bitplane_Expand8(bp, 0, BITPLANE_H, tex.data(), pitch);
+        auto t2 = std::chrono::high_resolution_clock::now();
+
+        // The rect path writes a 20-byte vertex x 4 per rect (batch.h)
+        std::vector<float> verts(4096 * 20);
+        for (int i = 0; i < iters; ++i)
+        {
+            int n = 0;
+            for (int b = 0; b < blits; ++b)
+            {
+                const Sprite4& spr = g_packClassic.sprites[SPR_INVADER_A];
+                for (int r = 0; r < spr.rectCount && n < 4096; ++r, ++n)
+                    for (int v = 0; v < 20; ++v)
+                        verts[(size_t)n * 20 + v] = (float)(spr.rects[r].x + b + v);
+            }
+            sink = sink + (uint32_t)verts[(size_t)(i % 64) * 20];
+        }
+        auto t3 = std::chrono::high_resolution_clock::now();
+
+        frameUs = std::min(frameUs, std::chrono::duration<double, std::micro>(t1 - t0).count() / iters);
+        expandUs = std::min(expandUs, std::chrono::duration<double, std::micro>(t2 - t1).count() / iters);
+        rectUs = std::min(rectUs, std::chrono::duration<double, std::micro>(t3 - t2).count() / iters);
+    }
+    (void)sink;
+
+    printf("  %s  frame (%d sprites) %.1f us incl. expand %.1f us; %d rect quads %.1f us; plane %u bytes\n\n",
+           ok ? "ok    " : "FAILED", blits, frameUs, expandUs,
+           blits * g_packClassic.sprites[SPR_INVADER_A].rectCount, rectUs, (unsigned)sizeof(Bitplane));
+
+    return ok;
+}
+
+int main(int argc, char** argv)
+{
+    const char* ppmPath = NULL;
+    int threads = 0;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--ppm") == 0 && i + 1 < argc)
+            ppmPath = argv[++i];
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+            threads = atoi(argv[++i]);
+    }
+
+    bool ok = true;
+
+    ok &= BenchSprites("classic", g_packClassic);
+    ok &= BenchSprites("secret", g_packSecret);
+    ok &= BenchStateCache();
+    RecordFrames();
+    ok &= BenchSoftRast(ppmPath);
+    ok &= BenchSoftBin(threads);
+    ok &= BenchSwizzle();
+    ok &= BenchColorKey();
+    ok &= BenchParticles();
+    ok &= BenchBitplane();
+
+    printf("%s\n", ok ? "OK" : "FAILED");
+    return ok ? 0 : 1;
+}
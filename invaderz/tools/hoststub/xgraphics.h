@@ -0,0 +1,8 @@
+#pragma once
+#include <xtl.h>
+
+// Host stand-in for the XDK's xgraphics.h (see xtl.h here). texload.cpp only
+// calls XGSwizzleRect from its debug self-check, which the host tools leave
+// out (no _DEBUG), so it is declared and never defined.
+void XGSwizzleRect(const void* src, DWORD pitch, const RECT* rect, void* dst,
+                   DWORD w, DWORD h, const void* point, DWORD bytesPerPixel);
@@ -0,0 +1,96 @@
+#pragma once
+
+// -----------------------------------------------------------------------------
+// Host stand-in for the XDK's xtl.h: just what texload.cpp uses, so
+// tools/texloadcheck.cpp can build the real loader on a PC. Only declarations;
+// the tool implements the file and device calls over memory.
+//
+// DWORD and LONG are 32-bit as on the Xbox (the DDS header is read as DWORDs).
+// -----------------------------------------------------------------------------
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef uint32_t DWORD;
+typedef uint16_t WORD;
+typedef uint8_t  BYTE;
+typedef int32_t  LONG;
+typedef int64_t  LONGLONG;
+typedef int      BOOL;
+typedef unsigned UINT;
+typedef int32_t  HRESULT;
+typedef void*    HANDLE;
+
+typedef union { LONGLONG QuadPart; } LARGE_INTEGER;
+
+#define TRUE    1
+#define FALSE   0
+#define S_OK    ((HRESULT)0)
+#define E_FAIL  ((HRESULT)0x80004005)
+#define FAILED(hr)      ((HRESULT)(hr) < 0)
+#define SUCCEEDED(hr)   ((HRESULT)(hr) >= 0)
+
+#if !defined(_MSC_VER)
+#define __forceinline inline __attribute__((always_inline))
+#endif
+
+// Files
+#define INVALID_HANDLE_VALUE    ((HANDLE)(intptr_t)-1)
+#define GENERIC_READ            0x80000000u
+#define FILE_SHARE_READ         0x00000001u
+#define OPEN_EXISTING           3
+#define FILE_ATTRIBUTE_NORMAL   0x00000080u
+
+HANDLE CreateFileA(const char* path, DWORD access, DWORD share, void* security,
+                   DWORD disposition, DWORD attributes, HANDLE templateFile);
+BOOL   ReadFile(HANDLE f, void* dst, DWORD bytes, DWORD* got, void* overlapped);
+BOOL   CloseHandle(HANDLE h);
+
+// Timing / memory / debug output
+BOOL QueryPerformanceCounter(LARGE_INTEGER* v);
+BOOL QueryPerformanceFrequency(LARGE_INTEGER* v);
+
+struct MEMORYSTATUS
+{
+    DWORD  dwLength;
+    DWORD  dwMemoryLoad;
+    size_t dwTotalPhys;
+    size_t dwAvailPhys;
+};
+void GlobalMemoryStatus(MEMORYSTATUS* ms);
+
+void OutputDebugStringA(const char* s);
+
+// Direct3D 8 (textures only)
+enum D3DFORMAT
+{
+    D3DFMT_UNKNOWN = 0,
+    D3DFMT_A8R8G8B8,
+    D3DFMT_DXT1,
+    D3DFMT_DXT4,
+    D3DFMT_DXT5,
+};
+
+struct RECT { LONG left, top, right, bottom; };
+
+struct D3DLOCKED_RECT
+{
+    int   Pitch;
+    void* pBits;
+};
+
+struct IDirect3DTexture8
+{
+    HRESULT LockRect(UINT level, D3DLOCKED_RECT* lr, const RECT* rect, DWORD flags);
+    HRESULT UnlockRect(UINT level);
+    DWORD   Release();
+};
+
+struct IDirect3DDevice8
+{
+    HRESULT CreateTexture(UINT w, UINT h, UINT levels, DWORD usage, D3DFORMAT fmt,
+                          DWORD pool, IDirect3DTexture8** out);
+};
+
+typedef IDirect3DTexture8* LPDIRECT3DTEXTURE8;
+typedef IDirect3DDevice8*  LPDIRECT3DDEVICE8;
@@ -0,0 +1,284 @@
+// softbin.cpp
+#include "softbin.h"
+
+#include <math.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// ------------------------------
+// Recording
+// ------------------------------
+void SB_Begin(SB_Frame& f, uint32_t clear)
+{
+    f.clear = clear;
+    f.states.clear();
+    f.cmds.clear();
+}
+
+// Consecutive draws with the same state share one entry
+static uint32_t StateIndex(SB_Frame& f, const SR_State& st)
+{
+    if (!f.states.empty())
+    {
+        const SR_State& last = f.states.back();
+        if (last.tex == st.tex && last.blend == st.blend && last.address == st.address)
+            return (uint32_t)(f.states.size() - 1);
+    }
+
+    f.states.push_back(st);
+    return (uint32_t)(f.states.size() - 1);
+}
+
+void SB_FillRect(SB_Frame& f, int x, int y, int w, int h, uint32_t color)
+{
+    if (w <= 0 || h <= 0) return;
+
+    // Integer edges cover exactly pixels x..x+w-1 (centre rule)
+    SR_State st = { NULL, SR_BLEND_NONE, SR_ADDRESS_CLAMP };
+
+    SB_Cmd c;
+    c.quad.x0 = (float)x;
+    c.quad.y0 = (float)y;
+    c.quad.x1 = (float)(x + w);
+    c.quad.y1 = (float)(y + h);
+    c.quad.u0 = c.quad.v0 = c.quad.u1 = c.quad.v1 = 0.0f;
+    c.quad.color = color;
+    c.state = StateIndex(f, st);
+    f.cmds.push_back(c);
+}
+
+void SB_DrawQuads(SB_Frame& f, const SR_State& st, const SR_Quad* quads, int count)
+{
+    if (!quads || count <= 0) return;
+
+    const uint32_t idx = StateIndex(f, st);
+    for (int i = 0; i < count; ++i)
+    {
+        SB_Cmd c;
+        c.quad = quads[i];
+        c.state = idx;
+        f.cmds.push_back(c);
+    }
+}
+
+// ------------------------------
+// Reference
+// ------------------------------
+void SB_RenderReference(SR_Target& t, const SB_Frame& f)
+{
+    SR_Clear(t, f.clear);
+
+    for (size_t i = 0; i < f.cmds.size(); ++i)
+    {
+        const SB_Cmd& c = f.cmds[i];
+        SR_DrawQuads(t, f.states[c.state], &c.quad, 1);
+    }
+}
+
+// ------------------------------
+// Thread pool
+// ------------------------------
+struct SB_Pool
+{
+    int threads;
+    std::vector<std::thread> workers;
+
+    std::mutex lock;
+    std::condition_variable wake;
+    std::condition_variable done;
+    uint32_t generation;        // bumped per frame
+    int busy;                   // workers still in the current frame
+    bool quit;
+
+    // Current frame
+    SR_Target* target;
+    const SB_Frame* frame;
+    std::atomic<int> nextTile;
+    std::atomic<uint64_t> quads;
+    std::atomic<uint64_t> pixels;
+
+    // Bins, reused between frames
+    int tilesX, tilesY;
+    std::vector<std::vector<uint32_t>> bins;
+};
+
+// Pixel rect a quad can touch (same centre rule as softrast)
+static void QuadPixels(const SR_Quad& q, int& x0, int& y0, int& x1, int& y1)
+{
+    x0 = (int)ceilf(q.x0 - 0.5f);
+    y0 = (int)ceilf(q.y0 - 0.5f);
+    x1 = (int)ceilf(q.x1 - 0.5f);
+    y1 = (int)ceilf(q.y1 - 0.5f);
+}
+
+static void Bin(SB_Pool* p, const SR_Target& t, const SB_Frame& f)
+{
+    p->tilesX = (t.w + SB_TILE_W - 1) / SB_TILE_W;
+    p->tilesY = (t.h + SB_TILE_H - 1) / SB_TILE_H;
+
+    const size_t tiles = (size_t)(p->tilesX * p->tilesY);
+    if (p->bins.size() < tiles) p->bins.resize(tiles);
+    for (size_t i = 0; i < tiles; ++i) p->bins[i].clear();
+
+    for (size_t i = 0; i < f.cmds.size(); ++i)
+    {
+        int x0, y0, x1, y1;
+        QuadPixels(f.cmds[i].quad, x0, y0, x1, y1);
+
+        if (x0 < 0) x0 = 0;
+        if (y0 < 0) y0 = 0;
+        if (x1 > t.w) x1 = t.w;
+        if (y1 > t.h) y1 = t.h;
+        if (x0 >= x1 || y0 >= y1) continue;
+
+        const int tx1 = (x1 - 1) / SB_TILE_W;
+        const int ty1 = (y1 - 1) / SB_TILE_H;
+        for (int ty = y0 / SB_TILE_H; ty <= ty1; ++ty)
+            for (int tx = x0 / SB_TILE_W; tx <= tx1; ++tx)
+                p->bins[(size_t)(ty * p->tilesX + tx)].push_back((uint32_t)i);
+    }
+}
+
+static void RenderTile(SB_Pool* p, int tile, uint64_t& quads, uint64_t& pixels)
+{
+    SR_Target& t = *p->target;
+    const SB_Frame& f = *p->frame;
+
+    const int cx0 = (tile % p->tilesX) * SB_TILE_W;
+    const int cy0 = (tile / p->tilesX) * SB_TILE_H;
+    const int cx1 = (cx0 + SB_TILE_W < t.w) ? cx0 + SB_TILE_W : t.w;
+    const int cy1 = (cy0 + SB_TILE_H < t.h) ? cy0 + SB_TILE_H : t.h;
+
+    const SR_State clearState = { NULL, SR_BLEND_NONE, SR_ADDRESS_CLAMP };
+    SR_Quad clearQuad = { (float)cx0, (float)cy0, (float)cx1, (float)cy1, 0, 0, 0, 0, f.clear };
+    SR_DrawQuadClipped(t, clearState, clearQuad, cx0, cy0, cx1, cy1);
+
+    const std::vector<uint32_t>& bin = p->bins[(size_t)tile];
+    for (size_t i = 0; i < bin.size(); ++i)
+    {
+        const SB_Cmd& c = f.cmds[bin[i]];
+        pixels += SR_DrawQuadClipped(t, f.states[c.state], c.quad, cx0, cy0, cx1, cy1);
+    }
+
+    // A quad counts once, in the tile holding its top-left pixel
+    for (size_t i = 0; i < bin.size(); ++i)
+    {
+        int x0, y0, x1, y1;
+        QuadPixels(f.cmds[bin[i]].quad, x0, y0, x1, y1);
+        if (x0 < 0) x0 = 0;
+        if (y0 < 0) y0 = 0;
+        if (x0 >= cx0 && x0 < cx1 && y0 >= cy0 && y0 < cy1) quads++;
+    }
+}
+
+static void WorkFrame(SB_Pool* p)
+{
+    const int tiles = p->tilesX * p->tilesY;
+    uint64_t quads = 0, pixels = 0;
+
+    for (;;)
+    {
+        const int tile = p->nextTile.fetch_add(1);
+        if (tile >= tiles) break;
+        RenderTile(p, tile, quads, pixels);
+    }
+
+    p->quads += quads;
+    p->pixels += pixels;
+}
+
+static void WorkerMain(SB_Pool* p)
+{
+    uint32_t seen = 0;
+
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> l(p->lock);
+            p->wake.wait(l, [&] { return p->quit || p->generation != seen; });
+            if (p->quit) return;
+            seen = p->generation;
+        }
+
+        WorkFrame(p);
+
+        std::lock_guard<std::mutex> l(p->lock);
+        if (--p->busy == 0)
+            p->done.notify_one();
+    }
+}
+
+SB_Pool* SB_CreatePool(int threads)
+{
+    if (threads < 1) threads = 1;
+
+    SB_Pool* p = new SB_Pool();
+    p->threads = threads;
+    p->generation = 0;
+    p->busy = 0;
+    p->quit = false;
+    p->target = NULL;
+    p->frame = NULL;
+    p->nextTile = 0;
+    p->tilesX = p->tilesY = 0;
+
+    for (int i = 1; i < threads; ++i)
+        p->workers.emplace_back(WorkerMain, p);
+
+    return p;
+}
+
+void SB_DestroyPool(SB_Pool* pool)
+{
+    if (!pool) return;
+
+    {
+        std::lock_guard<std::mutex> l(pool->lock);
+        pool->quit = true;
+    }
+    pool->wake.notify_all();
+
+    for (size_t i = 0; i < pool->workers.size(); ++i)
+        pool->workers[i].join();
+
+    delete pool;
+}
+
+int SB_PoolThreads(const SB_Pool* pool)
+{
+    return pool ? pool->threads : 0;
+}
+
+void SB_RenderBinned(SB_Pool* pool, SR_Target& t, const SB_Frame& f)
+{
+    if (!pool || !t.pixels) return;
+
+    Bin(pool, t, f);
+
+    pool->target = &t;
+    pool->frame = &f;
+    pool->nextTile = 0;
+    pool->quads = 0;
+    pool->pixels = 0;
+
+    {
+        std::lock_guard<std::mutex> l(pool->lock);
+        pool->busy = (int)pool->workers.size();
+        pool->generation++;
+    }
+    pool->wake.notify_all();
+
+    // The caller takes tiles too
+    WorkFrame(pool);
+
+    {
+        std::unique_lock<std::mutex> l(pool->lock);
+        pool->done.wait(l, [&] { return pool->busy == 0; });
+    }
+
+    t.quads += pool->quads;
+    t.pixelsWritten += pool->pixels;
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include <stdint.h>
+#include <vector>
+
+#include "softrast.h"
+
+// -----------------------------------------------------------------------------
+// Tile-binned, multithreaded front end for the software rasterizer (host side).
+//
+// A frame is recorded first (clear colour + quads in draw order, each with its
+// state), then rendered either
+//   - SB_RenderReference: one thread, quads in order over the whole target, or
+//   - SB_RenderBinned:    quads binned into SB_TILE_W x SB_TILE_H screen tiles,
+//                         tiles rasterized in parallel by a thread pool.
+// Each tile replays its quads in draw order through SR_DrawQuadClipped, which
+// writes exactly the pixels the unclipped draw would, so both paths produce
+// the same frame bit for bit whatever the thread count.
+//
+// Usage:
+//   SB_Frame f;  SB_Begin(f, clear);
+//   SB_FillRect(f, ...);  SB_DrawQuads(f, state, quads, n);
+//   SB_Pool* pool = SB_CreatePool(threads);
+//   SB_RenderBinned(pool, target, f);
+// -----------------------------------------------------------------------------
+
+#define SB_TILE_W 64
+#define SB_TILE_H 32
+
+struct SB_Cmd
+{
+    SR_Quad quad;
+    uint32_t state;         // index into SB_Frame::states
+};
+
+struct SB_Frame
+{
+    uint32_t clear;
+    std::vector<SR_State> states;
+    std::vector<SB_Cmd> cmds;
+};
+
+// Recording. States are copied; textures must outlive the render.
+void SB_Begin(SB_Frame& f, uint32_t clear);
+void SB_FillRect(SB_Frame& f, int x, int y, int w, int h, uint32_t color);
+void SB_DrawQuads(SB_Frame& f, const SR_State& st, const SR_Quad* quads, int count);
+
+// Single-threaded reference. Updates the target's stats.
+void SB_RenderReference(SR_Target& t, const SB_Frame& f);
+
+struct SB_Pool;
+
+// threads >= 1; the calling thread counts as one of them.
+SB_Pool* SB_CreatePool(int threads);
+void SB_DestroyPool(SB_Pool* pool);
+int  SB_PoolThreads(const SB_Pool* pool);
+
+// Bins and renders in parallel; returns when the frame is complete.
+// Updates the target's stats like the reference does.
+void SB_RenderBinned(SB_Pool* pool, SR_Target& t, const SB_Frame& f);
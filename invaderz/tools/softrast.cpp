@@ -0,0 +1,536 @@
+// softrast.cpp
+#include "softrast.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#if defined(_M_X64) || defined(__x86_64__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define SR_HAVE_SSE2 1
+#include <emmintrin.h>
+#else
+#define SR_HAVE_SSE2 0
+#endif
+
+#if SR_HAVE_SSE2 && defined(__AVX2__)
+#define SR_HAVE_AVX2 1
+#include <immintrin.h>
+#else
+#define SR_HAVE_AVX2 0
+#endif
+
+// Widest textured span handled in one go
+static const int SR_SPAN_MAX = 1024;
+
+// ------------------------------
+// Scalar reference
+// ------------------------------
+
+// round(a * b / 255) for bytes; the SIMD kernels compute exactly this
+static inline uint32_t Mul8(uint32_t a, uint32_t b)
+{
+    uint32_t x = a * b + 128;
+    return (x + (x >> 8)) >> 8;
+}
+
+static inline uint32_t Channel(uint32_t c, int shift) { return (c >> shift) & 0xFF; }
+
+static inline uint32_t Sat8(uint32_t v) { return v > 255 ? 255 : v; }
+
+static void Fill_Scalar(uint32_t* dst, int n, uint32_t c)
+{
+    for (int i = 0; i < n; ++i) dst[i] = c;
+}
+
+static void Modulate_Scalar(uint32_t* span, int n, uint32_t color)
+{
+    for (int i = 0; i < n; ++i)
+    {
+        const uint32_t s = span[i];
+        uint32_t out = 0;
+        for (int sh = 0; sh < 32; sh += 8)
+            out |= Mul8(Channel(s, sh), Channel(color, sh)) << sh;
+        span[i] = out;
+    }
+}
+
+static void Blend_Scalar(uint32_t* dst, const uint32_t* src, int n, SR_Blend blend)
+{
+    for (int i = 0; i < n; ++i)
+    {
+        const uint32_t s = src[i];
+        const uint32_t d = dst[i];
+        const uint32_t a = s >> 24;
+
+        uint32_t out = 0;
+        for (int sh = 0; sh < 32; sh += 8)
+        {
+            const uint32_t sc = Channel(s, sh);
+            const uint32_t dc = Channel(d, sh);
+            uint32_t v;
+
+            switch (blend)
+            {
+            case SR_BLEND_ALPHA:  v = Mul8(sc, a) + Mul8(dc, 255 - a); break;
+            case SR_BLEND_ADD:    v = Sat8(dc + Mul8(sc, a)); break;
+            case SR_BLEND_PREMUL: v = Sat8(sc + Mul8(dc, 255 - a)); break;
+            default:              v = sc; break;
+            }
+
+            out |= v << sh;
+        }
+        dst[i] = out;
+    }
+}
+
+static void Expand4_Scalar(uint32_t* dst, const uint8_t* packed, int count, const uint32_t* pal)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        const uint8_t b = packed[i >> 1];
+        dst[i] = pal[(i & 1) ? (b & 0x0F) : (b >> 4)];
+    }
+}
+
+// ------------------------------
+// SSE2 (4 pixels per step)
+// ------------------------------
+#if SR_HAVE_SSE2
+
+// Per 16-bit lane: round(a * b / 255), inputs 0..255
+static inline __m128i Mul8_SSE2(__m128i a, __m128i b)
+{
+    __m128i x = _mm_add_epi16(_mm_mullo_epi16(a, b), _mm_set1_epi16(128));
+    return _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+}
+
+// Broadcasts each pixel's alpha to its four 16-bit channel lanes
+static inline __m128i AlphaLanes_SSE2(__m128i px16)
+{
+    __m128i a = _mm_shufflelo_epi16(px16, _MM_SHUFFLE(3, 3, 3, 3));
+    return _mm_shufflehi_epi16(a, _MM_SHUFFLE(3, 3, 3, 3));
+}
+
+static void Fill_SSE2(uint32_t* dst, int n, uint32_t c)
+{
+    const __m128i v = _mm_set1_epi32((int)c);
+    int i = 0;
+    for (; i + 4 <= n; i += 4)
+        _mm_storeu_si128((__m128i*)(dst + i), v);
+    Fill_Scalar(dst + i, n - i, c);
+}
+
+static void Modulate_SSE2(uint32_t* span, int n, uint32_t color)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i col = _mm_unpacklo_epi8(_mm_set1_epi32((int)color), zero);
+
+    int i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        const __m128i s = _mm_loadu_si128((const __m128i*)(span + i));
+        const __m128i lo = Mul8_SSE2(_mm_unpacklo_epi8(s, zero), col);
+        const __m128i hi = Mul8_SSE2(_mm_unpackhi_epi8(s, zero), col);
+        _mm_storeu_si128((__m128i*)(span + i), _mm_packus_epi16(lo, hi));
+    }
+    Modulate_Scalar(span + i, n - i, color);
+}
+
+static inline __m128i Blend2_SSE2(__m128i s, __m128i d, SR_Blend blend)
+{
+    const __m128i a = AlphaLanes_SSE2(s);
+    const __m128i inv = _mm_sub_epi16(_mm_set1_epi16(255), a);
+
+    switch (blend)
+    {
+    case SR_BLEND_ALPHA:  return _mm_add_epi16(Mul8_SSE2(s, a), Mul8_SSE2(d, inv));
+    case SR_BLEND_ADD:    return _mm_add_epi16(d, Mul8_SSE2(s, a));
+    case SR_BLEND_PREMUL: return _mm_add_epi16(s, Mul8_SSE2(d, inv));
+    default:              return s;
+    }
+}
+
+static void Blend_SSE2(uint32_t* dst, const uint32_t* src, int n, SR_Blend blend)
+{
+    const __m128i zero = _mm_setzero_si128();
+
+    int i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        const __m128i s = _mm_loadu_si128((const __m128i*)(src + i));
+        const __m128i d = _mm_loadu_si128((const __m128i*)(dst + i));
+
+        const __m128i lo = Blend2_SSE2(_mm_unpacklo_epi8(s, zero), _mm_unpacklo_epi8(d, zero), blend);
+        const __m128i hi = Blend2_SSE2(_mm_unpackhi_epi8(s, zero), _mm_unpackhi_epi8(d, zero), blend);
+
+        // packus saturates, which is the clamp ADD / PREMUL need
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_packus_epi16(lo, hi));
+    }
+    Blend_Scalar(dst + i, src + i, n - i, blend);
+}
+
+#endif // SR_HAVE_SSE2
+
+// ------------------------------
+// AVX2 (8 pixels per step)
+// ------------------------------
+#if SR_HAVE_AVX2
+
+static inline __m256i Mul8_AVX2(__m256i a, __m256i b)
+{
+    __m256i x = _mm256_add_epi16(_mm256_mullo_epi16(a, b), _mm256_set1_epi16(128));
+    return _mm256_srli_epi16(_mm256_add_epi16(x, _mm256_srli_epi16(x, 8)), 8);
+}
+
+static inline __m256i AlphaLanes_AVX2(__m256i px16)
+{
+    __m256i a = _mm256_shufflelo_epi16(px16, _MM_SHUFFLE(3, 3, 3, 3));
+    return _mm256_shufflehi_epi16(a, _MM_SHUFFLE(3, 3, 3, 3));
+}
+
+static void Fill_AVX2(uint32_t* dst, int n, uint32_t c)
+{
+    const __m256i v = _mm256_set1_epi32((int)c);
+    int i = 0;
+    for (; i + 8 <= n; i += 8)
+        _mm256_storeu_si256((__m256i*)(dst + i), v);
+    Fill_SSE2(dst + i, n - i, c);
+}
+
+static void Modulate_AVX2(uint32_t* span, int n, uint32_t color)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i col = _mm256_unpacklo_epi8(_mm256_set1_epi32((int)color), zero);
+
+    int i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        const __m256i s = _mm256_loadu_si256((const __m256i*)(span + i));
+        const __m256i lo = Mul8_AVX2(_mm256_unpacklo_epi8(s, zero), col);
+        const __m256i hi = Mul8_AVX2(_mm256_unpackhi_epi8(s, zero), col);
+        _mm256_storeu_si256((__m256i*)(span + i), _mm256_packus_epi16(lo, hi));
+    }
+    Modulate_SSE2(span + i, n - i, color);
+}
+
+static inline __m256i Blend2_AVX2(__m256i s, __m256i d, SR_Blend blend)
+{
+    const __m256i a = AlphaLanes_AVX2(s);
+    const __m256i inv = _mm256_sub_epi16(_mm256_set1_epi16(255), a);
+
+    switch (blend)
+    {
+    case SR_BLEND_ALPHA:  return _mm256_add_epi16(Mul8_AVX2(s, a), Mul8_AVX2(d, inv));
+    case SR_BLEND_ADD:    return _mm256_add_epi16(d, Mul8_AVX2(s, a));
+    case SR_BLEND_PREMUL: return _mm256_add_epi16(s, Mul8_AVX2(d, inv));
+    default:              return s;
+    }
+}
+
+static void Blend_AVX2(uint32_t* dst, const uint32_t* src, int n, SR_Blend blend)
+{
+    const __m256i zero = _mm256_setzero_si256();
+
+    int i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        const __m256i s = _mm256_loadu_si256((const __m256i*)(src + i));
+        const __m256i d = _mm256_loadu_si256((const __m256i*)(dst + i));
+
+        // unpack/pack work per 128-bit lane, so pixel order is preserved
+        const __m256i lo = Blend2_AVX2(_mm256_unpacklo_epi8(s, zero), _mm256_unpacklo_epi8(d, zero), blend);
+        const __m256i hi = Blend2_AVX2(_mm256_unpackhi_epi8(s, zero), _mm256_unpackhi_epi8(d, zero), blend);
+
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm256_packus_epi16(lo, hi));
+    }
+    Blend_SSE2(dst + i, src + i, n - i, blend);
+}
+
+// 8 nibbles -> 8 palette entries with one gather
+static void Expand4_AVX2(uint32_t* dst, const uint8_t* packed, int count, const uint32_t* pal)
+{
+    const __m256i shifts = _mm256_setr_epi32(4, 0, 4, 0, 4, 0, 4, 0);
+    const __m256i mask = _mm256_set1_epi32(0x0F);
+
+    int i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        const uint8_t* p = packed + (i >> 1);
+        const __m256i bytes = _mm256_setr_epi32(p[0], p[0], p[1], p[1], p[2], p[2], p[3], p[3]);
+        const __m256i idx = _mm256_and_si256(_mm256_srlv_epi32(bytes, shifts), mask);
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm256_i32gather_epi32((const int*)pal, idx, 4));
+    }
+
+    // i is even here, so the tail still starts on a byte boundary
+    Expand4_Scalar(dst + i, packed + (i >> 1), count - i, pal);
+}
+
+#endif // SR_HAVE_AVX2
+
+// ------------------------------
+// Kernel table
+// ------------------------------
+struct SR_Kernels
+{
+    void (*fill)(uint32_t*, int, uint32_t);
+    void (*modulate)(uint32_t*, int, uint32_t);
+    void (*blend)(uint32_t*, const uint32_t*, int, SR_Blend);
+    void (*expand4)(uint32_t*, const uint8_t*, int, const uint32_t*);
+};
+
+static const SR_Kernels kKernels[SR_KERNEL_COUNT] =
+{
+    { Fill_Scalar, Modulate_Scalar, Blend_Scalar, Expand4_Scalar },
+#if SR_HAVE_SSE2
+    // No gather before AVX2; the table lookup stays scalar
+    { Fill_SSE2, Modulate_SSE2, Blend_SSE2, Expand4_Scalar },
+#else
+    { NULL, NULL, NULL, NULL },
+#endif
+#if SR_HAVE_AVX2
+    { Fill_AVX2, Modulate_AVX2, Blend_AVX2, Expand4_AVX2 },
+#else
+    { NULL, NULL, NULL, NULL },
+#endif
+};
+
+static const char* const kKernelNames[SR_KERNEL_COUNT] = { "scalar", "sse2", "avx2" };
+
+static SR_Kernel s_kernel = SR_HAVE_AVX2 ? SR_KERNEL_AVX2 : (SR_HAVE_SSE2 ? SR_KERNEL_SSE2 : SR_KERNEL_SCALAR);
+
+bool SR_KernelAvailable(SR_Kernel k)
+{
+    return (unsigned)k < (unsigned)SR_KERNEL_COUNT && kKernels[k].fill != NULL;
+}
+
+bool SR_SetKernel(SR_Kernel k)
+{
+    if (!SR_KernelAvailable(k)) return false;
+    s_kernel = k;
+    return true;
+}
+
+SR_Kernel SR_GetKernel()
+{
+    return s_kernel;
+}
+
+const char* SR_KernelName(SR_Kernel k)
+{
+    return ((unsigned)k < (unsigned)SR_KERNEL_COUNT) ? kKernelNames[k] : "?";
+}
+
+// ------------------------------
+// Targets
+// ------------------------------
+bool SR_CreateTarget(SR_Target& t, int w, int h)
+{
+    memset(&t, 0, sizeof(t));
+    if (w <= 0 || h <= 0) return false;
+
+    t.pixels = (uint32_t*)malloc((size_t)w * (size_t)h * sizeof(uint32_t));
+    if (!t.pixels) return false;
+
+    t.w = w;
+    t.h = h;
+    return true;
+}
+
+void SR_DestroyTarget(SR_Target& t)
+{
+    free(t.pixels);
+    memset(&t, 0, sizeof(t));
+}
+
+void SR_ResetStats(SR_Target& t)
+{
+    t.quads = 0;
+    t.pixelsWritten = 0;
+}
+
+void SR_Clear(SR_Target& t, uint32_t color)
+{
+    if (!t.pixels) return;
+    kKernels[s_kernel].fill(t.pixels, t.w * t.h, color);
+}
+
+void SR_FillRect(SR_Target& t, int x, int y, int w, int h, uint32_t color)
+{
+    if (!t.pixels) return;
+
+    int x0 = x, y0 = y, x1 = x + w, y1 = y + h;
+    if (x0 < 0) x0 = 0;
+    if (y0 < 0) y0 = 0;
+    if (x1 > t.w) x1 = t.w;
+    if (y1 > t.h) y1 = t.h;
+    if (x0 >= x1 || y0 >= y1) return;
+
+    const SR_Kernels& k = kKernels[s_kernel];
+    for (int yy = y0; yy < y1; ++yy)
+        k.fill(t.pixels + yy * t.w + x0, x1 - x0, color);
+
+    t.quads++;
+    t.pixelsWritten += (uint64_t)(x1 - x0) * (uint64_t)(y1 - y0);
+}
+
+// ------------------------------
+// Quads
+// ------------------------------
+
+// First pixel whose centre is at or right of v
+static inline int FirstCovered(float v)
+{
+    return (int)ceilf(v - 0.5f);
+}
+
+static inline int AddressTexel(int t, int size, SR_Address mode)
+{
+    if (mode == SR_ADDRESS_WRAP)
+    {
+        t %= size;
+        return t < 0 ? t + size : t;
+    }
+    return t < 0 ? 0 : (t >= size ? size - 1 : t);
+}
+
+// Clip rect must already lie inside the target
+static uint64_t DrawQuad(SR_Target& t, const SR_State& st, const SR_Quad& q,
+                         int cx0, int cy0, int cx1, int cy1)
+{
+    int px0 = FirstCovered(q.x0), px1 = FirstCovered(q.x1);
+    int py0 = FirstCovered(q.y0), py1 = FirstCovered(q.y1);
+    if (px0 < cx0) px0 = cx0;
+    if (py0 < cy0) py0 = cy0;
+    if (px1 > cx1) px1 = cx1;
+    if (py1 > cy1) py1 = cy1;
+    if (px0 >= px1 || py0 >= py1) return 0;
+
+    const SR_Kernels& k = kKernels[s_kernel];
+    const SR_Texture* tex = st.tex;
+
+    const uint64_t written = (uint64_t)(px1 - px0) * (uint64_t)(py1 - py0);
+
+    uint32_t span[SR_SPAN_MAX];
+
+    if (!tex || !tex->texels)
+    {
+        // Flat colour: one fill per row when opaque, blended spans otherwise
+        if (st.blend == SR_BLEND_NONE)
+        {
+            for (int y = py0; y < py1; ++y)
+                k.fill(t.pixels + y * t.w + px0, px1 - px0, q.color);
+            return written;
+        }
+
+        for (int x = px0; x < px1; x += SR_SPAN_MAX)
+        {
+            const int n = (px1 - x < SR_SPAN_MAX) ? (px1 - x) : SR_SPAN_MAX;
+            k.fill(span, n, q.color);
+            for (int y = py0; y < py1; ++y)
+                k.blend(t.pixels + y * t.w + x, span, n, st.blend);
+        }
+        return written;
+    }
+
+    // Texel coordinates per screen pixel (sampled at pixel centres)
+    const float du = (q.u1 - q.u0) / (q.x1 - q.x0) * (float)tex->w;
+    const float dv = (q.v1 - q.v0) / (q.y1 - q.y0) * (float)tex->h;
+    const float uBase = q.u0 * (float)tex->w;
+    const float vBase = q.v0 * (float)tex->h;
+
+    for (int y = py0; y < py1; ++y)
+    {
+        const float v = vBase + ((float)y + 0.5f - q.y0) * dv;
+        const int ty = AddressTexel((int)floorf(v), tex->h, st.address);
+        const uint32_t* row = tex->texels + ty * tex->w;
+
+        for (int x = px0; x < px1; x += SR_SPAN_MAX)
+        {
+            const int n = (px1 - x < SR_SPAN_MAX) ? (px1 - x) : SR_SPAN_MAX;
+
+            // Gather stays scalar in every kernel (same result everywhere)
+            for (int i = 0; i < n; ++i)
+            {
+                const float u = uBase + ((float)(x + i) + 0.5f - q.x0) * du;
+                span[i] = row[AddressTexel((int)floorf(u), tex->w, st.address)];
+            }
+
+            if (q.color != 0xFFFFFFFFu)
+                k.modulate(span, n, q.color);
+
+            k.blend(t.pixels + y * t.w + x, span, n, st.blend);
+        }
+    }
+    return written;
+}
+
+void SR_DrawQuads(SR_Target& t, const SR_State& st, const SR_Quad* quads, int count)
+{
+    if (!t.pixels || !quads) return;
+
+    for (int i = 0; i < count; ++i)
+    {
+        const uint64_t n = DrawQuad(t, st, quads[i], 0, 0, t.w, t.h);
+        if (n == 0) continue;
+
+        t.quads++;
+        t.pixelsWritten += n;
+    }
+}
+
+uint64_t SR_DrawQuadClipped(SR_Target& t, const SR_State& st, const SR_Quad& q,
+                            int cx0, int cy0, int cx1, int cy1)
+{
+    if (!t.pixels) return 0;
+
+    if (cx0 < 0) cx0 = 0;
+    if (cy0 < 0) cy0 = 0;
+    if (cx1 > t.w) cx1 = t.w;
+    if (cy1 > t.h) cy1 = t.h;
+    if (cx0 >= cx1 || cy0 >= cy1) return 0;
+
+    return DrawQuad(t, st, q, cx0, cy0, cx1, cy1);
+}
+
+void SR_ExpandPalette4(uint32_t* dst, const uint8_t* packed, int count, const uint32_t* palette16)
+{
+    if (!dst || !packed || !palette16 || count <= 0) return;
+    kKernels[s_kernel].expand4(dst, packed, count, palette16);
+}
+
+// ------------------------------
+// Output
+// ------------------------------
+bool SR_WritePPM(const SR_Target& t, const char* path)
+{
+    if (!t.pixels || !path) return false;
+
+    FILE* f = fopen(path, "wb");
+    if (!f) return false;
+
+    fprintf(f, "P6\n%d %d\n255\n", t.w, t.h);
+
+    unsigned char* row = (unsigned char*)malloc((size_t)t.w * 3);
+    if (!row)
+    {
+        fclose(f);
+        return false;
+    }
+
+    bool ok = true;
+    for (int y = 0; y < t.h && ok; ++y)
+    {
+        const uint32_t* src = t.pixels + y * t.w;
+        for (int x = 0; x < t.w; ++x)
+        {
+            row[x * 3 + 0] = (unsigned char)(src[x] >> 16);
+            row[x * 3 + 1] = (unsigned char)(src[x] >> 8);
+            row[x * 3 + 2] = (unsigned char)(src[x]);
+        }
+        ok = fwrite(row, 3, (size_t)t.w, f) == (size_t)t.w;
+    }
+
+    free(row);
+    return (fclose(f) == 0) && ok;
+}
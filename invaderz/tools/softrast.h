@@ -0,0 +1,115 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+// -----------------------------------------------------------------------------
+// Software 2D rasterizer (host side).
+//
+// Implements the primitives the batch (batch.h) and the cloud pass send to the
+// device: opaque flat rects and point-sampled textured quads (texture *
+// colour), blended as
+//   SR_BLEND_NONE     src
+//   SR_BLEND_ALPHA    src * a + dst * (1 - a)         (sprites, text)
+//   SR_BLEND_ADD      dst + src * a                   (additive overlays)
+//   SR_BLEND_PREMUL   src + dst * (1 - a)             (clouds.cpp)
+// with clamp or wrap addressing, into a plain ARGB framebuffer. No D3D types,
+// so frames can be rendered, timed and diffed on a PC without a GPU.
+//
+// Pixel rules follow the device: a pixel is covered when its centre is inside
+// [x0, x1) x [y0, y1), and sampled at its centre.
+//
+// Spans are filled, modulated and blended by SIMD kernels where the compiler
+// allows (SSE2; AVX2 when built with -mavx2 or /arch:AVX2) with a scalar
+// fallback. All kernels use the same integer maths, so output is identical
+// whichever runs; SR_SetKernel picks one explicitly for comparisons.
+//
+// Not part of the Xbox project (the Pentium III has no SSE2); see
+// tools/hostbench.cpp for how it is built and driven.
+// -----------------------------------------------------------------------------
+
+struct SR_Target
+{
+    uint32_t* pixels;       // w * h ARGB, rows packed
+    int w, h;
+
+    // Work done since the last SR_ResetStats
+    uint64_t quads;
+    uint64_t pixelsWritten;
+};
+
+struct SR_Texture
+{
+    const uint32_t* texels; // w * h ARGB, linear (not swizzled)
+    int w, h;
+};
+
+enum SR_Blend
+{
+    SR_BLEND_NONE = 0,
+    SR_BLEND_ALPHA,
+    SR_BLEND_ADD,
+    SR_BLEND_PREMUL,
+};
+
+enum SR_Address
+{
+    SR_ADDRESS_CLAMP = 0,
+    SR_ADDRESS_WRAP,
+};
+
+// Screen rect plus normalized UVs (as Batch_MakeQuadUV lays them out)
+struct SR_Quad
+{
+    float x0, y0, x1, y1;
+    float u0, v0, u1, v1;
+    uint32_t color;
+};
+
+struct SR_State
+{
+    const SR_Texture* tex;  // NULL = flat colour
+    SR_Blend blend;
+    SR_Address address;
+};
+
+enum SR_Kernel
+{
+    SR_KERNEL_SCALAR = 0,
+    SR_KERNEL_SSE2,
+    SR_KERNEL_AVX2,
+
+    SR_KERNEL_COUNT
+};
+
+// Allocates / frees the framebuffer.
+bool SR_CreateTarget(SR_Target& t, int w, int h);
+void SR_DestroyTarget(SR_Target& t);
+void SR_ResetStats(SR_Target& t);
+
+void SR_Clear(SR_Target& t, uint32_t color);
+
+// Opaque flat rect (integer pixels, clipped).
+void SR_FillRect(SR_Target& t, int x, int y, int w, int h, uint32_t color);
+
+// Quads drawn with one state. With no texture the quad colour is used as-is.
+void SR_DrawQuads(SR_Target& t, const SR_State& st, const SR_Quad* quads, int count);
+
+// One quad limited to the pixel rect [cx0, cx1) x [cy0, cy1), e.g. a screen
+// tile. Pixels come out exactly as SR_DrawQuads would write them; stats are
+// not touched (safe to call from several threads on disjoint rects). Returns
+// the number of pixels written.
+uint64_t SR_DrawQuadClipped(SR_Target& t, const SR_State& st, const SR_Quad& q,
+                            int cx0, int cy0, int cx1, int cy1);
+
+// Expands 4bpp packed pixels (high nibble first, as sprites.h) to ARGB.
+void SR_ExpandPalette4(uint32_t* dst, const uint8_t* packed, int count, const uint32_t* palette16);
+
+// Kernel selection. Only kernels compiled in are available; the best one is
+// selected by default.
+bool SR_KernelAvailable(SR_Kernel k);
+bool SR_SetKernel(SR_Kernel k);
+SR_Kernel SR_GetKernel();
+const char* SR_KernelName(SR_Kernel k);
+
+// Binary PPM (P6), alpha dropped.
+bool SR_WritePPM(const SR_Target& t, const char* path);
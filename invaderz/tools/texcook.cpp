@@ -0,0 +1,768 @@
+// texcook.cpp
+//
+// Offline texture cooker: converts a .dds the game loads into one of the
+// other formats the loaders accept (texfmt.h), and reports what it saves.
+// Not part of the Xbox project; build it by hand with any C++17 compiler:
+//
+//   g++ -std=c++17 -O2 -o texcook tools/texcook.cpp texfmt.cpp colorkey.cpp      (from invaderz/)
+//   cl /std:c++17 /O2 /EHsc tools\texcook.cpp texfmt.cpp colorkey.cpp
+//
+// Usage: texcook in.dds out.dds --fmt argb|dxt1|dxt4|dxt5|p8 [--key TOL]
+//        texcook in.dds --info
+//
+//   --key TOL  applies the title screen's colour key before encoding (top-left
+//              pixel, per-channel tolerance TOL; colorkey.h), so the game
+//              doesn't have to. The result is premultiplied and the output is
+//              marked DDPF_ALPHAPREMULT; the title loader skips its own key for
+//              A8R8G8B8 carrying that flag. DXT1 stores it as 1-bit alpha.
+//              Ignored if the input is already premultiplied.
+//   dxt4       is DXT5 with colour premultiplied by alpha (the cloud overlay
+//              wants that; clouds.h), done here instead of at load.
+//
+// Shipped assets (Media/tex) are cooked with:
+//   texcook title_classic.dds title_classic.dds --fmt dxt1 --key 16    (likewise title_secret)
+//   texcook cloud_256.dds cloud_256.dds --fmt dxt4
+// To keep a title logo uncompressed but keyed ahead of time:
+//   texcook title_raw.dds title_classic.dds --fmt argb --key 16
+//
+// Prints file and texture memory sizes before and after, encode time, the
+// time to decode the result with the game's own decoder (the software path
+// the loaders fall back on, and what drawrec uses), and the error against the
+// source as PSNR: colour over texels visible (alpha > 0) in both, alpha over
+// all texels.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include "../colorkey.h"
+#include "../texfmt.h"
+
+#pragma pack(push, 1)
+struct DdsPixelFormat
+{
+    uint32_t size, flags, fourCC, rgbBitCount, rMask, gMask, bMask, aMask;
+};
+
+struct DdsHeader
+{
+    uint32_t size, flags, height, width, pitchOrLinearSize, depth, mipMapCount;
+    uint32_t reserved1[11];
+    DdsPixelFormat ddspf;
+    uint32_t caps, caps2, caps3, caps4, reserved2;
+};
+#pragma pack(pop)
+
+struct Image
+{
+    int w, h;
+    std::vector<uint32_t> texels;   // 0xAARRGGBB
+};
+
+static double NowMs()
+{
+    using namespace std::chrono;
+    return duration<double, std::milli>(steady_clock::now().time_since_epoch()).count();
+}
+
+// Texture memory the game's loader uses (texload.cpp): DXT stays compressed,
+// everything else becomes A8R8G8B8.
+static uint32_t TextureBytes(TexFmt fmt, int w, int h)
+{
+    if (TexFmt_IsBlock(fmt))
+        return TexFmt_DataBytes(fmt, w, h);
+    return (uint32_t)(w * h * 4);
+}
+
+// ------------------------------
+// DDS files
+// ------------------------------
+static bool ReadDds(const char* path, TexFmt& fmt, int& w, int& h, bool& premult,
+                    std::vector<uint8_t>& data)
+{
+    FILE* f = fopen(path, "rb");
+    if (!f)
+    {
+        fprintf(stderr, "can't open %s\n", path);
+        return false;
+    }
+
+    uint32_t magic = 0;
+    DdsHeader hdr;
+    bool ok = fread(&magic, 4, 1, f) == 1 && magic == DDS_MAGIC &&
+              fread(&hdr, sizeof(hdr), 1, f) == 1 &&
+              hdr.size == 124 && hdr.ddspf.size == 32;
+
+    fmt = ok ? TexFmt_FromDDS(hdr.ddspf.flags, hdr.ddspf.fourCC, hdr.ddspf.rgbBitCount,
+                              hdr.ddspf.rMask, hdr.ddspf.gMask, hdr.ddspf.bMask, hdr.ddspf.aMask)
+             : TEXFMT_UNKNOWN;
+    w = (int)hdr.width;
+    h = (int)hdr.height;
+    premult = fmt == TEXFMT_DXT4 || (hdr.ddspf.flags & DDPF_ALPHAPREMULT) != 0;
+
+    if (ok && fmt != TEXFMT_UNKNOWN && w > 0 && h > 0)
+    {
+        data.resize(TexFmt_DataBytes(fmt, w, h));
+        ok = fread(data.data(), 1, data.size(), f) == data.size();
+    }
+    else
+    {
+        ok = false;
+    }
+
+    fclose(f);
+
+    if (!ok) fprintf(stderr, "%s: not a DDS the game can load\n", path);
+    return ok;
+}
+
+static bool WriteDds(const char* path, TexFmt fmt, int w, int h, bool premult,
+                     const std::vector<uint8_t>& data)
+{
+    DdsHeader hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    hdr.size = 124;
+    hdr.flags = 0x1 | 0x2 | 0x4 | 0x1000;           // CAPS | HEIGHT | WIDTH | PIXELFORMAT
+    hdr.height = (uint32_t)h;
+    hdr.width = (uint32_t)w;
+    hdr.caps = 0x1000;                              // DDSCAPS_TEXTURE
+    hdr.ddspf.size = 32;
+
+    switch (fmt)
+    {
+    case TEXFMT_A8R8G8B8:
+        hdr.flags |= 0x8;                           // PITCH
+        hdr.pitchOrLinearSize = (uint32_t)w * 4;
+        hdr.ddspf.flags = DDPF_RGB | DDPF_ALPHAPIXELS;
+        hdr.ddspf.rgbBitCount = 32;
+        hdr.ddspf.rMask = 0x00FF0000;
+        hdr.ddspf.gMask = 0x0000FF00;
+        hdr.ddspf.bMask = 0x000000FF;
+        hdr.ddspf.aMask = 0xFF000000;
+        break;
+
+    case TEXFMT_DXT1:
+    case TEXFMT_DXT4:
+    case TEXFMT_DXT5:
+        hdr.flags |= 0x80000;                       // LINEARSIZE
+        hdr.pitchOrLinearSize = TexFmt_DataBytes(fmt, w, h);
+        hdr.ddspf.flags = DDPF_FOURCC;
+        hdr.ddspf.fourCC = (fmt == TEXFMT_DXT1) ? FOURCC_DXT1 :
+                           (fmt == TEXFMT_DXT4) ? FOURCC_DXT4 : FOURCC_DXT5;
+        break;
+
+    case TEXFMT_P8:
+        hdr.flags |= 0x8;
+        hdr.pitchOrLinearSize = (uint32_t)w;
+        hdr.ddspf.flags = DDPF_PALETTEINDEXED8;
+        hdr.ddspf.rgbBitCount = 8;
+        break;
+
+    default:
+        return false;
+    }
+
+    if (premult)
+        hdr.ddspf.flags |= DDPF_ALPHAPREMULT;
+
+    FILE* f = fopen(path, "wb");
+    if (!f)
+    {
+        fprintf(stderr, "can't write %s\n", path);
+        return false;
+    }
+
+    const uint32_t magic = DDS_MAGIC;
+    bool ok = fwrite(&magic, 4, 1, f) == 1 &&
+              fwrite(&hdr, sizeof(hdr), 1, f) == 1 &&
+              fwrite(data.data(), 1, data.size(), f) == data.size();
+
+    ok &= fclose(f) == 0;
+    return ok;
+}
+
+static void Decode(TexFmt fmt, const std::vector<uint8_t>& data, Image& img)
+{
+    img.texels.resize((size_t)img.w * img.h);
+
+    if (fmt == TEXFMT_A8R8G8B8)
+        memcpy(img.texels.data(), data.data(), img.texels.size() * 4);
+    else if (fmt == TEXFMT_P8)
+        TexFmt_ExpandP8(data.data(), img.w, img.h, img.texels.data());
+    else
+        TexFmt_DecodeDXT(fmt, data.data(), (int)TexFmt_RowBytes(fmt, img.w),
+                         img.w, img.h, img.texels.data(), img.w * 4);
+}
+
+// rgb *= a, rounded like Clouds_PrepareTexture
+static void Premultiply(Image& img)
+{
+    for (uint32_t& t : img.texels)
+    {
+        const uint32_t a = t >> 24;
+        uint32_t out = a << 24;
+        for (int s = 0; s < 24; s += 8)
+            out |= ((((t >> s) & 0xFF) * a + 127) / 255) << s;
+        t = out;
+    }
+}
+
+// ------------------------------
+// DXT encoder
+// ------------------------------
+struct Vec3
+{
+    float r, g, b;
+};
+
+static inline Vec3 ToVec(uint32_t c)
+{
+    Vec3 v = { (float)((c >> 16) & 0xFF), (float)((c >> 8) & 0xFF), (float)(c & 0xFF) };
+    return v;
+}
+
+static inline int Clamp(int v, int lo, int hi)
+{
+    return v < lo ? lo : (v > hi ? hi : v);
+}
+
+static inline uint32_t To565(const Vec3& v)
+{
+    const int r = Clamp((int)(v.r * 31.0f / 255.0f + 0.5f), 0, 31);
+    const int g = Clamp((int)(v.g * 63.0f / 255.0f + 0.5f), 0, 63);
+    const int b = Clamp((int)(v.b * 31.0f / 255.0f + 0.5f), 0, 31);
+    return (uint32_t)(r << 11 | g << 5 | b);
+}
+
+static inline int Dist2(uint32_t a, uint32_t b)
+{
+    int d = 0;
+    for (int s = 0; s < 24; s += 8)
+    {
+        const int c = (int)((a >> s) & 0xFF) - (int)((b >> s) & 0xFF);
+        d += c * c;
+    }
+    return d;
+}
+
+// Builds the 8-byte colour block for endpoints c0/c1 in the given mode
+// (4 colours, or 3 + transparent) with the best index per texel, and returns
+// its squared error over the opaque texels.
+static int PackColor(uint32_t c0, uint32_t c1, bool fourColor, const uint32_t src[16],
+                     const bool opaque[16], uint8_t out[8])
+{
+    // Put the endpoints in the order that selects the mode
+    if (fourColor ? (c0 < c1) : (c0 > c1))
+    {
+        const uint32_t t = c0; c0 = c1; c1 = t;
+    }
+    if (fourColor && c0 == c1)
+        fourColor = false;                          // equal endpoints decode as 3-colour
+
+    out[0] = (uint8_t)c0; out[1] = (uint8_t)(c0 >> 8);
+    out[2] = (uint8_t)c1; out[3] = (uint8_t)(c1 >> 8);
+    memset(out + 4, 0, 4);
+
+    // The palette as the game's decoder sees it, one index at a time
+    uint32_t colors[4];
+    for (int i = 0; i < 4; ++i)
+    {
+        uint32_t texels[16];
+        out[4] = (uint8_t)i;                        // texel 0 uses index i
+        TexFmt_DecodeBlock(TEXFMT_DXT1, out, texels);
+        colors[i] = texels[0];
+    }
+
+    uint32_t bits = 0;
+    int err = 0;
+    for (int t = 0; t < 16; ++t)
+    {
+        int best = 3, bestD = 0x7FFFFFFF;
+        if (opaque[t])
+        {
+            const int n = fourColor ? 4 : 3;
+            for (int i = 0; i < n; ++i)
+            {
+                const int d = Dist2(colors[i], src[t]);
+                if (d < bestD) { bestD = d; best = i; }
+            }
+            err += bestD;
+        }
+        bits |= (uint32_t)best << (2 * t);
+    }
+
+    out[4] = (uint8_t)bits; out[5] = (uint8_t)(bits >> 8);
+    out[6] = (uint8_t)(bits >> 16); out[7] = (uint8_t)(bits >> 24);
+    return err;
+}
+
+// Endpoints along the principal axis of the opaque texels, then a couple of
+// least-squares refinements against the chosen indices.
+static void EncodeColorBlock(const uint32_t src[16], bool allowTransparent, uint8_t out[8])
+{
+    bool opaque[16];
+    int n = 0;
+    Vec3 mean = { 0, 0, 0 };
+    for (int t = 0; t < 16; ++t)
+    {
+        opaque[t] = !allowTransparent || (src[t] >> 24) >= 128;
+        if (!opaque[t]) continue;
+        const Vec3 v = ToVec(src[t]);
+        mean.r += v.r; mean.g += v.g; mean.b += v.b;
+        ++n;
+    }
+
+    const bool needAlpha = n < 16;
+    if (n == 0)
+    {
+        PackColor(0, 0, false, src, opaque, out);
+        return;
+    }
+    mean.r /= n; mean.g /= n; mean.b /= n;
+
+    float cov[6] = { 0, 0, 0, 0, 0, 0 };
+    for (int t = 0; t < 16; ++t)
+    {
+        if (!opaque[t]) continue;
+        const Vec3 v = ToVec(src[t]);
+        const float r = v.r - mean.r, g = v.g - mean.g, b = v.b - mean.b;
+        cov[0] += r * r; cov[1] += r * g; cov[2] += r * b;
+        cov[3] += g * g; cov[4] += g * b; cov[5] += b * b;
+    }
+
+    Vec3 axis = { 1, 1, 1 };
+    for (int it = 0; it < 8; ++it)
+    {
+        Vec3 a;
+        a.r = cov[0] * axis.r + cov[1] * axis.g + cov[2] * axis.b;
+        a.g = cov[1] * axis.r + cov[3] * axis.g + cov[4] * axis.b;
+        a.b = cov[2] * axis.r + cov[4] * axis.g + cov[5] * axis.b;
+        const float len = sqrtf(a.r * a.r + a.g * a.g + a.b * a.b);
+        if (len < 1e-6f) break;
+        axis.r = a.r / len; axis.g = a.g / len; axis.b = a.b / len;
+    }
+
+    float lo = 1e9f, hi = -1e9f;
+    for (int t = 0; t < 16; ++t)
+    {
+        if (!opaque[t]) continue;
+        const Vec3 v = ToVec(src[t]);
+        const float p = (v.r - mean.r) * axis.r + (v.g - mean.g) * axis.g + (v.b - mean.b) * axis.b;
+        if (p < lo) lo = p;
+        if (p > hi) hi = p;
+    }
+
+    Vec3 e0 = { mean.r + axis.r * hi, mean.g + axis.g * hi, mean.b + axis.b * hi };
+    Vec3 e1 = { mean.r + axis.r * lo, mean.g + axis.g * lo, mean.b + axis.b * lo };
+
+    uint8_t best[8] = { 0 };
+    int bestErr = 0x7FFFFFFF;
+
+    for (int mode = 0; mode < 2; ++mode)
+    {
+        const bool fourColor = (mode == 0);
+        if (fourColor && needAlpha) continue;
+
+        Vec3 a = e0, b = e1;
+        for (int pass = 0; pass < 3; ++pass)
+        {
+            uint8_t blk[8];
+            const int err = PackColor(To565(a), To565(b), fourColor, src, opaque, blk);
+            if (err < bestErr)
+            {
+                bestErr = err;
+                memcpy(best, blk, 8);
+            }
+            if (err == 0) break;
+
+            // Least squares for the endpoints given the indices just chosen
+            const uint32_t c0 = blk[0] | (uint32_t)blk[1] << 8;
+            const uint32_t c1 = blk[2] | (uint32_t)blk[3] << 8;
+            const bool four = c0 > c1;
+            const uint32_t bits = blk[4] | (uint32_t)blk[5] << 8 | (uint32_t)blk[6] << 16 | (uint32_t)blk[7] << 24;
+
+            float aa = 0, ab = 0, bb = 0;
+            Vec3 ax = { 0, 0, 0 }, bx = { 0, 0, 0 };
+            for (int t = 0; t < 16; ++t)
+            {
+                const int idx = (bits >> (2 * t)) & 3;
+                if (!opaque[t] || (!four && idx == 3)) continue;
+
+                static const float kW4[4] = { 1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f };
+                static const float kW3[3] = { 1.0f, 0.0f, 0.5f };
+                const float wa = four ? kW4[idx] : kW3[idx];
+                const float wb = 1.0f - wa;
+                const Vec3 v = ToVec(src[t]);
+
+                aa += wa * wa; ab += wa * wb; bb += wb * wb;
+                ax.r += wa * v.r; ax.g += wa * v.g; ax.b += wa * v.b;
+                bx.r += wb * v.r; bx.g += wb * v.g; bx.b += wb * v.b;
+            }
+
+            const float det = aa * bb - ab * ab;
+            if (fabsf(det) < 1e-6f) break;
+
+            a.r = (bb * ax.r - ab * bx.r) / det; b.r = (aa * bx.r - ab * ax.r) / det;
+            a.g = (bb * ax.g - ab * bx.g) / det; b.g = (aa * bx.g - ab * ax.g) / det;
+            a.b = (bb * ax.b - ab * bx.b) / det; b.b = (aa * bx.b - ab * ax.b) / det;
+        }
+    }
+
+    memcpy(out, best, 8);
+}
+
+static void EncodeAlphaBlock(const uint32_t src[16], uint8_t out[8])
+{
+    int lo = 255, hi = 0, lo6 = 255, hi6 = 0;
+    for (int t = 0; t < 16; ++t)
+    {
+        const int a = (int)(src[t] >> 24);
+        if (a < lo) lo = a;
+        if (a > hi) hi = a;
+        if (a != 0 && a != 255)
+        {
+            if (a < lo6) lo6 = a;
+            if (a > hi6) hi6 = a;
+        }
+    }
+    if (lo6 > hi6) lo6 = hi6 = 0;
+
+    // 8-value mode wants a0 > a1, 6-value mode (plus 0 and 255) a0 <= a1
+    const int cand[2][2] = { { hi, lo }, { lo6, hi6 } };
+
+    int bestErr = 0x7FFFFFFF;
+    for (int c = 0; c < 2; ++c)
+    {
+        uint8_t blk[8];
+        blk[0] = (uint8_t)cand[c][0];
+        blk[1] = (uint8_t)cand[c][1];
+        memset(blk + 2, 0, 6);
+
+        // Decode the alpha palette through the real decoder, one index at a time
+        int pal[8];
+        for (int i = 0; i < 8; ++i)
+        {
+            uint8_t probe[16];
+            memset(probe, 0, sizeof(probe));
+            probe[0] = blk[0];
+            probe[1] = blk[1];
+            probe[2] = (uint8_t)i;                  // texel 0 uses index i
+            uint32_t texels[16];
+            TexFmt_DecodeBlock(TEXFMT_DXT5, probe, texels);
+            pal[i] = (int)(texels[0] >> 24);
+        }
+
+        uint64_t bits = 0;
+        int err = 0;
+        for (int t = 0; t < 16; ++t)
+        {
+            const int a = (int)(src[t] >> 24);
+            int best = 0, bestD = 0x7FFFFFFF;
+            for (int i = 0; i < 8; ++i)
+            {
+                const int d = (pal[i] - a) * (pal[i] - a);
+                if (d < bestD) { bestD = d; best = i; }
+            }
+            err += bestD;
+            bits |= (uint64_t)best << (3 * t);
+        }
+
+        if (err < bestErr)
+        {
+            bestErr = err;
+            memcpy(out, blk, 2);
+            for (int i = 0; i < 6; ++i)
+                out[2 + i] = (uint8_t)(bits >> (8 * i));
+        }
+    }
+}
+
+static void EncodeDxt(TexFmt fmt, const Image& img, std::vector<uint8_t>& data)
+{
+    const int blockBytes = (fmt == TEXFMT_DXT1) ? 8 : 16;
+    const int bw = (img.w + 3) / 4, bh = (img.h + 3) / 4;
+    data.assign((size_t)bw * bh * blockBytes, 0);
+
+    for (int by = 0; by < bh; ++by)
+    {
+        for (int bx = 0; bx < bw; ++bx)
+        {
+            // Edge blocks repeat the last row / column
+            uint32_t src[16];
+            for (int y = 0; y < 4; ++y)
+                for (int x = 0; x < 4; ++x)
+                {
+                    const int sx = Clamp(bx * 4 + x, 0, img.w - 1);
+                    const int sy = Clamp(by * 4 + y, 0, img.h - 1);
+                    src[y * 4 + x] = img.texels[(size_t)sy * img.w + sx];
+                }
+
+            uint8_t* out = &data[((size_t)by * bw + bx) * blockBytes];
+            if (fmt != TEXFMT_DXT1)
+            {
+                EncodeAlphaBlock(src, out);
+                EncodeColorBlock(src, false, out + 8);
+            }
+            else
+            {
+                EncodeColorBlock(src, true, out);
+            }
+        }
+    }
+}
+
+// ------------------------------
+// P8 (median cut)
+// ------------------------------
+struct ColorBox
+{
+    int first, count;               // range in the colour list
+};
+
+static int Channel(uint32_t c, int ch)
+{
+    return (int)((c >> (8 * ch)) & 0xFF);
+}
+
+static void EncodeP8(const Image& img, std::vector<uint8_t>& data)
+{
+    std::vector<uint32_t> colors(img.texels);
+    std::sort(colors.begin(), colors.end());
+    colors.erase(std::unique(colors.begin(), colors.end()), colors.end());
+
+    std::vector<ColorBox> boxes;
+    boxes.push_back(ColorBox{ 0, (int)colors.size() });
+
+    // Split the box with the widest channel range until there are 256
+    while (boxes.size() < 256)
+    {
+        int pick = -1, pickCh = 0, pickRange = 0;
+        for (size_t b = 0; b < boxes.size(); ++b)
+        {
+            if (boxes[b].count < 2) continue;
+            for (int ch = 0; ch < 4; ++ch)
+            {
+                int lo = 255, hi = 0;
+                for (int i = 0; i < boxes[b].count; ++i)
+                {
+                    const int v = Channel(colors[boxes[b].first + i], ch);
+                    if (v < lo) lo = v;
+                    if (v > hi) hi = v;
+                }
+                if (hi - lo > pickRange)
+                {
+                    pickRange = hi - lo;
+                    pick = (int)b;
+                    pickCh = ch;
+                }
+            }
+        }
+        if (pick < 0) break;
+
+        ColorBox& box = boxes[pick];
+        uint32_t* first = &colors[box.first];
+        std::sort(first, first + box.count, [pickCh](uint32_t a, uint32_t b)
+        {
+            return Channel(a, pickCh) < Channel(b, pickCh);
+        });
+
+        const int half = box.count / 2;
+        const ColorBox rest = { box.first + half, box.count - half };
+        box.count = half;
+        boxes.push_back(rest);
+    }
+
+    uint32_t pal[256];
+    memset(pal, 0, sizeof(pal));
+    for (size_t b = 0; b < boxes.size(); ++b)
+    {
+        uint32_t sum[4] = { 0, 0, 0, 0 };
+        for (int i = 0; i < boxes[b].count; ++i)
+            for (int ch = 0; ch < 4; ++ch)
+                sum[ch] += (uint32_t)Channel(colors[boxes[b].first + i], ch);
+
+        for (int ch = 0; ch < 4; ++ch)
+            pal[b] |= ((sum[ch] + boxes[b].count / 2) / boxes[b].count) << (8 * ch);
+    }
+
+    data.assign(256 * 4 + (size_t)img.w * img.h, 0);
+    for (int i = 0; i < 256; ++i)
+    {
+        data[i * 4 + 0] = (uint8_t)(pal[i] >> 16);     // R, G, B, A
+        data[i * 4 + 1] = (uint8_t)(pal[i] >> 8);
+        data[i * 4 + 2] = (uint8_t)pal[i];
+        data[i * 4 + 3] = (uint8_t)(pal[i] >> 24);
+    }
+
+    uint8_t* idx = &data[256 * 4];
+    uint32_t lastColor = 0;
+    int lastIndex = -1;
+    for (size_t t = 0; t < img.texels.size(); ++t)
+    {
+        const uint32_t c = img.texels[t];
+        if (lastIndex < 0 || c != lastColor)
+        {
+            int best = 0, bestD = 0x7FFFFFFF;
+            for (size_t i = 0; i < boxes.size(); ++i)
+            {
+                const int da = Channel(c, 3) - Channel(pal[i], 3);
+                const int d = Dist2(c, pal[i]) + da * da;
+                if (d < bestD) { bestD = d; best = (int)i; }
+            }
+            lastColor = c;
+            lastIndex = best;
+        }
+        idx[t] = (uint8_t)lastIndex;
+    }
+}
+
+// ------------------------------
+// Report
+// ------------------------------
+static double Psnr(double sumSq, uint64_t n)
+{
+    if (n == 0) return 0.0;
+    if (sumSq <= 0.0) return INFINITY;
+    return 10.0 * log10(255.0 * 255.0 / (sumSq / (double)n));
+}
+
+static void Compare(const Image& ref, const Image& got)
+{
+    double rgb = 0.0, alpha = 0.0;
+    uint64_t rgbN = 0;
+
+    for (size_t t = 0; t < ref.texels.size(); ++t)
+    {
+        const uint32_t a = ref.texels[t], b = got.texels[t];
+        const int da = (int)(a >> 24) - (int)(b >> 24);
+        alpha += da * da;
+
+        if ((a >> 24) != 0 && (b >> 24) != 0)
+        {
+            rgb += Dist2(a, b);
+            rgbN += 3;
+        }
+    }
+
+    printf("  psnr      rgb %.2f dB (visible texels), alpha %.2f dB\n",
+           Psnr(rgb, rgbN), Psnr(alpha, ref.texels.size()));
+}
+
+static void Info(const char* path, TexFmt fmt, int w, int h)
+{
+    printf("%s: %s %dx%d, file %u bytes, texture %u bytes\n", path, TexFmt_Name(fmt), w, h,
+           (unsigned)(4 + sizeof(DdsHeader) + TexFmt_DataBytes(fmt, w, h)),
+           (unsigned)TextureBytes(fmt, w, h));
+}
+
+int main(int argc, char** argv)
+{
+    const char* inPath = NULL;
+    const char* outPath = NULL;
+    const char* fmtName = NULL;
+    int key = -1;
+    bool info = false;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--fmt") == 0 && i + 1 < argc) fmtName = argv[++i];
+        else if (strcmp(argv[i], "--key") == 0 && i + 1 < argc) key = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--info") == 0) info = true;
+        else if (!inPath) inPath = argv[i];
+        else if (!outPath) outPath = argv[i];
+    }
+
+    TexFmt outFmt = TEXFMT_UNKNOWN;
+    if (fmtName)
+    {
+        if (strcmp(fmtName, "argb") == 0) outFmt = TEXFMT_A8R8G8B8;
+        else if (strcmp(fmtName, "dxt1") == 0) outFmt = TEXFMT_DXT1;
+        else if (strcmp(fmtName, "dxt4") == 0) outFmt = TEXFMT_DXT4;
+        else if (strcmp(fmtName, "dxt5") == 0) outFmt = TEXFMT_DXT5;
+        else if (strcmp(fmtName, "p8") == 0) outFmt = TEXFMT_P8;
+    }
+
+    if (!inPath || (!info && (!outPath || outFmt == TEXFMT_UNKNOWN)))
+    {
+        fprintf(stderr, "usage: texcook in.dds out.dds --fmt argb|dxt1|dxt4|dxt5|p8 [--key TOL]\n"
+                        "       texcook in.dds --info\n");
+        return 2;
+    }
+
+    TexFmt inFmt;
+    Image src;
+    bool premult = false;
+    std::vector<uint8_t> inData;
+    if (!ReadDds(inPath, inFmt, src.w, src.h, premult, inData)) return 1;
+
+    Info(inPath, inFmt, src.w, src.h);
+    if (info) return 0;
+
+    Decode(inFmt, inData, src);
+
+    // The same colour key the title loader would run (title.cpp)
+    if (key >= 0 && premult)
+    {
+        printf("  already premultiplied, --key ignored\n");
+    }
+    else if (key >= 0)
+    {
+        ColorKey_Apply(src.texels.data(), (uint32_t)src.texels.size(), src.texels[0], key);
+        premult = true;
+    }
+
+    if (outFmt == TEXFMT_DXT4 && !premult)
+    {
+        Premultiply(src);
+        premult = true;
+    }
+
+    std::vector<uint8_t> outData;
+    const double t0 = NowMs();
+    switch (outFmt)
+    {
+    case TEXFMT_A8R8G8B8:
+        outData.resize(src.texels.size() * 4);
+        memcpy(outData.data(), src.texels.data(), outData.size());
+        break;
+    case TEXFMT_P8:
+        EncodeP8(src, outData);
+        break;
+    default:
+        EncodeDxt(outFmt, src, outData);
+        break;
+    }
+    const double encodeMs = NowMs() - t0;
+
+    // Decode with the game's decoder; best of a few runs
+    Image out;
+    out.w = src.w;
+    out.h = src.h;
+    double decodeMs = 1e9;
+    for (int run = 0; run < 5; ++run)
+    {
+        const double d0 = NowMs();
+        Decode(outFmt, outData, out);
+        const double d = NowMs() - d0;
+        if (d < decodeMs) decodeMs = d;
+    }
+
+    if (!WriteDds(outPath, outFmt, src.w, src.h, premult, outData)) return 1;
+
+    Info(outPath, outFmt, src.w, src.h);
+
+    const double inFile = 4.0 + sizeof(DdsHeader) + TexFmt_DataBytes(inFmt, src.w, src.h);
+    const double outFile = 4.0 + sizeof(DdsHeader) + TexFmt_DataBytes(outFmt, src.w, src.h);
+    printf("  file      %.2fx smaller\n", inFile / outFile);
+    printf("  texture   %.2fx smaller\n",
+           (double)TextureBytes(inFmt, src.w, src.h) / TextureBytes(outFmt, src.w, src.h));
+    printf("  encode    %.2f ms\n", encodeMs);
+    printf("  decode    %.3f ms (software, %.1f Mtexels/s)\n",
+           decodeMs, (double)src.w * src.h / (decodeMs * 1000.0));
+    Compare(src, out);
+    return 0;
+}
@@ -0,0 +1,454 @@
+// texloadcheck.cpp
+//
+// Runs the game's DDS loader (texload.cpp) on a PC against an in-memory file
+// system and a stub device, and checks every streamed load against decoding,
+// keying and swizzling the whole image at once.
+// Not part of the Xbox project; build it by hand with any C++17 compiler:
+//
+//   g++ -std=c++17 -O2 -Itools/hoststub -o texloadcheck tools/texloadcheck.cpp texload.cpp texfmt.cpp swizzle.cpp colorkey.cpp strfmt.cpp
+//   cl /std:c++17 /O2 /EHsc /Itools\hoststub tools\texloadcheck.cpp texload.cpp texfmt.cpp swizzle.cpp colorkey.cpp strfmt.cpp
+//
+// (from invaderz/; tools/hoststub stands in for the XDK headers)
+//
+// Usage: texloadcheck
+//
+// Cases:
+//   argb       raw A8R8G8B8 in one or many 32KB strips, including widths that
+//              leave a single pair of rows per strip
+//   argb+key   the title's colour key applied strip by strip (key taken from
+//              the first strip), and skipped for files marked premultiplied
+//   p8         palette expansion with strips that don't divide the height
+//   dxt        DXT1/DXT4/DXT5 kept compressed, at a tight and a padded pitch
+//   refused    the same with the device refusing the DXT format, so blocks
+//              are decoded a row at a time into A8R8G8B8; too wide for the
+//              scratch buffer must fail without leaking the texture
+//   broken     truncated data, bad magic and non power of two sizes
+// Each case also checks the texture's guard bytes, that nothing is left
+// locked or alive, and (streamed formats) that no single read is larger than
+// the scratch buffer. Prints the best of 5 load times.
+
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "../texload.h"
+#include "../texfmt.h"
+#include "../swizzle.h"
+#include "../colorkey.h"
+
+#pragma pack(push, 1)
+struct DdsPixelFormat
+{
+    uint32_t size, flags, fourCC, rgbBitCount, rMask, gMask, bMask, aMask;
+};
+
+struct DdsHeader
+{
+    uint32_t size, flags, height, width, pitchOrLinearSize, depth, mipMapCount;
+    uint32_t reserved1[11];
+    DdsPixelFormat ddspf;
+    uint32_t caps, caps2, caps3, caps4, reserved2;
+};
+#pragma pack(pop)
+
+static const int SCRATCH_BYTES = 32768;     // texload.cpp's strip buffer
+static const int GUARD_BYTES = 64;
+static const uint8_t FILL = 0xCD;
+
+// ------------------------------
+// Files (xtl.h stand-ins)
+// ------------------------------
+struct MemFile
+{
+    const std::vector<uint8_t>* data;
+    size_t pos;
+};
+
+static std::map<std::string, std::vector<uint8_t>> s_files;
+static int    s_openFiles = 0;
+static DWORD  s_largestRead = 0;
+
+HANDLE CreateFileA(const char* path, DWORD, DWORD, void*, DWORD, DWORD, HANDLE)
+{
+    auto it = s_files.find(path);
+    if (it == s_files.end()) return INVALID_HANDLE_VALUE;
+
+    ++s_openFiles;
+    return new MemFile{ &it->second, 0 };
+}
+
+BOOL ReadFile(HANDLE h, void* dst, DWORD bytes, DWORD* got, void*)
+{
+    MemFile* f = (MemFile*)h;
+    const size_t left = f->data->size() - f->pos;
+    const size_t n = std::min((size_t)bytes, left);
+
+    memcpy(dst, f->data->data() + f->pos, n);
+    f->pos += n;
+    if (got) *got = (DWORD)n;
+
+    s_largestRead = std::max(s_largestRead, bytes);
+    return TRUE;
+}
+
+BOOL CloseHandle(HANDLE h)
+{
+    --s_openFiles;
+    delete (MemFile*)h;
+    return TRUE;
+}
+
+BOOL QueryPerformanceCounter(LARGE_INTEGER* v)
+{
+    using namespace std::chrono;
+    v->QuadPart = duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+    return TRUE;
+}
+
+BOOL QueryPerformanceFrequency(LARGE_INTEGER* v)
+{
+    v->QuadPart = 1000000;
+    return TRUE;
+}
+
+void GlobalMemoryStatus(MEMORYSTATUS* ms)
+{
+    memset(ms, 0, sizeof(*ms));
+    ms->dwAvailPhys = 64u << 20;
+}
+
+void OutputDebugStringA(const char* s)
+{
+    fputs(s, stdout);
+}
+
+// ------------------------------
+// Device (xtl.h stand-ins)
+// ------------------------------
+struct StubTexture : IDirect3DTexture8
+{
+    D3DFORMAT fmt;
+    int pitch, rows;
+    bool locked;
+    std::vector<uint8_t> mem;           // pitch * rows, then the guard
+};
+
+static bool s_refuseDxt = false;
+static int  s_padPitch = 0;             // extra bytes per row of blocks
+static int  s_liveTextures = 0;
+
+IDirect3DDevice8 s_device;
+LPDIRECT3DDEVICE8 g_pDevice = &s_device;
+
+static TexFmt ToTexFmt(D3DFORMAT fmt)
+{
+    return (fmt == D3DFMT_DXT1) ? TEXFMT_DXT1 :
+           (fmt == D3DFMT_DXT4) ? TEXFMT_DXT4 :
+           (fmt == D3DFMT_DXT5) ? TEXFMT_DXT5 : TEXFMT_A8R8G8B8;
+}
+
+HRESULT IDirect3DDevice8::CreateTexture(UINT w, UINT h, UINT, DWORD, D3DFORMAT fmt, DWORD,
+                                        IDirect3DTexture8** out)
+{
+    *out = NULL;
+
+    const bool block = (fmt != D3DFMT_A8R8G8B8);
+    if (block && s_refuseDxt) return E_FAIL;
+
+    StubTexture* t = new StubTexture;
+    t->fmt = fmt;
+    t->pitch = (int)TexFmt_RowBytes(ToTexFmt(fmt), (int)w) + (block ? s_padPitch : 0);
+    t->rows = block ? ((int)h + 3) / 4 : (int)h;
+    t->locked = false;
+    t->mem.assign((size_t)t->pitch * t->rows + GUARD_BYTES, FILL);
+
+    ++s_liveTextures;
+    *out = t;
+    return S_OK;
+}
+
+HRESULT IDirect3DTexture8::LockRect(UINT, D3DLOCKED_RECT* lr, const RECT*, DWORD)
+{
+    StubTexture* t = static_cast<StubTexture*>(this);
+    if (t->locked) return E_FAIL;
+
+    t->locked = true;
+    lr->Pitch = t->pitch;
+    lr->pBits = t->mem.data();
+    return S_OK;
+}
+
+HRESULT IDirect3DTexture8::UnlockRect(UINT)
+{
+    StubTexture* t = static_cast<StubTexture*>(this);
+    if (!t->locked) return E_FAIL;
+
+    t->locked = false;
+    return S_OK;
+}
+
+DWORD IDirect3DTexture8::Release()
+{
+    --s_liveTextures;
+    delete static_cast<StubTexture*>(this);
+    return 0;
+}
+
+// ------------------------------
+// Test images
+// ------------------------------
+static uint32_t s_rng = 0x13579BDFu;
+
+static uint32_t Rand()
+{
+    s_rng = s_rng * 1664525u + 1013904223u;
+    return s_rng;
+}
+
+static std::vector<uint8_t> MakeDds(TexFmt fmt, int w, int h, bool premult, const std::vector<uint8_t>& data)
+{
+    DdsHeader hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    hdr.size = 124;
+    hdr.flags = 0x1 | 0x2 | 0x4 | 0x1000;
+    hdr.height = (uint32_t)h;
+    hdr.width = (uint32_t)w;
+    hdr.caps = 0x1000;
+    hdr.ddspf.size = 32;
+
+    if (fmt == TEXFMT_A8R8G8B8)
+    {
+        hdr.ddspf.flags = DDPF_RGB | DDPF_ALPHAPIXELS;
+        hdr.ddspf.rgbBitCount = 32;
+        hdr.ddspf.rMask = 0x00FF0000;
+        hdr.ddspf.gMask = 0x0000FF00;
+        hdr.ddspf.bMask = 0x000000FF;
+        hdr.ddspf.aMask = 0xFF000000;
+    }
+    else if (fmt == TEXFMT_P8)
+    {
+        hdr.ddspf.flags = DDPF_PALETTEINDEXED8;
+        hdr.ddspf.rgbBitCount = 8;
+    }
+    else
+    {
+        hdr.ddspf.flags = DDPF_FOURCC;
+        hdr.ddspf.fourCC = (fmt == TEXFMT_DXT1) ? FOURCC_DXT1 :
+                           (fmt == TEXFMT_DXT4) ? FOURCC_DXT4 : FOURCC_DXT5;
+    }
+
+    if (premult)
+        hdr.ddspf.flags |= DDPF_ALPHAPREMULT;
+
+    std::vector<uint8_t> file(4 + sizeof(hdr) + data.size());
+    const uint32_t magic = DDS_MAGIC;
+    memcpy(file.data(), &magic, 4);
+    memcpy(file.data() + 4, &hdr, sizeof(hdr));
+    if (!data.empty()) memcpy(file.data() + 4 + sizeof(hdr), data.data(), data.size());
+    return file;
+}
+
+// Level 0 data. A8R8G8B8 gets a keyable background: a third of the texels
+// sit within a few steps of the top-left one.
+static std::vector<uint8_t> MakeData(TexFmt fmt, int w, int h)
+{
+    std::vector<uint8_t> data(TexFmt_DataBytes(fmt, w, h));
+
+    if (fmt != TEXFMT_A8R8G8B8)
+    {
+        for (size_t i = 0; i < data.size(); ++i)
+            data[i] = (uint8_t)(Rand() >> 24);
+        return data;
+    }
+
+    const uint32_t key = 0xFF10E020u;
+    uint32_t* t = (uint32_t*)data.data();
+    for (int i = 0; i < w * h; ++i)
+    {
+        if (i == 0 || (Rand() % 3) == 0)
+        {
+            uint32_t c = key;
+            for (int s = 0; s < 24 && i != 0; s += 8)
+                c = (c & ~(0xFFu << s)) | ((((key >> s) & 0xFF) + (Rand() % 24) - 12) & 0xFF) << s;
+            t[i] = c;
+        }
+        else
+        {
+            t[i] = Rand();
+        }
+    }
+    return data;
+}
+
+// What the texture must hold: the whole image decoded / keyed / swizzled in
+// one go, or the blocks laid out at the pitch
+static std::vector<uint8_t> Expected(TexFmt fmt, int w, int h, bool native, int pitch, int keyTol,
+                                     const std::vector<uint8_t>& data)
+{
+    if (native)
+    {
+        const int rowBytes = (int)TexFmt_RowBytes(fmt, w);
+        const int blockRows = (h + 3) / 4;
+
+        std::vector<uint8_t> out((size_t)pitch * blockRows, FILL);
+        for (int y = 0; y < blockRows; ++y)
+            memcpy(out.data() + (size_t)y * pitch, data.data() + (size_t)y * rowBytes, (size_t)rowBytes);
+        return out;
+    }
+
+    std::vector<uint32_t> img((size_t)w * h);
+    if (fmt == TEXFMT_A8R8G8B8)
+    {
+        memcpy(img.data(), data.data(), img.size() * 4);
+        if (keyTol >= 0)
+            ColorKey_Apply(img.data(), (uint32_t)img.size(), img[0], keyTol);
+    }
+    else if (fmt == TEXFMT_P8)
+    {
+        TexFmt_ExpandP8(data.data(), w, h, img.data());
+    }
+    else
+    {
+        TexFmt_DecodeDXT(fmt, data.data(), (int)TexFmt_RowBytes(fmt, w), w, h, img.data(), w * 4);
+    }
+
+    std::vector<uint8_t> out((size_t)w * h * 4);
+    Swizzle_Rect32(img.data(), w * 4, out.data(), w, h);
+    return out;
+}
+
+// ------------------------------
+// Cases
+// ------------------------------
+enum Breakage
+{
+    BREAK_NONE = 0,
+    BREAK_TRUNCATE,         // file ends a few bytes early
+    BREAK_MAGIC,
+};
+
+struct Case
+{
+    const char* name;
+    TexFmt   fmt;
+    int      w, h;
+    int      keyTol;        // TEXLOAD_NO_KEY or a tolerance
+    bool     premult;       // file marked DDPF_ALPHAPREMULT
+    bool     refuseDxt;     // device won't create DXT textures
+    int      padPitch;
+    Breakage breakage;
+    bool     expectLoad;
+};
+
+static const Case kCases[] =
+{
+    { "argb 256x256",              TEXFMT_A8R8G8B8, 256, 256, TEXLOAD_NO_KEY, false, false, 0,  BREAK_NONE, true },
+    { "argb 1024x64",              TEXFMT_A8R8G8B8, 1024, 64, TEXLOAD_NO_KEY, false, false, 0,  BREAK_NONE, true },
+    { "argb 4096x8",               TEXFMT_A8R8G8B8, 4096, 8,  TEXLOAD_NO_KEY, false, false, 0,  BREAK_NONE, true },
+    { "argb 8x8",                  TEXFMT_A8R8G8B8, 8, 8,     TEXLOAD_NO_KEY, false, false, 0,  BREAK_NONE, true },
+    { "argb+key 512x512 tol 16",   TEXFMT_A8R8G8B8, 512, 512, 16,             false, false, 0,  BREAK_NONE, true },
+    { "argb+key 2048x16 tol 4",    TEXFMT_A8R8G8B8, 2048, 16, 4,              false, false, 0,  BREAK_NONE, true },
+    { "argb+key premultiplied",    TEXFMT_A8R8G8B8, 256, 128, 16,             true,  false, 0,  BREAK_NONE, true },
+    { "p8 256x256",                TEXFMT_P8,       256, 256, TEXLOAD_NO_KEY, false, false, 0,  BREAK_NONE, true },
+    { "p8 512x128",                TEXFMT_P8,       512, 128, TEXLOAD_NO_KEY, false, false, 0,  BREAK_NONE, true },
+    { "p8 64x32",                  TEXFMT_P8,       64, 32,   TEXLOAD_NO_KEY, false, false, 0,  BREAK_NONE, true },
+    { "dxt1 256x256",              TEXFMT_DXT1,     256, 256, TEXLOAD_NO_KEY, false, false, 0,  BREAK_NONE, true },
+    { "dxt4 128x128",              TEXFMT_DXT4,     128, 128, TEXLOAD_NO_KEY, false, false, 0,  BREAK_NONE, true },
+    { "dxt5 256x64 padded pitch",  TEXFMT_DXT5,     256, 64,  TEXLOAD_NO_KEY, false, false, 32, BREAK_NONE, true },
+    { "refused dxt1 256x256",      TEXFMT_DXT1,     256, 256, TEXLOAD_NO_KEY, false, true,  0,  BREAK_NONE, true },
+    { "refused dxt4 128x128",      TEXFMT_DXT4,     128, 128, TEXLOAD_NO_KEY, false, true,  0,  BREAK_NONE, true },
+    { "refused dxt5 512x64",       TEXFMT_DXT5,     512, 64,  TEXLOAD_NO_KEY, false, true,  0,  BREAK_NONE, true },
+    { "refused dxt5 4096x8 (wide)", TEXFMT_DXT5,    4096, 8,  TEXLOAD_NO_KEY, false, true,  0,  BREAK_NONE, false },
+    { "broken argb truncated",     TEXFMT_A8R8G8B8, 256, 256, 16,             false, false, 0,  BREAK_TRUNCATE, false },
+    { "broken p8 truncated",       TEXFMT_P8,       256, 256, TEXLOAD_NO_KEY, false, false, 0,  BREAK_TRUNCATE, false },
+    { "broken dxt1 truncated",     TEXFMT_DXT1,     256, 256, TEXLOAD_NO_KEY, false, false, 0,  BREAK_TRUNCATE, false },
+    { "broken bad magic",          TEXFMT_A8R8G8B8, 64, 64,   TEXLOAD_NO_KEY, false, false, 0,  BREAK_MAGIC, false },
+    { "broken 96x64",              TEXFMT_A8R8G8B8, 96, 64,   TEXLOAD_NO_KEY, false, false, 0,  BREAK_NONE, false },
+};
+
+static bool RunCase(const Case& c)
+{
+    const std::vector<uint8_t> data = MakeData(c.fmt, c.w, c.h);
+    std::vector<uint8_t> file = MakeDds(c.fmt, c.w, c.h, c.premult, data);
+
+    if (c.breakage == BREAK_TRUNCATE) file.resize(file.size() - 7);
+    if (c.breakage == BREAK_MAGIC) file[0] ^= 0xFF;
+
+    s_files["D:\\tex\\check.dds"] = file;
+    s_refuseDxt = c.refuseDxt;
+    s_padPitch = c.padPitch;
+
+    const bool native = TexFmt_IsBlock(c.fmt) && !c.refuseDxt;
+    const int keyTol = c.premult ? TEXLOAD_NO_KEY : c.keyTol;
+
+    bool ok = true;
+    double bestUs = 1e30;
+    DWORD largest = 0;
+
+    for (int rep = 0; rep < 5 && ok; ++rep)
+    {
+        s_largestRead = 0;
+
+        TexLoad_Info info;
+        const auto t0 = std::chrono::steady_clock::now();
+        LPDIRECT3DTEXTURE8 tex = TexLoad_FromDDS("D:\\tex\\check.dds", info, c.keyTol);
+        const auto t1 = std::chrono::steady_clock::now();
+
+        bestUs = std::min(bestUs, std::chrono::duration<double, std::micro>(t1 - t0).count());
+        largest = s_largestRead;
+
+        ok &= (tex != NULL) == c.expectLoad;
+        ok &= (s_openFiles == 0);
+
+        if (!tex)
+        {
+            ok &= (info.w == 0 && info.h == 0 && info.fmt == TEXFMT_UNKNOWN);
+            ok &= (s_liveTextures == 0);
+            continue;
+        }
+
+        StubTexture* t = static_cast<StubTexture*>(tex);
+        ok &= !t->locked;
+        ok &= (info.w == c.w && info.h == c.h && info.fmt == c.fmt);
+
+        const std::vector<uint8_t> want = Expected(c.fmt, c.w, c.h, native, t->pitch, keyTol, data);
+        ok &= (want.size() + GUARD_BYTES == t->mem.size());
+        ok &= ok && memcmp(t->mem.data(), want.data(), want.size()) == 0;
+        for (int i = 0; i < GUARD_BYTES && ok; ++i)
+            ok &= (t->mem[want.size() + i] == FILL);
+
+        // Streamed: the file never goes through anything bigger than the
+        // scratch buffer (block data is read straight into the texture)
+        if (!native)
+            ok &= (largest <= (DWORD)SCRATCH_BYTES);
+
+        tex->Release();
+        ok &= (s_liveTextures == 0);
+    }
+
+    printf("  %s  %-28s", ok ? "ok    " : "FAILED", c.name);
+    if (c.expectLoad)
+        printf(" %7.1f us  largest read %5u B", bestUs, (unsigned)largest);
+    else
+        printf(" refused");
+    printf("\n");
+
+    return ok;
+}
+
+int main()
+{
+    printf("texload (swizzle kernel %s, colour key kernel %s)\n",
+           Swizzle_KernelName(Swizzle_GetKernel()), ColorKey_KernelName(ColorKey_GetKernel()));
+
+    bool ok = true;
+    for (size_t i = 0; i < sizeof(kCases) / sizeof(kCases[0]); ++i)
+        ok &= RunCase(kCases[i]);
+
+    printf("\n%s\n", ok ? "OK" : "FAILED");
+    return ok ? 0 : 1;
+}